@@ -8,7 +8,10 @@
 # SMBCLIENT_FOUND - system has SmbClient
 # SMBCLIENT_INCLUDE_DIRS - the SmbClient include directory
 # SMBCLIENT_LIBRARIES - the SmbClient libraries
-# SMBCLIENT_DEFINITIONS - the SmbClient definitions
+# SMBCLIENT_DEFINITIONS - the SmbClient definitions (HAVE_SMBC_THREAD_POSIX is
+#                         defined if contexts can be used from multiple threads,
+#                         HAVE_SMBC_READDIRPLUS if directories can be listed
+#                         with attributes)
 #
 # and the following imported targets::
 #
@@ -35,6 +38,16 @@ if(SMBCLIENT_FOUND)
   set(SMBCLIENT_INCLUDE_DIRS ${SMBCLIENT_INCLUDE_DIR})
   set(SMBCLIENT_DEFINITIONS -DHAVE_LIBSMBCLIENT=1)
 
+  include(CheckLibraryExists)
+  check_library_exists(${SMBCLIENT_LIBRARY} smbc_thread_posix "" HAVE_SMBC_THREAD_POSIX)
+  if(HAVE_SMBC_THREAD_POSIX)
+    list(APPEND SMBCLIENT_DEFINITIONS -DHAVE_SMBC_THREAD_POSIX=1)
+  endif()
+  check_library_exists(${SMBCLIENT_LIBRARY} smbc_readdirplus "" HAVE_SMBC_READDIRPLUS)
+  if(HAVE_SMBC_READDIRPLUS)
+    list(APPEND SMBCLIENT_DEFINITIONS -DHAVE_SMBC_READDIRPLUS=1)
+  endif()
+
   if(NOT TARGET SmbClient::SmbClient)
     add_library(SmbClient::SmbClient UNKNOWN IMPORTED)
     set_target_properties(SmbClient::SmbClient PROPERTIES
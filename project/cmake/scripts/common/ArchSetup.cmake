@@ -122,6 +122,10 @@ check_function_exists(localtime_r HAVE_LOCALTIME_R)
 if(HAVE_LOCALTIME_R)
   list(APPEND SYSTEM_DEFINES -DHAVE_LOCALTIME_R=1)
 endif()
+check_function_exists(copy_file_range HAVE_COPY_FILE_RANGE)
+if(HAVE_COPY_FILE_RANGE)
+  list(APPEND SYSTEM_DEFINES -DHAVE_COPY_FILE_RANGE=1)
+endif()
 if(HAVE_INTTYPES_H)
   list(APPEND SYSTEM_DEFINES -DHAVE_INTTYPES_H=1)
 endif()
@@ -2913,6 +2913,10 @@ void CApplication::Stop(int exitCode)
     m_ExitCode = exitCode;
     CLog::Log(LOGNOTICE, "stop all");
 
+    // commit queued library writes before their jobs are cancelled
+    CVideoDatabase::FlushWrites();
+    CMusicDatabase::FlushWrites();
+
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
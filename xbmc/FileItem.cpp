@@ -243,10 +243,6 @@ CFileItem::CFileItem(const CGenre& genre)
 }
 
 CFileItem::CFileItem(const CFileItem& item)
-: m_musicInfoTag(NULL),
-  m_videoInfoTag(NULL),
-  m_pictureInfoTag(NULL),
-  m_gameInfoTag(NULL)
 {
   *this = item;
 }
@@ -340,15 +336,6 @@ CFileItem::CFileItem(const EventPtr& eventLogEntry)
 
 CFileItem::~CFileItem(void)
 {
-  delete m_musicInfoTag;
-  delete m_videoInfoTag;
-  delete m_pictureInfoTag;
-  delete m_gameInfoTag;
-
-  m_musicInfoTag = NULL;
-  m_videoInfoTag = NULL;
-  m_pictureInfoTag = NULL;
-  m_gameInfoTag = NULL;
 }
 
 const CFileItem& CFileItem::operator=(const CFileItem& item)
@@ -366,58 +353,10 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
   m_dateTime = item.m_dateTime;
   m_dwSize = item.m_dwSize;
 
-  if (item.m_musicInfoTag)
-  {
-    if (m_musicInfoTag)
-      *m_musicInfoTag = *item.m_musicInfoTag;
-    else
-      m_musicInfoTag = new MUSIC_INFO::CMusicInfoTag(*item.m_musicInfoTag);
-  }
-  else
-  {
-    delete m_musicInfoTag;
-    m_musicInfoTag = NULL;
-  }
-
-  if (item.m_videoInfoTag)
-  {
-    if (m_videoInfoTag)
-      *m_videoInfoTag = *item.m_videoInfoTag;
-    else
-      m_videoInfoTag = new CVideoInfoTag(*item.m_videoInfoTag);
-  }
-  else
-  {
-    delete m_videoInfoTag;
-    m_videoInfoTag = NULL;
-  }
-
-  if (item.m_pictureInfoTag)
-  {
-    if (m_pictureInfoTag)
-      *m_pictureInfoTag = *item.m_pictureInfoTag;
-    else
-      m_pictureInfoTag = new CPictureInfoTag(*item.m_pictureInfoTag);
-  }
-  else
-  {
-    delete m_pictureInfoTag;
-    m_pictureInfoTag = NULL;
-  }
-
-  if (item.m_gameInfoTag)
-  {
-    if (m_gameInfoTag)
-      *m_gameInfoTag = *item.m_gameInfoTag;
-    else
-      m_gameInfoTag = new CGameInfoTag(*item.m_gameInfoTag);
-  }
-  else
-  {
-    delete m_gameInfoTag;
-    m_gameInfoTag = NULL;
-  }
-
+  m_musicInfoTag = item.m_musicInfoTag;
+  m_videoInfoTag = item.m_videoInfoTag;
+  m_pictureInfoTag = item.m_pictureInfoTag;
+  m_gameInfoTag = item.m_gameInfoTag;
   m_epgInfoTag = item.m_epgInfoTag;
   m_pvrChannelInfoTag = item.m_pvrChannelInfoTag;
   m_pvrRecordingInfoTag = item.m_pvrRecordingInfoTag;
@@ -448,10 +387,6 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
 
 void CFileItem::Initialize()
 {
-  m_musicInfoTag = NULL;
-  m_videoInfoTag = NULL;
-  m_pictureInfoTag = NULL;
-  m_gameInfoTag = NULL;
   m_bLabelPreformated = false;
   m_bIsAlbum = false;
   m_dwSize = 0;
@@ -486,20 +421,16 @@ void CFileItem::Reset()
   m_strPath.clear();
   m_dateTime.Reset();
   m_strLockCode.clear();
-  m_mimetype.clear();
-  delete m_musicInfoTag;
-  m_musicInfoTag=NULL;
-  delete m_videoInfoTag;
-  m_videoInfoTag=NULL;
+  m_mimetype = "";
+  m_musicInfoTag.Reset();
+  m_videoInfoTag.Reset();
   m_epgInfoTag.reset();
   m_pvrChannelInfoTag.reset();
   m_pvrRecordingInfoTag.reset();
   m_pvrTimerInfoTag.reset();
   m_pvrRadioRDSInfoTag.reset();
-  delete m_pictureInfoTag;
-  m_pictureInfoTag=NULL;
-  delete m_gameInfoTag;
-  m_gameInfoTag = NULL;
+  m_pictureInfoTag.Reset();
+  m_gameInfoTag.Reset();
   m_extrainfo.clear();
   ClearProperties();
   m_eventLogEntry.reset();
@@ -538,17 +469,18 @@ void CFileItem::Archive(CArchive& ar)
     ar << m_specialSort;
     ar << m_doContentLookup;
 
+    // storing doesn't modify the tags, no need to copy shared ones
     if (m_musicInfoTag)
     {
       ar << 1;
-      ar << *m_musicInfoTag;
+      ar << const_cast<MUSIC_INFO::CMusicInfoTag&>(*m_musicInfoTag);
     }
     else
       ar << 0;
     if (m_videoInfoTag)
     {
       ar << 1;
-      ar << *m_videoInfoTag;
+      ar << const_cast<CVideoInfoTag&>(*m_videoInfoTag);
     }
     else
       ar << 0;
@@ -562,14 +494,14 @@ void CFileItem::Archive(CArchive& ar)
     if (m_pictureInfoTag)
     {
       ar << 1;
-      ar << *m_pictureInfoTag;
+      ar << const_cast<CPictureInfoTag&>(*m_pictureInfoTag);
     }
     else
       ar << 0;
     if (m_gameInfoTag)
     {
       ar << 1;
-      ar << *m_gameInfoTag;
+      ar << const_cast<CGameInfoTag&>(*m_gameInfoTag);
     }
     else
       ar << 0;
@@ -597,7 +529,9 @@ void CFileItem::Archive(CArchive& ar)
     ar >> m_iBadPwdCount;
 
     ar >> m_bCanQueue;
-    ar >> m_mimetype;
+    std::string mimetype;
+    ar >> mimetype;
+    m_mimetype = mimetype;
     ar >> m_extrainfo;
     ar >> temp;
     m_specialSort = (SortSpecial)temp;
@@ -634,7 +568,7 @@ void CFileItem::Serialize(CVariant& value) const
   value["size"] = m_dwSize;
   value["DVDLabel"] = m_strDVDLabel;
   value["title"] = m_strTitle;
-  value["mimetype"] = m_mimetype;
+  value["mimetype"] = m_mimetype.Get();
   value["extrainfo"] = m_extrainfo;
 
   if (m_musicInfoTag)
@@ -729,6 +663,25 @@ void CFileItem::ToSortable(SortItem &sortable, Field field) const
     m_eventLogEntry->ToSortable(sortable, field);
 }
 
+size_t CFileItem::GetMemoryUsage() const
+{
+  size_t size = CGUIListItem::GetMemoryUsage() - sizeof(CGUIListItem) + sizeof(*this);
+  size += m_strPath.capacity() + m_strDVDLabel.capacity() + m_strTitle.capacity() + m_strLockCode.capacity();
+  size += m_extrainfo.capacity();
+
+  // shared info tags are split between the items sharing them
+  if (m_musicInfoTag)
+    size += sizeof(*m_musicInfoTag) / m_musicInfoTag.UseCount();
+  if (m_videoInfoTag)
+    size += sizeof(*m_videoInfoTag) / m_videoInfoTag.UseCount();
+  if (m_pictureInfoTag)
+    size += sizeof(*m_pictureInfoTag) / m_pictureInfoTag.UseCount();
+  if (m_gameInfoTag)
+    size += sizeof(*m_gameInfoTag) / m_gameInfoTag.UseCount();
+
+  return size;
+}
+
 void CFileItem::ToSortable(SortItem &sortable, const Fields &fields) const
 {
   Fields::const_iterator it;
@@ -806,7 +759,7 @@ bool CFileItem::IsVideo() const
   std::string extension;
   if(StringUtils::StartsWithNoCase(m_mimetype, "application/"))
   { /* check for some standard types */
-    extension = m_mimetype.substr(12);
+    extension = m_mimetype.Get().substr(12);
     if( StringUtils::EqualsNoCase(extension, "ogg")
      || StringUtils::EqualsNoCase(extension, "mp4")
      || StringUtils::EqualsNoCase(extension, "mxf") )
@@ -888,7 +841,7 @@ bool CFileItem::IsAudio() const
 
   if(StringUtils::StartsWithNoCase(m_mimetype, "application/"))
   { /* check for some standard types */
-    std::string extension = m_mimetype.substr(12);
+    std::string extension = m_mimetype.Get().substr(12);
     if( StringUtils::EqualsNoCase(extension, "ogg")
      || StringUtils::EqualsNoCase(extension, "mp4")
      || StringUtils::EqualsNoCase(extension, "mxf") )
@@ -1102,7 +1055,7 @@ bool CFileItem::IsCBR() const
 bool CFileItem::IsRSS() const
 {
   return StringUtils::StartsWithNoCase(m_strPath, "rss://") || URIUtils::HasExtension(m_strPath, ".rss")
-      || m_mimetype == "application/rss+xml";
+      || m_mimetype.Get() == "application/rss+xml";
 }
 
 bool CFileItem::IsAndroidApp() const
@@ -1421,20 +1374,22 @@ void CFileItem::FillInMimeType(bool lookup /*= true*/)
       if (!lookup)
         return;
 
-      CCurlFile::GetMimeType(GetURL(), m_mimetype);
+      std::string mimetype;
+      CCurlFile::GetMimeType(GetURL(), mimetype);
 
       // try to get mime-type again but with an NSPlayer User-Agent
       // in order for server to provide correct mime-type.  Allows us
       // to properly detect an MMS stream
-      if (StringUtils::StartsWithNoCase(m_mimetype, "video/x-ms-"))
-        CCurlFile::GetMimeType(GetURL(), m_mimetype, "NSPlayer/11.00.6001.7000");
+      if (StringUtils::StartsWithNoCase(mimetype, "video/x-ms-"))
+        CCurlFile::GetMimeType(GetURL(), mimetype, "NSPlayer/11.00.6001.7000");
 
       // make sure there are no options set in mime-type
       // mime-type can look like "video/x-ms-asf ; charset=utf8"
-      size_t i = m_mimetype.find(';');
+      size_t i = mimetype.find(';');
       if(i != std::string::npos)
-        m_mimetype.erase(i, m_mimetype.length() - i);
-      StringUtils::Trim(m_mimetype);
+        mimetype.erase(i, mimetype.length() - i);
+      StringUtils::Trim(mimetype);
+      m_mimetype = mimetype;
     }
     else
       m_mimetype = CMime::GetMimeType(*this);
@@ -1986,7 +1941,7 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_sortDescription = itemlist.m_sortDescription;
   m_replaceListing = itemlist.m_replaceListing;
   m_content = itemlist.m_content;
-  m_mapProperties = itemlist.m_mapProperties;
+  m_properties = itemlist.m_properties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
@@ -1998,7 +1953,7 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
   // assign the rest of the CFileItemList properties
   m_replaceListing  = items.m_replaceListing;
   m_content         = items.m_content;
-  m_mapProperties   = items.m_mapProperties;
+  m_properties      = items.m_properties;
   m_cacheToDisc     = items.m_cacheToDisc;
   m_sortDetails     = items.m_sortDetails;
   m_sortDescription = items.m_sortDescription;
@@ -2006,7 +1961,9 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
 
   if (copyItems)
   {
-    // make a copy of each item
+    // make a copy of each item, copies share the info tags of the originals
+    CSingleLock lock(m_lock);
+    m_items.reserve(m_items.size() + items.Size());
     for (int i = 0; i < items.Size(); i++)
     {
       CFileItemPtr newItem(new CFileItem(*items[i]));
@@ -2154,6 +2111,8 @@ void CFileItemList::Sort(SortDescription sortDescription)
   for (int index = 0; index < Size(); index++)
   {
     sortItems[index] = std::shared_ptr<SortItem>(new SortItem);
+    // one slot per sorting field plus label, special sort, folder, id and sort label
+    sortItems[index]->reserve(fields.size() + 5);
     m_items[index]->ToSortable(*sortItems[index], fields);
     (*sortItems[index])[FieldId] = index;
   }
@@ -3283,9 +3242,7 @@ bool CFileItem::LoadGameTag()
     return true;
 
   //! @todo
-  GetGameInfoTag();
-
-  m_gameInfoTag->SetLoaded(true);
+  GetGameInfoTag()->SetLoaded(true);
 
   return false;
 }
@@ -3352,34 +3309,22 @@ void CFileItemList::ClearSortState()
 
 CVideoInfoTag* CFileItem::GetVideoInfoTag()
 {
-  if (!m_videoInfoTag)
-    m_videoInfoTag = new CVideoInfoTag;
-
-  return m_videoInfoTag;
+  return m_videoInfoTag.GetMutable();
 }
 
 CPictureInfoTag* CFileItem::GetPictureInfoTag()
 {
-  if (!m_pictureInfoTag)
-    m_pictureInfoTag = new CPictureInfoTag;
-
-  return m_pictureInfoTag;
+  return m_pictureInfoTag.GetMutable();
 }
 
 MUSIC_INFO::CMusicInfoTag* CFileItem::GetMusicInfoTag()
 {
-  if (!m_musicInfoTag)
-    m_musicInfoTag = new MUSIC_INFO::CMusicInfoTag;
-
-  return m_musicInfoTag;
+  return m_musicInfoTag.GetMutable();
 }
 
 CGameInfoTag* CFileItem::GetGameInfoTag()
 {
-  if (!m_gameInfoTag)
-    m_gameInfoTag = new CGameInfoTag;
-
-  return m_gameInfoTag;
+  return m_gameInfoTag.GetMutable();
 }
 
 std::string CFileItem::FindTrailer() const
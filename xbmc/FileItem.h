@@ -32,7 +32,9 @@
 #include "guilib/GUIListItem.h"
 #include "GUIPassword.h"
 #include "threads/CriticalSection.h"
+#include "utils/CopyOnWritePtr.h"
 #include "utils/IArchivable.h"
+#include "utils/InternPool.h"
 #include "utils/ISerializable.h"
 #include "utils/ISortable.h"
 #include "utils/SortUtils.h"
@@ -151,6 +153,11 @@ public:
   void ToSortable(SortItem &sortable, const Fields &fields) const;
   virtual bool IsFileItem() const { return true; };
 
+  /*! \brief Get the approximate amount of memory used by the item, in bytes.
+   Owned info tags are counted by their size, shared PVR, EPG and add-on data isn't counted.
+   */
+  virtual size_t GetMemoryUsage() const;
+
   bool Exists(bool bUseCache = true) const;
 
   /*!
@@ -255,26 +262,26 @@ public:
 
   inline bool HasMusicInfoTag() const
   {
-    return m_musicInfoTag != NULL;
+    return static_cast<bool>(m_musicInfoTag);
   }
 
   MUSIC_INFO::CMusicInfoTag* GetMusicInfoTag();
 
   inline const MUSIC_INFO::CMusicInfoTag* GetMusicInfoTag() const
   {
-    return m_musicInfoTag;
+    return m_musicInfoTag.Get();
   }
 
   inline bool HasVideoInfoTag() const
   {
-    return m_videoInfoTag != NULL;
+    return static_cast<bool>(m_videoInfoTag);
   }
 
   CVideoInfoTag* GetVideoInfoTag();
 
   inline const CVideoInfoTag* GetVideoInfoTag() const
   {
-    return m_videoInfoTag;
+    return m_videoInfoTag.Get();
   }
 
   inline bool HasEPGInfoTag() const
@@ -351,12 +358,12 @@ public:
 
   inline bool HasPictureInfoTag() const
   {
-    return m_pictureInfoTag != NULL;
+    return static_cast<bool>(m_pictureInfoTag);
   }
 
   inline const CPictureInfoTag* GetPictureInfoTag() const
   {
-    return m_pictureInfoTag;
+    return m_pictureInfoTag.Get();
   }
 
   bool HasAddonInfo() const { return m_addonInfo != nullptr; }
@@ -364,14 +371,14 @@ public:
 
   inline bool HasGameInfoTag() const
   {
-    return m_gameInfoTag != NULL;
+    return static_cast<bool>(m_gameInfoTag);
   }
 
   GAME::CGameInfoTag* GetGameInfoTag();
 
   inline const GAME::CGameInfoTag* GetGameInfoTag() const
   {
-    return m_gameInfoTag;
+    return m_gameInfoTag.Get();
   }
 
   CPictureInfoTag* GetPictureInfoTag();
@@ -549,27 +556,30 @@ private:
 
   std::string m_strPath;            ///< complete path to item
 
-  SortSpecial m_specialSort;
-  bool m_bIsParentFolder;
-  bool m_bCanQueue;
-  bool m_bLabelPreformated;
-  std::string m_mimetype;
+  // few distinct values, shared between items
+  CInterned<std::string> m_mimetype;
   std::string m_extrainfo;
-  bool m_doContentLookup;
-  MUSIC_INFO::CMusicInfoTag* m_musicInfoTag;
-  CVideoInfoTag* m_videoInfoTag;
+
+  // copies of an item share its info tags until one of them changes them
+  CCopyOnWritePtr<MUSIC_INFO::CMusicInfoTag> m_musicInfoTag;
+  CCopyOnWritePtr<CVideoInfoTag> m_videoInfoTag;
+  CCopyOnWritePtr<CPictureInfoTag> m_pictureInfoTag;
+  CCopyOnWritePtr<GAME::CGameInfoTag> m_gameInfoTag;
   EPG::CEpgInfoTagPtr m_epgInfoTag;
   PVR::CPVRChannelPtr m_pvrChannelInfoTag;
   PVR::CPVRRecordingPtr m_pvrRecordingInfoTag;
   PVR::CPVRTimerInfoTagPtr m_pvrTimerInfoTag;
   PVR::CPVRRadioRDSInfoTagPtr m_pvrRadioRDSInfoTag;
-  CPictureInfoTag* m_pictureInfoTag;
   std::shared_ptr<const ADDON::IAddon> m_addonInfo;
-  GAME::CGameInfoTag* m_gameInfoTag;
   EventPtr m_eventLogEntry;
-  bool m_bIsAlbum;
-
   CCueDocumentPtr m_cueDocument;
+
+  SortSpecial m_specialSort;
+  bool m_bIsParentFolder;
+  bool m_bCanQueue;
+  bool m_bLabelPreformated;
+  bool m_doContentLookup;
+  bool m_bIsAlbum;
 };
 
 /*!
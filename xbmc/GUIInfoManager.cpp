@@ -4491,6 +4491,11 @@ const infomap playlist[] =       {{ "length",           PLAYLIST_LENGTH },
 ///                  _path_,
 ///     Icon of the next recording radio channel
 ///   }
+///   \table_row3{   <b>`Pvr.EpgMemory`</b>,
+///                  \anchor Pvr_EpgMemory
+///                  _string_,
+///     Approximate amount of memory used by the EPG data
+///   }
 ///   \table_row3{   <b>`Pvr.IsRecordingTV`</b>,
 ///                  \anchor Pvr_IsRecordingTV
 ///                  _boolean_,
@@ -4601,6 +4606,7 @@ const infomap pvr[] =            {{ "isrecording",              PVR_IS_RECORDING
                                   { "radionextrecordingdatetime",     PVR_RADIO_NEXT_RECORDING_DATETIME },
                                   { "radionextrecordingchannel",      PVR_RADIO_NEXT_RECORDING_CHANNEL },
                                   { "radionextrecordingchannelicon",  PVR_RADIO_NEXT_RECORDING_CHAN_ICO },
+                                  { "epgmemory",                      PVR_EPG_MEMORY },
                                   { "isrecordingtv",              PVR_IS_RECORDING_TV },
                                   { "hastvtimer",                 PVR_HAS_TV_TIMER },
                                   { "hasnonrecordingtvtimer",     PVR_HAS_NONRECORDING_TV_TIMER },
@@ -5885,13 +5891,12 @@ std::string CGUIInfoManager::GetLabel(int info, int contextWindow, std::string *
     if (!m_currentFile)
       return "";
 
-    std::string property = m_listitemProperties[info - LISTITEM_PROPERTY_START-MUSICPLAYER_PROPERTY_OFFSET];
+    const std::string &property = m_listitemProperties[info - LISTITEM_PROPERTY_START-MUSICPLAYER_PROPERTY_OFFSET];
     if (StringUtils::StartsWithNoCase(property, "Role.") && m_currentFile->HasMusicInfoTag())
     { // "Role.xxxx" properties are held in music tag
-      property.erase(0, 5); //Remove Role.
-      return m_currentFile->GetMusicInfoTag()->GetArtistStringForRole(property);
+      return m_currentFile->GetMusicInfoTag()->GetArtistStringForRole(property.substr(5));
     }
-    return m_currentFile->GetProperty(property).asString();
+    return m_currentFile->GetProperty(m_listitemPropertyKeys[info - LISTITEM_PROPERTY_START-MUSICPLAYER_PROPERTY_OFFSET]).asString();
   }
 
   if (info >= LISTITEM_START && info <= LISTITEM_END)
@@ -5962,6 +5967,7 @@ std::string CGUIInfoManager::GetLabel(int info, int contextWindow, std::string *
   case PVR_RADIO_NEXT_RECORDING_CHANNEL:
   case PVR_RADIO_NEXT_RECORDING_CHAN_ICO:
   case PVR_RADIO_NEXT_RECORDING_DATETIME:
+  case PVR_EPG_MEMORY:
     g_PVRManager.TranslateCharInfo(info, strLabel);
     break;
   case ADSP_ACTIVE_STREAM_TYPE:
@@ -9556,6 +9562,8 @@ int CGUIInfoManager::AddListItemProp(const std::string &str, int offset)
   if (m_listitemProperties.size() < LISTITEM_PROPERTY_END - LISTITEM_PROPERTY_START)
   {
     m_listitemProperties.push_back(str);
+    m_listitemPropertyKeys.push_back(CGUIListItem::GetPropertyKey(str));
+    m_listitemArtKeys.push_back(CGUIListItem::GetArtKey(str));
     return LISTITEM_PROPERTY_START + offset + m_listitemProperties.size() - 1;
   }
 
@@ -9608,8 +9616,7 @@ bool CGUIInfoManager::GetItemInt(int &value, const CGUIListItem *item, int info)
 
   if (info >= LISTITEM_PROPERTY_START && info - LISTITEM_PROPERTY_START < (int)m_listitemProperties.size())
   { // grab the property
-    std::string property = m_listitemProperties[info - LISTITEM_PROPERTY_START];
-    std::string val = item->GetProperty(property).asString();
+    std::string val = item->GetProperty(m_listitemPropertyKeys[info - LISTITEM_PROPERTY_START]).asString();
     value = atoi(val.c_str());
     return true;
   }
@@ -9660,8 +9667,7 @@ std::string CGUIInfoManager::GetItemLabel(const CFileItem *item, int info, std::
 
   if (info >= LISTITEM_PROPERTY_START + LISTITEM_ART_OFFSET && info - (LISTITEM_PROPERTY_START + LISTITEM_ART_OFFSET) < (int)m_listitemProperties.size())
   { // grab the art
-    std::string art = m_listitemProperties[info - (LISTITEM_PROPERTY_START + LISTITEM_ART_OFFSET)];
-    return item->GetArt(art);
+    return item->GetArt(m_listitemArtKeys[info - (LISTITEM_PROPERTY_START + LISTITEM_ART_OFFSET)]);
   }
 
   if (info >= LISTITEM_PROPERTY_START + LISTITEM_RATING_OFFSET && info - (LISTITEM_PROPERTY_START + LISTITEM_RATING_OFFSET) < (int)m_listitemProperties.size())
@@ -9692,14 +9698,13 @@ std::string CGUIInfoManager::GetItemLabel(const CFileItem *item, int info, std::
 
   if (info >= LISTITEM_PROPERTY_START && info - LISTITEM_PROPERTY_START < (int)m_listitemProperties.size())
   { 
-    std::string property = m_listitemProperties[info - LISTITEM_PROPERTY_START];
+    const std::string &property = m_listitemProperties[info - LISTITEM_PROPERTY_START];
     if (StringUtils::StartsWithNoCase(property, "Role.") && item->HasMusicInfoTag())
     { // "Role.xxxx" properties are held in music tag
-      property.erase(0, 5); //Remove Role.
-      return item->GetMusicInfoTag()->GetArtistStringForRole(property);
+      return item->GetMusicInfoTag()->GetArtistStringForRole(property.substr(5));
     }
     // grab the property
-    return item->GetProperty(property).asString();
+    return item->GetProperty(m_listitemPropertyKeys[info - LISTITEM_PROPERTY_START]).asString();
   }
 
   if (info >= LISTITEM_PICTURE_START && info <= LISTITEM_PICTURE_END && item->HasPictureInfoTag())
@@ -10725,8 +10730,7 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int condition) const
   if (!item) return false;
   if (condition >= LISTITEM_PROPERTY_START && condition - LISTITEM_PROPERTY_START < (int)m_listitemProperties.size())
   { // grab the property
-    std::string property = m_listitemProperties[condition - LISTITEM_PROPERTY_START];
-    return item->GetProperty(property).asBoolean();
+    return item->GetProperty(m_listitemPropertyKeys[condition - LISTITEM_PROPERTY_START]).asBoolean();
   }
   else if (condition == LISTITEM_ISPLAYING)
   {
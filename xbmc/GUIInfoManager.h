@@ -308,6 +308,9 @@ protected:
   // Array of multiple information mapped to a single integer lookup
   std::vector<GUIInfo> m_multiInfo;
   std::vector<std::string> m_listitemProperties;
+  // keys of m_listitemProperties as property names and as art types
+  std::vector<CGUIListItem::Key> m_listitemPropertyKeys;
+  std::vector<CGUIListItem::Key> m_listitemArtKeys;
 
   std::string m_currentMovieDuration;
 
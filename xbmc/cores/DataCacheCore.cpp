@@ -25,6 +25,8 @@
 CDataCacheCore::CDataCacheCore()
 {
   m_hasAVInfoChanges = false;
+  m_fileCacheInfo.m_hits = 0;
+  m_fileCacheInfo.m_requests = 0;
 }
 
 CDataCacheCore& GetInstance()
@@ -235,3 +237,21 @@ bool CDataCacheCore::CDataCacheCore::IsSeeking()
 
   return m_stateInfo.m_stateSeeking;
 }
+
+// file cache info
+void CDataCacheCore::SetFileCacheStats(uint64_t hits, uint64_t requests)
+{
+  CSingleLock lock(m_fileCacheSection);
+
+  m_fileCacheInfo.m_hits = hits;
+  m_fileCacheInfo.m_requests = requests;
+}
+
+float CDataCacheCore::GetFileCacheHitRatio()
+{
+  CSingleLock lock(m_fileCacheSection);
+
+  if (m_fileCacheInfo.m_requests == 0)
+    return 0.0f;
+  return (float)m_fileCacheInfo.m_hits / m_fileCacheInfo.m_requests;
+}
@@ -21,6 +21,7 @@
 */
 
 #include <atomic>
+#include <stdint.h>
 #include <string>
 #include "threads/CriticalSection.h"
 
@@ -67,6 +68,10 @@ public:
   void SetStateSeeking(bool active);
   bool IsSeeking();
 
+  // file cache info
+  void SetFileCacheStats(uint64_t hits, uint64_t requests);
+  float GetFileCacheHitRatio();
+
 protected:
   std::atomic_bool m_hasAVInfoChanges;
 
@@ -103,4 +108,11 @@ protected:
   {
     bool m_stateSeeking;
   } m_stateInfo;
+
+  CCriticalSection m_fileCacheSection;
+  struct SFileCacheInfo
+  {
+    uint64_t m_hits;      // reads and seeks served from cache without waiting for the source
+    uint64_t m_requests;  // all reads and seeks
+  } m_fileCacheInfo;
 };
@@ -65,13 +65,16 @@ bool CDVDInputStreamFile::Open()
    * 2) Only buffer true internet filesystems (streams) (http, etc.)
    * 3) No buffer
    * 4) Buffer all non-local (remote) filesystems
+   * Remote files are also buffered when the persistent block cache is enabled,
+   * unless buffering is disabled completely.
    */
   if (!URIUtils::IsOnDVD(m_item.GetPath()) && !URIUtils::IsBluray(m_item.GetPath())) // Never cache these
   {
     if ((g_advancedSettings.m_cacheBufferMode == CACHE_BUFFER_MODE_INTERNET && URIUtils::IsInternetStream(m_item.GetPath(), true))
      || (g_advancedSettings.m_cacheBufferMode == CACHE_BUFFER_MODE_TRUE_INTERNET && URIUtils::IsInternetStream(m_item.GetPath(), false))
      || (g_advancedSettings.m_cacheBufferMode == CACHE_BUFFER_MODE_REMOTE && URIUtils::IsRemote(m_item.GetPath()))
-     || (g_advancedSettings.m_cacheBufferMode == CACHE_BUFFER_MODE_ALL))
+     || (g_advancedSettings.m_cacheBufferMode == CACHE_BUFFER_MODE_ALL)
+     || (g_advancedSettings.m_cacheBufferMode != CACHE_BUFFER_MODE_NONE && g_advancedSettings.m_blockCacheSize > 0 && URIUtils::IsRemote(m_item.GetPath())))
     {
       flags |= READ_CACHED;
     }
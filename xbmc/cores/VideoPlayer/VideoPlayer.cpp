@@ -3316,6 +3316,7 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
                                       , m_State.cache_level * 100);
         if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
           strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
+        strBuf += StringUtils::Format(" hits:%2.0f%%", CServiceBroker::GetDataCacheCore().GetFileCacheHitRatio() * 100);
       }
 
       strGeneralInfo = StringUtils::Format("C( a/v:% 6.3f%s, %s amp:% 5.2f )"
@@ -3342,6 +3343,7 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
                                       , m_State.cache_level * 100);
         if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
           strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
+        strBuf += StringUtils::Format(" hits:%2.0f%%", CServiceBroker::GetDataCacheCore().GetFileCacheHitRatio() * 100);
       }
 
       strGeneralInfo = StringUtils::Format("Player: a/v:% 6.3f, %s"
@@ -19,6 +19,7 @@
  */
 
 #include "Database.h"
+#include "DatabaseQueryCache.h"
 #include "settings/AdvancedSettings.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
@@ -30,6 +31,8 @@
 #include "DatabaseManager.h"
 #include "DbUrl.h"
 
+#include <inttypes.h>
+
 #ifdef HAS_MYSQL
 #include "mysqldataset.h"
 #endif
@@ -42,6 +45,19 @@ using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+/* Only known values are passed on to the sqlite pragmas, anything else
+ * from advancedsettings.xml is replaced by the default. */
+static std::string GetPragmaValue(const std::string &value, const std::vector<std::string> &valid, const std::string &fallback)
+{
+  for (std::vector<std::string>::const_iterator it = valid.begin(); it != valid.end(); ++it)
+  {
+    if (StringUtils::EqualsNoCase(value, *it))
+      return *it;
+  }
+  CLog::Log(LOGWARNING, "Invalid sqlite setting '%s', using '%s'", value.c_str(), fallback.c_str());
+  return fallback;
+}
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -155,6 +171,8 @@ CDatabase::CDatabase(void)
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_autoCommitted = false;
+  m_searchIndexesLoaded = false;
 }
 
 CDatabase::~CDatabase(void)
@@ -306,6 +324,110 @@ bool CDatabase::ResultQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::CachedQuery(const std::string &strQuery, std::unique_ptr<Dataset> &ds, bool *cached /* = NULL */)
+{
+  if (cached)
+    *cached = false;
+
+  // rows read inside a transaction may include its uncommitted writes
+  if (!m_queryCache || NULL == m_pDB.get() || m_pDB->in_transaction())
+    return ds->query(strQuery);
+
+  if (!m_queryCache->HasSchema())
+    LoadQueryCacheSchema();
+
+  CDatabaseQueryCache::SQuery query;
+  if (m_queryCache->Lookup(strQuery, *ds, query))
+  {
+    if (cached)
+      *cached = true;
+    return true;
+  }
+
+  if (!ds->query(strQuery))
+    return false;
+
+  m_queryCache->Store(query, *ds);
+  return true;
+}
+
+/* The query cache needs to know which tables the views read from and which
+ * tables the triggers write to. */
+void CDatabase::LoadQueryCacheSchema()
+{
+  std::vector<std::string> tables;
+  std::map<std::string, std::string> views;
+  std::multimap<std::string, std::string> triggers;
+  try
+  {
+    std::unique_ptr<Dataset> ds(m_pDB->CreateDataset());
+    if (m_sqlite)
+    {
+      ds->query("SELECT type, name, tbl_name, sql FROM sqlite_master WHERE type IN ('table', 'view', 'trigger')");
+      while (!ds->eof())
+      {
+        std::string type = ds->fv(0).get_asString();
+        if (type == "table")
+          tables.push_back(ds->fv(1).get_asString());
+        else if (type == "view")
+          views[ds->fv(1).get_asString()] = ds->fv(3).get_asString();
+        else
+          triggers.insert(std::make_pair(ds->fv(2).get_asString(), ds->fv(3).get_asString()));
+        ds->next();
+      }
+    }
+    else
+    {
+      ds->query("SELECT table_name FROM information_schema.tables WHERE table_schema = DATABASE() AND table_type = 'BASE TABLE'");
+      for (; !ds->eof(); ds->next())
+        tables.push_back(ds->fv(0).get_asString());
+
+      ds->query("SELECT table_name, view_definition FROM information_schema.views WHERE table_schema = DATABASE()");
+      for (; !ds->eof(); ds->next())
+        views[ds->fv(0).get_asString()] = ds->fv(1).get_asString();
+
+      ds->query("SELECT event_object_table, action_statement FROM information_schema.triggers WHERE trigger_schema = DATABASE()");
+      for (; !ds->eof(); ds->next())
+        triggers.insert(std::make_pair(ds->fv(0).get_asString(), ds->fv(1).get_asString()));
+    }
+    ds->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to read the schema of %s", __FUNCTION__, m_pDB->getDatabase());
+    return;
+  }
+
+  m_queryCache->SetSchema(tables, views, triggers);
+}
+
+void CDatabase::OnExecute(const std::string &strQuery)
+{
+  if (!m_pDB->in_transaction())
+  {
+    if (m_queryCache)
+      m_queryCache->Invalidate(strQuery);
+    if (m_autoCommitted)
+      OnAutoCommit(strQuery);
+    return;
+  }
+
+  // other connections may cache what they read until the transaction is
+  // committed, so the tables are invalidated again then
+  if (m_queryCache)
+  {
+    CDatabaseQueryCache::Tables tables = m_queryCache->Invalidate(strQuery);
+    m_writtenTables.insert(tables.begin(), tables.end());
+  }
+}
+
+void CDatabase::InvalidateWrittenTables()
+{
+  if (m_queryCache && !m_writtenTables.empty())
+    m_queryCache->Invalidate(m_writtenTables);
+  m_writtenTables.clear();
+}
+
 bool CDatabase::QueueInsertQuery(const std::string &strQuery)
 {
   if (strQuery.empty())
@@ -371,7 +493,12 @@ bool CDatabase::Open(const DatabaseSettings &settings)
 
   std::string dbName = dbSettings.name;
   dbName += StringUtils::Format("%d", GetSchemaVersion());
-  return Connect(dbName, dbSettings, false);
+  if (!Connect(dbName, dbSettings, false))
+    return false;
+
+  // the schema is up to date, unlike while the database is updated
+  m_autoCommitted = true;
+  return true;
 }
 
 void CDatabase::InitSettings(DatabaseSettings &dbSettings)
@@ -460,6 +587,16 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   m_pDS.reset(m_pDB->CreateDataset());
   m_pDS2.reset(m_pDB->CreateDataset());
 
+  // all connections to the database share a cache and invalidate it
+  if (dbSettings.querycachesize > 0)
+  {
+    // other clients of a shared database may write to it without us knowing
+    unsigned int maxAge = dbSettings.type == "mysql" ? dbSettings.querycachetime * 1000 : 0;
+    m_queryCache = CDatabaseQueryCache::GetCache(dbSettings.type + "://" + dbSettings.host + ":" + dbSettings.port + "/" + dbName,
+                                                 dbSettings.querycachesize * 1024, maxAge);
+  }
+  m_pDB->set_exec_observer([this](const std::string &sql) { OnExecute(sql); });
+
   if (m_pDB->connect(create) != DB_CONNECTION_OK)
     return false;
 
@@ -486,8 +623,14 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
     // sqlite3 post connection operations
     if (dbSettings.type == "sqlite3")
     {
+      std::string journalMode = GetPragmaValue(dbSettings.journalmode, { "delete", "truncate", "persist", "memory", "wal" }, "delete");
+      std::string synchronous = GetPragmaValue(dbSettings.synchronous, { "off", "normal", "full" }, "normal");
+
       m_pDS->exec("PRAGMA cache_size=4096\n");
-      m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
+      // readers don't block the writer and the writer doesn't block readers in WAL mode,
+      // the journal mode is stored in the database so it's always set
+      m_pDS->exec("PRAGMA journal_mode=" + journalMode + "\n");
+      m_pDS->exec("PRAGMA synchronous=" + synchronous + "\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
     }
   }
@@ -529,6 +672,20 @@ void CDatabase::Close()
 
   m_openCount = 0;
   m_multipleExecute = false;
+  m_autoCommitted = false;
+
+  // an open transaction is rolled back
+  InvalidateWrittenTables();
+  m_transactions.clear();
+  m_afterCommit.clear();
+  if (m_queryCache && NULL != m_pDB.get())
+  {
+    CDatabaseQueryCache::Stats stats = m_queryCache->GetStats();
+    CLog::Log(LOGDEBUG, "%s - query cache of %s: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " invalidations, %" PRIu64 " evictions, %zu results using %zu bytes",
+              __FUNCTION__, m_pDB->getDatabase(), stats.hits, stats.misses, stats.invalidations, stats.evictions, stats.entries, stats.size);
+  }
+  m_queryCache.reset();
+  m_searchIndexesLoaded = false;
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
@@ -584,7 +741,15 @@ void CDatabase::BeginTransaction()
   try
   {
     if (NULL != m_pDB.get())
-      m_pDB->start_transaction();
+    {
+      // a transaction started inside another one is a savepoint of the outer one,
+      // so it can be rolled back without losing the writes around it
+      m_transactions.push_back(m_afterCommit.size());
+      if (m_transactions.size() == 1)
+        m_pDB->start_transaction();
+      else
+        ExecuteSavepoint("SAVEPOINT");
+    }
   }
   catch (...)
   {
@@ -594,25 +759,69 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_transactions.size() > 1)
+  {
+    try
+    {
+      ExecuteSavepoint("RELEASE SAVEPOINT");
+      m_transactions.pop_back();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "database:committransaction failed to release savepoint");
+      m_transactions.pop_back();
+      return false;
+    }
+    return true;
+  }
+
+  m_transactions.clear();
+  std::vector<std::function<void()> > afterCommit;
+  afterCommit.swap(m_afterCommit);
   try
   {
-    if (NULL != m_pDB.get())
+    // failed commits are reported now, committing without a transaction isn't one
+    if (NULL != m_pDB.get() && m_pDB->in_transaction())
       m_pDB->commit_transaction();
+    InvalidateWrittenTables();
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "database:committransaction failed");
+    InvalidateWrittenTables();
     return false;
   }
+
+  for (std::vector<std::function<void()> >::const_iterator function = afterCommit.begin(); function != afterCommit.end(); ++function)
+    (*function)();
   return true;
 }
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_transactions.size() > 1)
+  {
+    m_afterCommit.erase(m_afterCommit.begin() + m_transactions.back(), m_afterCommit.end());
+    try
+    {
+      ExecuteSavepoint("ROLLBACK TO SAVEPOINT");
+      ExecuteSavepoint("RELEASE SAVEPOINT");
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "database:rollbacktransaction failed to roll back savepoint");
+    }
+    m_transactions.pop_back();
+    return;
+  }
+
+  m_transactions.clear();
+  m_afterCommit.clear();
   try
   {
     if (NULL != m_pDB.get())
       m_pDB->rollback_transaction();
+    InvalidateWrittenTables();
   }
   catch (...)
   {
@@ -622,10 +831,25 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
+void CDatabase::RunAfterCommit(const std::function<void()> &function)
+{
+  if (InTransaction())
+    m_afterCommit.push_back(function);
+  else
+    function();
+}
+
+void CDatabase::ExecuteSavepoint(const std::string &statement)
+{
+  // a dataset of its own, the caller may be reading from m_pDS
+  std::unique_ptr<Dataset> ds(m_pDB->CreateDataset());
+  ds->exec(StringUtils::Format("%s nested%u", statement.c_str(), (unsigned int)m_transactions.size() - 1));
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
@@ -673,6 +897,105 @@ bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std:
   return true;
 }
 
+bool CDatabase::CreateSearchIndex(const std::string &index, const std::string &table, const std::string &key, const std::vector<std::string> &columns)
+{
+  if (!m_sqlite || columns.empty())
+    return false;
+
+  std::string fields = StringUtils::Join(columns, ", ");
+  std::string newValues = "new." + key;
+  std::string oldValues = "old." + key;
+  for (std::vector<std::string>::const_iterator column = columns.begin(); column != columns.end(); ++column)
+  {
+    newValues += ", new." + *column;
+    oldValues += ", old." + *column;
+  }
+  std::string insert = "INSERT INTO " + index + " (rowid, " + fields + ") VALUES (" + newValues + "); ";
+  std::string remove = "INSERT INTO " + index + " (" + index + ", rowid, " + fields + ") VALUES ('delete', " + oldValues + "); ";
+
+  try
+  {
+    CLog::Log(LOGINFO, "create full text index %s", index.c_str());
+    // the index only holds the words, its text is read from the table
+    m_pDS->exec("DROP TABLE IF EXISTS " + index);
+    m_pDS->exec("CREATE VIRTUAL TABLE " + index + " USING fts5(" + fields + ", content='" + table + "', content_rowid='" + key + "')");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGWARNING, "%s - full text indexes are not supported, searching %s will be slow", __FUNCTION__, table.c_str());
+    return false;
+  }
+
+  try
+  {
+    m_pDS->exec("CREATE TRIGGER " + index + "_insert AFTER INSERT ON " + table + " FOR EACH ROW BEGIN " + insert + "END");
+    m_pDS->exec("CREATE TRIGGER " + index + "_update AFTER UPDATE OF " + fields + " ON " + table + " FOR EACH ROW BEGIN " + remove + insert + "END");
+    m_pDS->exec("CREATE TRIGGER " + index + "_delete AFTER DELETE ON " + table + " FOR EACH ROW BEGIN " + remove + "END");
+    m_pDS->exec("INSERT INTO " + index + " (" + index + ") VALUES ('rebuild')");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - unable to create full text index %s", __FUNCTION__, index.c_str());
+    return false;
+  }
+
+  m_searchIndexesLoaded = false;
+  return true;
+}
+
+std::string CDatabase::GetSearchMatch(const std::string &columns, const std::string &search, bool fromStart)
+{
+  // punctuation isn't indexed, a search without any words can't be matched
+  bool hasWords = false;
+  for (std::string::const_iterator c = search.begin(); c != search.end() && !hasWords; ++c)
+    hasWords = isalnum(static_cast<unsigned char>(*c)) || (*c & 0x80);
+  if (!hasWords)
+    return "";
+
+  std::string phrase = search;
+  StringUtils::Replace(phrase, "\"", "\"\"");
+  std::string match = "\"" + phrase + "\"*";
+  if (fromStart)
+    match = "^" + match;
+  if (!columns.empty())
+    match = "{" + columns + "} : " + match;
+  return match;
+}
+
+std::string CDatabase::GetSearchWhere(const std::string &index, const std::string &key, const std::string &columns,
+                                      const std::string &search, bool fromStart, const std::string &fallback)
+{
+  if (!m_sqlite || NULL == m_pDB.get())
+    return fallback;
+
+  if (!m_searchIndexesLoaded)
+  {
+    m_searchIndexes.clear();
+    try
+    {
+      std::unique_ptr<Dataset> ds(m_pDB->CreateDataset());
+      ds->query("SELECT name FROM sqlite_master WHERE type = 'table' AND sql LIKE 'CREATE VIRTUAL TABLE % USING fts5(%'");
+      for (; !ds->eof(); ds->next())
+        m_searchIndexes.insert(ds->fv(0).get_asString());
+      ds->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - failed to read the full text indexes of %s", __FUNCTION__, m_pDB->getDatabase());
+    }
+    m_searchIndexesLoaded = true;
+  }
+
+  if (m_searchIndexes.find(index) == m_searchIndexes.end())
+    return fallback;
+
+  std::string match = GetSearchMatch(columns, search, fromStart);
+  if (match.empty())
+    return fallback;
+
+  return PrepareSQL("%s IN (SELECT rowid FROM %s WHERE %s MATCH '%s')", key.c_str(), index.c_str(), index.c_str(), match.c_str());
+}
+
 bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
@@ -25,11 +25,14 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <functional>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 class DatabaseSettings; // forward
+class CDatabaseQueryCache;
 class CDbUrl;
 struct SortDescription;
 
@@ -82,6 +85,10 @@ public:
 
   bool Open(const DatabaseSettings &db);
 
+  /*! \brief Begin a transaction.
+   Transactions begun inside another one are savepoints, committing them only
+   commits the outer transaction and rolling them back only undoes their own writes.
+   */
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
@@ -136,6 +143,17 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Run a query through the query result cache of the database.
+   *        Repeated queries are answered from memory until one of the tables
+   *        they read from is written to, otherwise the same as ds->query().
+   * @param strQuery The query to run.
+   * @param ds The dataset to run the query on.
+   * @param cached If set, whether the rows came from the cache.
+   * @return True if the query was run or answered successfully.
+   */
+  bool CachedQuery(const std::string &strQuery, std::unique_ptr<dbiplus::Dataset> &ds, bool *cached = NULL);
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -175,6 +193,14 @@ public:
 
   bool Connect(const std::string &dbName, const DatabaseSettings &db, bool create);
 
+  /*! \brief Get the FTS5 MATCH expression for a search, as used by GetSearchWhere().
+   \param columns space separated columns to match, empty to match all indexed columns.
+   \param search the search as entered by the user.
+   \param fromStart whether the search has to match the start of the text.
+   \return the (unprepared) expression, empty if the search has no words to match.
+   */
+  static std::string GetSearchMatch(const std::string &columns, const std::string &search, bool fromStart);
+
 protected:
   friend class CDatabaseManager;
 
@@ -216,6 +242,44 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Run a function once the current transaction is committed, right away if there is none.
+   Used for announcing changes, which others read back from the database.
+   The function is dropped if the transaction is rolled back.
+   */
+  void RunAfterCommit(const std::function<void()> &function);
+
+  /*! \brief Called after a statement was executed and committed outside of a transaction.
+   Not called while the database is created or updated. The statement's dataset is still
+   in use, so m_pDS and m_pDS2 may be too.
+   \param strQuery the statement.
+   */
+  virtual void OnAutoCommit(const std::string &strQuery) {}
+
+  /*! \brief Create a full text index over text columns of a table.
+   Only available on sqlite built with FTS5. The index reads its text from the table
+   and is kept up to date by triggers, so it has to be created in CreateAnalytics().
+   \param index name of the index.
+   \param table table to index.
+   \param key integer primary key of the table.
+   \param columns the columns of the table to index.
+   \return true if the index was created, false if searches fall back to LIKE.
+   \sa GetSearchWhere
+   */
+  bool CreateSearchIndex(const std::string &index, const std::string &table, const std::string &key, const std::vector<std::string> &columns);
+
+  /*! \brief Get a WHERE condition matching the rows with words starting with a search.
+   The search is matched as a phrase, its last word may be incomplete.
+   \param index name of the index created by CreateSearchIndex().
+   \param key the key column of the indexed table, e.g. "movie.idMovie".
+   \param columns space separated columns to match, empty to match all indexed columns.
+   \param search the search as entered by the user.
+   \param fromStart whether the search has to match the start of the text.
+   \param fallback the (prepared) condition to use if there is no index.
+   \return the condition.
+   */
+  std::string GetSearchWhere(const std::string &index, const std::string &key, const std::string &columns,
+                             const std::string &search, bool fromStart, const std::string &fallback);
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -225,10 +289,22 @@ protected:
 private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
+  void LoadQueryCacheSchema();
+  void OnExecute(const std::string &strQuery);
+  void InvalidateWrittenTables();
+  void ExecuteSavepoint(const std::string &statement);
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
+  bool m_autoCommitted; /*!< Whether OnAutoCommit() is called, once the database is opened */
   std::vector<std::string> m_multipleQueries;
+
+  std::shared_ptr<CDatabaseQueryCache> m_queryCache;
+  std::set<std::string> m_writtenTables; /*!< Tables written in the current transaction */
+  std::vector<size_t> m_transactions; /*!< Open (nested) transactions, with the number of m_afterCommit functions when they began */
+  std::vector<std::function<void()> > m_afterCommit; /*!< Functions to run once the current transaction is committed */
+  std::set<std::string> m_searchIndexes; /*!< Full text indexes of the database, once loaded */
+  bool m_searchIndexesLoaded;
 };
@@ -0,0 +1,427 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseQueryCache.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+#include "dataset.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+// a single result may use this part of the cache at most
+#define QUERY_CACHE_MAX_ENTRY_PART 2
+
+using namespace dbiplus;
+
+std::shared_ptr<CDatabaseQueryCache> CDatabaseQueryCache::GetCache(const std::string &name, size_t maxSize, unsigned int maxAge)
+{
+  static CCriticalSection critSection;
+  static std::map<std::string, std::shared_ptr<CDatabaseQueryCache> > caches;
+
+  CSingleLock lock(critSection);
+  std::shared_ptr<CDatabaseQueryCache> &cache = caches[name];
+  if (!cache)
+    cache.reset(new CDatabaseQueryCache(maxSize, maxAge));
+  return cache;
+}
+
+CDatabaseQueryCache::CDatabaseQueryCache(size_t maxSize, unsigned int maxAge)
+  : m_maxSize(maxSize),
+    m_maxAge(maxAge),
+    m_hasSchema(false),
+    m_epoch(0)
+{
+}
+
+bool CDatabaseQueryCache::HasSchema() const
+{
+  CSingleLock lock(m_critSection);
+  return m_hasSchema;
+}
+
+void CDatabaseQueryCache::SetSchema(const std::vector<std::string> &tables,
+                                    const std::map<std::string, std::string> &views,
+                                    const std::multimap<std::string, std::string> &triggers)
+{
+  std::map<std::string, Tables> reads;
+  std::map<std::string, Tables> writes;
+  for (std::vector<std::string>::const_iterator table = tables.begin(); table != tables.end(); ++table)
+  {
+    std::string name = Normalize(*table);
+    reads[name].insert(name);
+    writes[name].insert(name);
+  }
+
+  // views read the tables named in their definition, views of views are
+  // resolved by repeating until nothing changes
+  std::map<std::string, std::vector<std::string> > viewIdentifiers;
+  for (std::map<std::string, std::string>::const_iterator view = views.begin(); view != views.end(); ++view)
+  {
+    viewIdentifiers[Normalize(view->first)] = GetIdentifiers(view->second);
+    reads[Normalize(view->first)];
+  }
+  for (bool changed = true; changed; )
+  {
+    changed = false;
+    for (std::map<std::string, std::vector<std::string> >::const_iterator view = viewIdentifiers.begin(); view != viewIdentifiers.end(); ++view)
+    {
+      Tables &read = reads[view->first];
+      for (std::vector<std::string>::const_iterator name = view->second.begin(); name != view->second.end(); ++name)
+      {
+        std::map<std::string, Tables>::const_iterator source = reads.find(*name);
+        if (source == reads.end() || *name == view->first)
+          continue;
+        for (Tables::const_iterator table = source->second.begin(); table != source->second.end(); ++table)
+          changed |= read.insert(*table).second;
+      }
+    }
+  }
+
+  // writing to a table also writes the tables its triggers name, which may
+  // fire their own triggers
+  for (std::multimap<std::string, std::string>::const_iterator trigger = triggers.begin(); trigger != triggers.end(); ++trigger)
+  {
+    Tables &written = writes[Normalize(trigger->first)];
+    std::vector<std::string> names = GetIdentifiers(trigger->second);
+    for (std::vector<std::string>::const_iterator name = names.begin(); name != names.end(); ++name)
+    {
+      if (writes.find(*name) != writes.end())
+        written.insert(*name);
+    }
+  }
+  for (bool changed = true; changed; )
+  {
+    changed = false;
+    for (std::map<std::string, Tables>::iterator table = writes.begin(); table != writes.end(); ++table)
+    {
+      Tables written = table->second;
+      for (Tables::const_iterator name = written.begin(); name != written.end(); ++name)
+      {
+        const Tables &more = writes[*name];
+        for (Tables::const_iterator other = more.begin(); other != more.end(); ++other)
+          changed |= table->second.insert(*other).second;
+      }
+    }
+  }
+
+  CSingleLock lock(m_critSection);
+  m_reads.swap(reads);
+  m_writes.swap(writes);
+  m_hasSchema = true;
+}
+
+bool CDatabaseQueryCache::Lookup(const std::string &sql, Dataset &ds, SQuery &query)
+{
+  query.key = Normalize(sql);
+  query.tables.clear();
+  query.cacheable = false;
+
+  std::shared_ptr<const SRows> rows;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_hasSchema)
+      return false;
+
+    Entries::iterator entry = m_entries.find(query.key);
+    if (entry != m_entries.end())
+    {
+      if (IsValid(entry->second))
+      {
+        m_lru.splice(m_lru.begin(), m_lru, entry->second.lru);
+        m_stats.hits++;
+        rows = entry->second.rows;
+      }
+      else
+      {
+        Remove(entry);
+        m_stats.invalidations++;
+      }
+    }
+
+    if (!rows)
+    {
+      m_stats.misses++;
+
+      // remember the generations before the query runs, a write that commits
+      // while it does leaves the stored result invalid
+      Tables tables = GetReadTables(query.key);
+      for (Tables::const_iterator table = tables.begin(); table != tables.end(); ++table)
+      {
+        std::map<std::string, uint64_t>::const_iterator generation = m_generations.find(*table);
+        query.tables.push_back(std::make_pair(*table, generation != m_generations.end() ? generation->second : 0));
+      }
+      query.epoch = m_epoch;
+      query.cacheable = !tables.empty();
+      return false;
+    }
+  }
+
+  // copy outside of the lock, the rows are never modified once stored
+  ds.load_result(rows->header, rows->records);
+  return true;
+}
+
+void CDatabaseQueryCache::Store(const SQuery &query, Dataset &ds)
+{
+  if (!query.cacheable)
+    return;
+
+  const result_set &result = ds.get_result_set();
+  std::shared_ptr<SRows> rows(new SRows);
+  rows->header = result.record_header;
+  rows->records.reserve(result.records.size());
+
+  size_t size = sizeof(SEntry) + 2 * query.key.size() + rows->header.size() * sizeof(field_prop);
+  for (query_data::const_iterator record = result.records.begin(); record != result.records.end(); ++record)
+  {
+    if (*record == NULL)
+      return;
+
+    rows->records.push_back(**record);
+    size += sizeof(sql_record) + (*record)->size() * sizeof(field_value);
+    for (sql_record::const_iterator value = (*record)->begin(); value != (*record)->end(); ++value)
+    {
+      if (value->get_fType() == ft_String)
+        size += value->get_asString().size();
+    }
+    if (size > m_maxSize / QUERY_CACHE_MAX_ENTRY_PART)
+      return;
+  }
+
+  CSingleLock lock(m_critSection);
+  SEntry entry;
+  entry.rows = rows;
+  entry.tables = query.tables;
+  entry.epoch = query.epoch;
+  entry.time = XbmcThreads::SystemClockMillis();
+  entry.size = size;
+  if (!IsValid(entry))
+    return;
+
+  Entries::iterator existing = m_entries.find(query.key);
+  if (existing != m_entries.end())
+    Remove(existing);
+
+  m_lru.push_front(query.key);
+  entry.lru = m_lru.begin();
+  m_entries.insert(std::make_pair(query.key, entry));
+  m_stats.size += size;
+
+  while (m_stats.size > m_maxSize && !m_lru.empty())
+  {
+    Remove(m_entries.find(m_lru.back()));
+    m_stats.evictions++;
+  }
+}
+
+CDatabaseQueryCache::Tables CDatabaseQueryCache::Invalidate(const std::string &sql)
+{
+  std::vector<std::string> identifiers = GetIdentifiers(sql);
+
+  CSingleLock lock(m_critSection);
+  Tables tables;
+  if (!GetWrittenTables(identifiers, tables))
+  {
+    // the schema changed, start over
+    m_stats.invalidations += m_entries.size();
+    m_entries.clear();
+    m_lru.clear();
+    m_stats.size = 0;
+    m_reads.clear();
+    m_writes.clear();
+    m_hasSchema = false;
+    m_epoch++;
+    return tables;
+  }
+
+  for (Tables::const_iterator table = tables.begin(); table != tables.end(); ++table)
+    m_generations[*table]++;
+  return tables;
+}
+
+void CDatabaseQueryCache::Invalidate(const Tables &tables)
+{
+  CSingleLock lock(m_critSection);
+  for (Tables::const_iterator table = tables.begin(); table != tables.end(); ++table)
+    m_generations[*table]++;
+}
+
+CDatabaseQueryCache::Stats CDatabaseQueryCache::GetStats() const
+{
+  CSingleLock lock(m_critSection);
+  Stats stats = m_stats;
+  stats.entries = m_entries.size();
+  return stats;
+}
+
+std::string CDatabaseQueryCache::Normalize(const std::string &sql)
+{
+  std::string normalized;
+  normalized.reserve(sql.size());
+
+  bool literal = false;
+  bool space = false;
+  for (std::string::const_iterator c = sql.begin(); c != sql.end(); ++c)
+  {
+    if (literal)
+    {
+      normalized += *c;
+      literal = *c != '\'';
+      continue;
+    }
+
+    if (isspace((unsigned char)*c))
+    {
+      space = true;
+      continue;
+    }
+
+    if (space && !normalized.empty())
+      normalized += ' ';
+    space = false;
+    normalized += (char)tolower((unsigned char)*c);
+    literal = *c == '\'';
+  }
+  return normalized;
+}
+
+/* Splits SQL into lower case identifiers and keywords outside of string
+ * literals, statements are separated by ";".
+ */
+std::vector<std::string> CDatabaseQueryCache::GetIdentifiers(const std::string &sql)
+{
+  std::vector<std::string> identifiers;
+  std::string identifier;
+  bool literal = false;
+  bool number = false;
+  for (std::string::const_iterator c = sql.begin(); c != sql.end(); ++c)
+  {
+    unsigned char ch = (unsigned char)*c;
+    if (!literal && (isalnum(ch) || ch == '_'))
+    {
+      if (identifier.empty() && !number && isdigit(ch))
+        number = true;
+      if (!number)
+        identifier += (char)tolower(ch);
+      continue;
+    }
+
+    number = false;
+    if (!identifier.empty())
+    {
+      identifiers.push_back(identifier);
+      identifier.clear();
+    }
+    if (ch == '\'')
+      literal = !literal;
+    else if (ch == ';' && !literal)
+      identifiers.push_back(";");
+  }
+  if (!identifier.empty())
+    identifiers.push_back(identifier);
+  return identifiers;
+}
+
+CDatabaseQueryCache::Tables CDatabaseQueryCache::GetReadTables(const std::string &sql) const
+{
+  Tables tables;
+  std::vector<std::string> identifiers = GetIdentifiers(sql);
+  for (std::vector<std::string>::const_iterator name = identifiers.begin(); name != identifiers.end(); ++name)
+  {
+    std::map<std::string, Tables>::const_iterator read = m_reads.find(*name);
+    if (read == m_reads.end())
+      continue;
+
+    // a view whose definition couldn't be read can't be tracked
+    if (read->second.empty())
+      return Tables();
+    tables.insert(read->second.begin(), read->second.end());
+  }
+  return tables;
+}
+
+/* Finds the tables written by INSERT, REPLACE, UPDATE and DELETE statements,
+ * returns false for statements changing the schema.
+ */
+bool CDatabaseQueryCache::GetWrittenTables(const std::vector<std::string> &identifiers, Tables &tables) const
+{
+  std::vector<std::string>::const_iterator token = identifiers.begin();
+  while (token != identifiers.end())
+  {
+    std::vector<std::string>::const_iterator end = std::find(token, identifiers.end(), ";");
+    const std::string &command = *token;
+    std::string table;
+    if (command == "create" || command == "drop" || command == "alter" || command == "rename")
+      return false;
+    else if (command == "insert" || command == "replace" || command == "delete")
+    {
+      std::vector<std::string>::const_iterator name = std::find(token, end, command == "delete" ? "from" : "into");
+      if (name != end && ++name != end)
+        table = *name;
+    }
+    else if (command == "update" && token + 1 != end)
+    {
+      // UPDATE OR REPLACE table
+      std::vector<std::string>::const_iterator name = token + 1;
+      if (*name == "or" && end - name > 2)
+        name += 2;
+      table = *name;
+    }
+
+    if (!table.empty())
+    {
+      std::map<std::string, Tables>::const_iterator written = m_writes.find(table);
+      if (written != m_writes.end())
+        tables.insert(written->second.begin(), written->second.end());
+      else
+        tables.insert(table);
+    }
+
+    token = end != identifiers.end() ? end + 1 : end;
+  }
+  return true;
+}
+
+bool CDatabaseQueryCache::IsValid(const SEntry &entry) const
+{
+  if (entry.epoch != m_epoch)
+    return false;
+  if (m_maxAge > 0 && XbmcThreads::SystemClockMillis() - entry.time >= m_maxAge)
+    return false;
+
+  for (std::vector<std::pair<std::string, uint64_t> >::const_iterator table = entry.tables.begin(); table != entry.tables.end(); ++table)
+  {
+    std::map<std::string, uint64_t>::const_iterator generation = m_generations.find(table->first);
+    if ((generation != m_generations.end() ? generation->second : 0) != table->second)
+      return false;
+  }
+  return true;
+}
+
+void CDatabaseQueryCache::Remove(Entries::iterator entry)
+{
+  if (entry == m_entries.end())
+    return;
+  m_stats.size -= entry->second.size;
+  m_lru.erase(entry->second.lru);
+  m_entries.erase(entry);
+}
@@ -0,0 +1,159 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "qry_dat.h"
+#include "threads/CriticalSection.h"
+
+namespace dbiplus
+{
+  class Dataset;
+}
+
+/*!
+ \brief Cache of query results shared by all connections to a database.
+
+ Results are keyed by their normalized SQL and remember the tables they were
+ read from, views are resolved to their tables. Every statement executed on a
+ connection to the database invalidates the results read from the tables it
+ writes to, including the tables written by their triggers. Schema changes
+ drop the whole cache.
+
+ The table generations a result depends on are taken before the query runs,
+ so a result that was read while a write committed is never served.
+ Writes by other clients of a shared (MySQL) database can't be seen, results
+ of those expire after a while instead.
+ */
+class CDatabaseQueryCache
+{
+public:
+  typedef std::set<std::string> Tables;
+
+  struct Stats
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0; ///< results dropped because their tables changed or they expired
+    uint64_t evictions = 0;     ///< results dropped to stay within the size limit
+    size_t entries = 0;
+    size_t size = 0;            ///< approximate memory used by the results in bytes
+  };
+
+  /*! \brief A query that missed the cache, passed back to Store() with its rows */
+  struct SQuery
+  {
+    std::string key;
+    std::vector<std::pair<std::string, uint64_t> > tables;
+    uint64_t epoch = 0;
+    bool cacheable = false;
+  };
+
+  /*!
+   \brief Get the cache of a database, creating it on first use.
+   \param name identifies the database, e.g. its type, host and name.
+   \param maxSize limit of the memory used by results in bytes.
+   \param maxAge time in ms after which results expire, 0 if they don't.
+   */
+  static std::shared_ptr<CDatabaseQueryCache> GetCache(const std::string &name, size_t maxSize, unsigned int maxAge);
+
+  CDatabaseQueryCache(size_t maxSize, unsigned int maxAge);
+
+  /*!
+   \brief Whether the tables, views and triggers of the database are known.
+   Results aren't cached until SetSchema() was called.
+   */
+  bool HasSchema() const;
+  void SetSchema(const std::vector<std::string> &tables,
+                 const std::map<std::string, std::string> &views,
+                 const std::multimap<std::string, std::string> &triggers);
+
+  /*!
+   \brief Open a dataset on the cached rows of a query.
+   \param query set up for storing the rows on a miss.
+   \return true on a hit, false if the query has to be run.
+   */
+  bool Lookup(const std::string &sql, dbiplus::Dataset &ds, SQuery &query);
+
+  /*!
+   \brief Store the rows of a query that missed the cache.
+   */
+  void Store(const SQuery &query, dbiplus::Dataset &ds);
+
+  /*!
+   \brief Invalidate the results read from the tables an executed statement writes to.
+   \return the tables the statement writes to.
+   */
+  Tables Invalidate(const std::string &sql);
+  void Invalidate(const Tables &tables);
+
+  Stats GetStats() const;
+
+  /*!
+   \brief Collapse whitespace and lower case the SQL outside of string literals.
+   */
+  static std::string Normalize(const std::string &sql);
+
+private:
+  struct SRows
+  {
+    dbiplus::record_prop header;
+    std::vector<dbiplus::sql_record> records;
+  };
+
+  struct SEntry
+  {
+    std::shared_ptr<const SRows> rows;
+    std::vector<std::pair<std::string, uint64_t> > tables;
+    uint64_t epoch;
+    unsigned int time;
+    size_t size;
+    std::list<std::string>::iterator lru;
+  };
+
+  typedef std::unordered_map<std::string, SEntry> Entries;
+
+  static std::vector<std::string> GetIdentifiers(const std::string &sql);
+  Tables GetReadTables(const std::string &sql) const;
+  bool GetWrittenTables(const std::vector<std::string> &identifiers, Tables &tables) const;
+  bool IsValid(const SEntry &entry) const;
+  void Remove(Entries::iterator entry);
+
+  CCriticalSection m_critSection;
+  size_t m_maxSize;
+  unsigned int m_maxAge;
+  bool m_hasSchema;
+  uint64_t m_epoch;
+  std::map<std::string, Tables> m_reads;  ///< tables read by a table or view
+  std::map<std::string, Tables> m_writes; ///< tables written by a table and its triggers
+  std::map<std::string, uint64_t> m_generations;
+  Entries m_entries;
+  std::list<std::string> m_lru;
+  Stats m_stats;
+};
@@ -0,0 +1,152 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseWriter.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <vector>
+
+#include "Database.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+// time a batch is held open for more writes unless a flush is waiting
+#define DATABASE_WRITE_DELAY 100
+// writes that are committed right away without waiting for more
+#define DATABASE_WRITE_BATCH_SIZE 100
+
+struct CDatabaseWriter::SState
+{
+  CCriticalSection critSection;
+  XbmcThreads::ConditionVariable condition;
+  Factory factory;
+  std::vector<Write> pending;
+  bool running = false;
+  uint64_t queued = 0;      // number of writes queued so far
+  uint64_t processed = 0;   // number of writes that have been committed or dropped
+  uint64_t failed = 0;      // number of writes up to the last batch that was dropped
+  uint64_t flushTarget = 0; // number of writes a flush is waiting for
+};
+
+CDatabaseWriter::CDatabaseWriter(const Factory &factory)
+  : m_state(new SState)
+{
+  m_state->factory = factory;
+}
+
+void CDatabaseWriter::Queue(const Write &write)
+{
+  CSingleLock lock(m_state->critSection);
+  m_state->pending.push_back(write);
+  m_state->queued++;
+
+  if (m_state->running)
+  {
+    if (m_state->pending.size() >= DATABASE_WRITE_BATCH_SIZE)
+      m_state->condition.notifyAll();
+    return;
+  }
+
+  m_state->running = true;
+  std::shared_ptr<SState> state = m_state;
+  if (CJobManager::GetInstance().Submit([state]() { Process(state); }, CJob::PRIORITY_DEDICATED))
+    return;
+
+  // the job manager is stopping, write right away on this thread
+  m_state->flushTarget = std::max(m_state->flushTarget, m_state->queued);
+  lock.Leave();
+  Process(state);
+}
+
+bool CDatabaseWriter::Flush(unsigned int timeout)
+{
+  CSingleLock lock(m_state->critSection);
+  uint64_t target = m_state->queued;
+  uint64_t start = m_state->processed;
+  if (start >= target)
+    return true;
+
+  m_state->flushTarget = std::max(m_state->flushTarget, target);
+  m_state->condition.notifyAll();
+
+  XbmcThreads::EndTime endTime(timeout);
+  while (m_state->processed < target)
+  {
+    if (endTime.IsTimePast())
+    {
+      CLog::Log(LOGWARNING, "CDatabaseWriter::Flush - timed out waiting for %" PRIu64" writes", target - m_state->processed);
+      return false;
+    }
+    m_state->condition.wait(lock, endTime.MillisLeft());
+  }
+
+  // a batch that failed after the flush started held some of the flushed writes
+  return m_state->failed <= start;
+}
+
+void CDatabaseWriter::Process(const std::shared_ptr<SState> &state)
+{
+  std::unique_ptr<CDatabase> db;
+
+  CSingleLock lock(state->critSection);
+  while (!state->pending.empty())
+  {
+    // give other producers a moment to add their writes to this transaction
+    XbmcThreads::EndTime endTime(DATABASE_WRITE_DELAY);
+    while (state->flushTarget <= state->processed && state->pending.size() < DATABASE_WRITE_BATCH_SIZE &&
+           !endTime.IsTimePast())
+      state->condition.wait(lock, endTime.MillisLeft());
+
+    std::vector<Write> batch;
+    batch.swap(state->pending);
+    uint64_t last = state->queued;
+    lock.Leave();
+
+    if (!db)
+      db.reset(state->factory());
+
+    // writes that begin their own transaction get a savepoint of the batch
+    bool committed = false;
+    if (db)
+    {
+      db->BeginTransaction();
+      for (std::vector<Write>::const_iterator write = batch.begin(); write != batch.end(); ++write)
+        (*write)(*db);
+      committed = db->CommitTransaction();
+      if (!committed)
+        CLog::Log(LOGERROR, "CDatabaseWriter::Process - failed to commit %u writes", (unsigned int)batch.size());
+    }
+    else
+      CLog::Log(LOGERROR, "CDatabaseWriter::Process - unable to open database, dropping %u writes", (unsigned int)batch.size());
+
+    lock.Enter();
+    state->processed = last;
+    if (!committed)
+      state->failed = last;
+    state->condition.notifyAll();
+  }
+
+  state->running = false;
+}
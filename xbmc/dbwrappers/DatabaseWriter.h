@@ -0,0 +1,74 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <memory>
+
+class CDatabase;
+
+/*!
+ \brief Single writer for a database.
+
+ Writes queued from any thread are run by one job at a time on a connection
+ owned by the writer. Writes that arrive close together are grouped into one
+ transaction, so producers like playback state saving and marking items as
+ watched don't each commit (and sync) their own small transaction while
+ competing for the database lock.
+
+ Queued writes are not visible to other connections until they are
+ committed, Flush() is the durability point producers call before reading
+ back what they wrote or telling others about it.
+ */
+class CDatabaseWriter
+{
+public:
+  /*!
+   \brief Creates and opens the writer's connection, returns NULL on failure.
+   */
+  typedef std::function<CDatabase*()> Factory;
+  typedef std::function<void(CDatabase&)> Write;
+
+  explicit CDatabaseWriter(const Factory &factory);
+
+  /*!
+   \brief Queue a write, returns right away.
+   Once the job manager is stopping the write is committed before returning.
+   */
+  void Queue(const Write &write);
+
+  /*!
+   \brief Wait until all writes queued so far are committed.
+   Must not be called from a queued write.
+   \param timeout maximum time to wait in milliseconds.
+   \return false if the writes weren't committed in time or failed to commit.
+   */
+  bool Flush(unsigned int timeout = 30000);
+
+private:
+  CDatabaseWriter(const CDatabaseWriter&) = delete;
+  CDatabaseWriter& operator=(const CDatabaseWriter&) = delete;
+
+  struct SState;
+  static void Process(const std::shared_ptr<SState> &state);
+
+  // shared with the running job, which may outlive the writer
+  std::shared_ptr<SState> m_state;
+};
@@ -202,6 +202,17 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+void Dataset::load_result(const record_prop &header, const std::vector<sql_record> &records) {
+  close();
+  result.record_header = header;
+  result.records.reserve(records.size());
+  for (std::vector<sql_record>::const_iterator it = records.begin(); it != records.end(); ++it)
+    result.records.push_back(new sql_record(*it));
+  active = true;
+  ds_state = dsSelect;
+  first();
+}
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
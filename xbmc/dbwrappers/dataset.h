@@ -29,6 +29,7 @@
  **********************************************************************/
 
 #include <cstdio>
+#include <functional>
 #include <list>
 #include <map>
 #include <string>
@@ -70,6 +71,7 @@ protected:
     sequence_table, //Sequence table for nextid
     default_charset, //Default character set
     key, cert, ca, capath, ciphers; //SSL - Encryption info
+  std::function<void(const std::string &)> exec_observer; // notified of executed statements
 
 public:
 /* constructor */
@@ -165,6 +167,11 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* Sets a function called with every statement executed by a dataset of this connection */
+  void set_exec_observer(const std::function<void(const std::string &)> &observer) { exec_observer = observer; }
+/* Called by the datasets after a statement was executed */
+  void notify_exec(const std::string &sql) { if (exec_observer) exec_observer(sql); }
+
 };
 
 
@@ -308,6 +315,11 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but the rows may be fetched one by one while moving forward with
+   next(). Only the current row is held, so num_rows(), prev(), last(), seek()
+   and get_result_set() can't be used, and the connection can't run other
+   statements until all rows were read or the dataset was closed. */
+  virtual bool stream(const std::string &sql) { return query(sql); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -402,6 +414,8 @@ public:
 
 /* --------------- for fast access ---------------- */
   const result_set& get_result_set() { return result; }
+/* opens the dataset on rows that weren't queried by it, e.g. cached ones */
+  void load_result(const record_prop &header, const std::vector<sql_record> &records);
   const sql_record* const get_sql_record();
 
  private:
@@ -22,6 +22,8 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 
 #include "utils/log.h"
 #include "system.h" // for GetLastError()
@@ -511,10 +513,18 @@ void MysqlDatabase::start_transaction() {
 void MysqlDatabase::commit_transaction() {
   if (active)
   {
-    mysql_commit(conn);
+    // a failed commit is rolled back so the connection isn't left in the transaction
+    std::string err;
+    if (mysql_commit(conn) != 0)
+    {
+      err = mysql_error(conn);
+      mysql_rollback(conn);
+    }
     mysql_autocommit(conn, true);
     CLog::Log(LOGDEBUG,"Mysql commit transaction");
     _in_transaction = false;
+    if (!err.empty())
+      throw DbErrors("Mysql commit failed: %s", err.c_str());
   }
 }
 
@@ -1349,11 +1359,91 @@ char *MysqlDatabase::mysql_vmprintf(const char *zFormat, va_list ap) {
 
 //************* MysqlDataset implementation ***************
 
+// the flag type of MYSQL_BIND is my_bool in older client libraries and bool in newer ones
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type mysql_flag;
+
+// initial buffer for the text columns of a streamed row, longer values are fetched separately
+#define STREAM_TEXT_BUFFER 256
+
+struct MysqlDataset::StreamedResult
+{
+  struct Column
+  {
+    enum_field_types type;
+    std::vector<char> text;
+    long long integer;
+    double real;
+    unsigned long length;
+    mysql_flag isNull;
+    mysql_flag error;
+  };
+
+  MYSQL_STMT *stmt = NULL; // binary protocol
+  MYSQL_RES *res = NULL;   // text protocol, if the statement can't be prepared
+  std::vector<Column> columns;
+  std::vector<MYSQL_BIND> binds;
+
+  ~StreamedResult()
+  {
+    Release();
+  }
+
+  // gives the connection back, discarding the rows that weren't fetched
+  void Release()
+  {
+    if (stmt)
+      mysql_stmt_close(stmt);
+    if (res)
+      mysql_free_result(res);
+    stmt = NULL;
+    res = NULL;
+  }
+
+  void Bind()
+  {
+    binds.assign(columns.size(), MYSQL_BIND());
+    for (unsigned int i = 0; i < columns.size(); i++)
+    {
+      Column &column = columns[i];
+      MYSQL_BIND &bind = binds[i];
+      memset(&bind, 0, sizeof(bind));
+      switch (column.type)
+      {
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+          bind.buffer_type = MYSQL_TYPE_LONGLONG;
+          bind.buffer = &column.integer;
+          break;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+          bind.buffer_type = MYSQL_TYPE_DOUBLE;
+          bind.buffer = &column.real;
+          break;
+        default:
+          // decimals are sent as text anyway
+          if (column.text.empty())
+            column.text.resize(STREAM_TEXT_BUFFER);
+          bind.buffer_type = MYSQL_TYPE_STRING;
+          bind.buffer = &column.text[0];
+          bind.buffer_length = column.text.size();
+          break;
+      }
+      bind.length = &column.length;
+      bind.is_null = &column.isNull;
+      bind.error = &column.error;
+    }
+  }
+};
+
 MysqlDataset::MysqlDataset():Dataset() {
   haveError = false;
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  streamed = NULL;
 }
 
 MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
@@ -1361,9 +1451,11 @@ MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  streamed = NULL;
 }
 
 MysqlDataset::~MysqlDataset() {
+   delete streamed;
    if (errmsg) free(errmsg);
  }
 
@@ -1533,6 +1625,7 @@ int MysqlDataset::exec(const std::string &sql) {
   }
   else
   {
+    db->notify_exec(qry);
     //! @todo collect results and store in exec_res
     return res;
   }
@@ -1546,22 +1639,80 @@ const void* MysqlDataset::getExecRes() {
   return &exec_res;
 }
 
-bool MysqlDataset::query(const std::string &query) {
-  if(!handle()) throw DbErrors("No Database Connection");
+/* Sets a field from the text protocol representation of a value */
+static void set_text_value(field_value &v, enum_field_types type, const char *value)
+{
+  switch (type)
+  {
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+      if (value != NULL)
+      {
+        v.set_asInt(atoi(value));
+      }
+      else
+      {
+        v.set_asInt(0);
+      }
+      break;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      if (value != NULL)
+      {
+        v.set_asDouble(atof(value));
+      }
+      else
+      {
+        v.set_asDouble(0);
+      }
+      break;
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_NULL:
+    default:
+      CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", type);
+      v.set_asString("");
+      v.set_isNull();
+      break;
+  }
+}
+
+std::string MysqlDataset::prepare_select(const std::string &query) {
   std::string qry = query;
   int fs = qry.find("select");
   int fS = qry.find("SELECT");
   if (!( fs >= 0 || fS >=0))
     throw DbErrors("MUST be select SQL!");
 
-  close();
-
   size_t loc;
 
   // mysql doesn't understand CAST(foo as integer) => change to CAST(foo as signed integer)
   while ((loc = ci_find(qry, "as integer)")) != std::string::npos)
     qry = qry.insert(loc + 3, "signed ");
 
+  return qry;
+}
+
+bool MysqlDataset::query(const std::string &query) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  std::string qry = prepare_select(query);
+
+  close();
+
   MYSQL_RES *stmt = NULL;
 
   if ( static_cast<MysqlDatabase*>(db)->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK )
@@ -1586,56 +1737,7 @@ bool MysqlDataset::query(const std::string &query) {
     sql_record *res = new sql_record;
     res->resize(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (fields[i].type)
-      {
-        case MYSQL_TYPE_LONGLONG:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_NEWDECIMAL:
-        case MYSQL_TYPE_TINY:
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_INT24:
-        case MYSQL_TYPE_LONG:
-          if (row[i] != NULL)
-          {
-            v.set_asInt(atoi(row[i]));
-          }
-          else
-          {
-            v.set_asInt(0);
-          }
-          break;
-        case MYSQL_TYPE_FLOAT:
-        case MYSQL_TYPE_DOUBLE:
-          if (row[i] != NULL)
-          {
-            v.set_asDouble(atof(row[i]));
-          }
-          else
-          {
-            v.set_asDouble(0);
-          }
-          break;
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
-          break;
-        case MYSQL_TYPE_NULL:
-        default:
-          CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
-          break;
-      }
-    }
+      set_text_value(res->at(i), fields[i].type, row[i]);
     result.records.push_back(res);
   }
   mysql_free_result(stmt);
@@ -1645,6 +1747,152 @@ bool MysqlDataset::query(const std::string &query) {
   return true;
 }
 
+bool MysqlDataset::stream(const std::string &query) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  std::string qry = prepare_select(query);
+
+  close();
+
+  MYSQL* conn = handle();
+  StreamedResult *streamedResult = new StreamedResult;
+  MYSQL_RES *meta = NULL;
+
+  /* a prepared statement sends numbers in binary instead of as text, it
+     takes another round trip which doesn't matter for the results that are
+     worth streaming */
+  streamedResult->stmt = mysql_stmt_init(conn);
+  if (streamedResult->stmt &&
+      mysql_stmt_prepare(streamedResult->stmt, qry.c_str(), qry.size()) == 0 &&
+      mysql_stmt_execute(streamedResult->stmt) == 0)
+    meta = mysql_stmt_result_metadata(streamedResult->stmt);
+
+  if (meta == NULL)
+  {
+    // not every statement can be prepared, stream it as text instead
+    if (streamedResult->stmt)
+    {
+      CLog::Log(LOGDEBUG, "MYSQL: streaming %s as text: %s", qry.c_str(), mysql_stmt_error(streamedResult->stmt));
+      mysql_stmt_close(streamedResult->stmt);
+      streamedResult->stmt = NULL;
+    }
+
+    if (static_cast<MysqlDatabase*>(db)->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK)
+    {
+      delete streamedResult;
+      throw DbErrors(db->getErrorMsg());
+    }
+
+    streamedResult->res = mysql_use_result(handle());
+    if (streamedResult->res == NULL)
+    {
+      delete streamedResult;
+      throw DbErrors("Missing result set!");
+    }
+    meta = streamedResult->res;
+  }
+
+  // column headers
+  const unsigned int numColumns = mysql_num_fields(meta);
+  MYSQL_FIELD *fields = mysql_fetch_fields(meta);
+  result.record_header.resize(numColumns);
+  streamedResult->columns.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    result.record_header[i].name = fields[i].name;
+    streamedResult->columns[i].type = fields[i].type;
+  }
+
+  if (streamedResult->stmt)
+  {
+    mysql_free_result(meta);
+    streamedResult->Bind();
+    if (mysql_stmt_bind_result(streamedResult->stmt, &streamedResult->binds[0]) != 0)
+    {
+      std::string error = mysql_stmt_error(streamedResult->stmt);
+      delete streamedResult;
+      throw DbErrors(error.c_str());
+    }
+  }
+
+  // only the current row is kept
+  streamed = streamedResult;
+  result.records.push_back(new sql_record(numColumns));
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = feof = false;
+  next();
+  fbof = feof;
+  return true;
+}
+
+bool MysqlDataset::fetch_streamed_row() {
+  if (!streamed->stmt && !streamed->res)
+    return false;
+
+  sql_record &row = *result.records[0];
+  if (streamed->res)
+  {
+    MYSQL_ROW values = mysql_fetch_row(streamed->res);
+    if (values == NULL)
+    {
+      if (mysql_errno(handle()) != 0)
+        throw DbErrors(mysql_error(handle()));
+      return false;
+    }
+
+    for (unsigned int i = 0; i < row.size(); i++)
+      set_text_value(row[i], streamed->columns[i].type, values[i]);
+    return true;
+  }
+
+  int ret = mysql_stmt_fetch(streamed->stmt);
+  if (ret == MYSQL_NO_DATA)
+    return false;
+  if (ret != 0 && ret != MYSQL_DATA_TRUNCATED)
+    throw DbErrors(mysql_stmt_error(streamed->stmt));
+
+  bool rebind = false;
+  for (unsigned int i = 0; i < row.size(); i++)
+  {
+    StreamedResult::Column &column = streamed->columns[i];
+    MYSQL_BIND &bind = streamed->binds[i];
+    if (column.isNull)
+    {
+      set_text_value(row[i], column.type, NULL);
+      continue;
+    }
+
+    switch (bind.buffer_type)
+    {
+      case MYSQL_TYPE_LONGLONG:
+        row[i].set_asInt((int)column.integer);
+        break;
+      case MYSQL_TYPE_DOUBLE:
+        row[i].set_asDouble(column.real);
+        break;
+      default:
+        if (column.length >= column.text.size())
+        {
+          // fetch the rest of a long value and keep the larger buffer for the next rows
+          column.text.resize(column.length + 1);
+          bind.buffer = &column.text[0];
+          bind.buffer_length = column.text.size();
+          if (mysql_stmt_fetch_column(streamed->stmt, &bind, i, 0) != 0)
+            throw DbErrors(mysql_stmt_error(streamed->stmt));
+          rebind = true;
+        }
+        column.text[column.length] = '\0';
+        set_text_value(row[i], column.type, &column.text[0]);
+        break;
+    }
+  }
+
+  if (rebind && mysql_stmt_bind_result(streamed->stmt, &streamed->binds[0]) != 0)
+    throw DbErrors(mysql_stmt_error(streamed->stmt));
+  return true;
+}
+
 void MysqlDataset::open(const std::string &sql) {
    set_select_sql(sql);
    open();
@@ -1663,6 +1911,8 @@ void MysqlDataset::open() {
 
 void MysqlDataset::close() {
   Dataset::close();
+  delete streamed;
+  streamed = NULL;
   result.clear();
   edit_object->clear();
   fields_object->clear();
@@ -1693,6 +1943,10 @@ bool MysqlDataset::bof() {
 }
 
 void MysqlDataset::first() {
+  // a streamed query can't go back, it is at its first row after stream()
+  if (streamed)
+    return;
+
   Dataset::first();
   this->fill_fields();
 }
@@ -1708,6 +1962,20 @@ void MysqlDataset::prev(void) {
 }
 
 void MysqlDataset::next(void) {
+  if (streamed)
+  {
+    if (fetch_streamed_row())
+    {
+      fill_fields();
+      return;
+    }
+
+    // all rows were read, give the connection back
+    feof = true;
+    streamed->Release();
+    return;
+  }
+
   Dataset::next();
   if (!eof())
       fill_fields();
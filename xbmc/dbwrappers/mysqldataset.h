@@ -112,6 +112,15 @@ class MysqlDataset : public Dataset {
 protected:
   MYSQL* handle();
 
+/* rows of a streamed query that weren't fetched yet */
+  struct StreamedResult;
+  StreamedResult *streamed;
+
+/* Checks a select statement and rewrites what mysql doesn't understand */
+  std::string prepare_select(const std::string &query);
+/* Fetches the next row of a streamed query into the current row */
+  bool fetch_streamed_row();
+
 /* Makes direct queries to database */
   virtual void make_query(StringList &_sql);
 /* Makes direct inserts into database */
@@ -149,6 +158,9 @@ or insert() operations default = false) */
   virtual const void* getExecRes();
 /* as open, but with our query exept Sql */
   virtual bool query(const std::string &query);
+/* as query, but rows are fetched from the server while moving forward,
+   using the binary protocol of a server side prepared statement */
+  virtual bool stream(const std::string &query);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
@@ -83,7 +83,8 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
 
 static int busy_callback(void*, int busyCount)
 {
-  Sleep(100);
+  // retry quickly at first, most locks are held for a single short commit
+  Sleep(busyCount < 20 ? 5 * (busyCount / 4 + 1) : 100);
   return 1;
 }
 
@@ -403,8 +404,14 @@ void SqliteDatabase::start_transaction() {
 
 void SqliteDatabase::commit_transaction() {
   if (active) {
-    sqlite3_exec(conn,"commit",NULL,NULL,NULL);
+    int res = setErr(sqlite3_exec(conn,"commit",NULL,NULL,NULL),"commit");
     _in_transaction = false;
+    if (res != SQLITE_OK) {
+      // a failed commit is rolled back so the connection isn't left in the transaction
+      std::string err = getErrorMsg();
+      sqlite3_exec(conn,"rollback",NULL,NULL,NULL);
+      throw DbErrors(err.c_str());
+    }
   }
 }
 
@@ -624,7 +631,10 @@ int SqliteDataset::exec(const std::string &sql) {
   }
 
   if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
+  {
+    db->notify_exec(qry);
     return res;
+  }
   else
     {
       throw DbErrors(db->getErrorMsg());
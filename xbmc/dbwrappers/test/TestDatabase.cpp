@@ -0,0 +1,62 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/Database.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDatabase, GetSearchMatch)
+{
+  EXPECT_EQ("\"love\"*", CDatabase::GetSearchMatch("", "love", false));
+  EXPECT_EQ("\"love me\"*", CDatabase::GetSearchMatch("", "love me", false));
+  EXPECT_EQ("\"beyoncé\"*", CDatabase::GetSearchMatch("", "beyoncé", false));
+}
+
+TEST(TestDatabase, GetSearchMatchQuoting)
+{
+  // double quotes are doubled within the phrase, single quotes are left to PrepareSQL()
+  EXPECT_EQ("\"12\"\" single\"*", CDatabase::GetSearchMatch("", "12\" single", false));
+  EXPECT_EQ("\"\"\"quoted\"\"\"*", CDatabase::GetSearchMatch("", "\"quoted\"", false));
+  EXPECT_EQ("\"rock 'n' roll\"*", CDatabase::GetSearchMatch("", "rock 'n' roll", false));
+  EXPECT_EQ("\"a OR b NOT c\"*", CDatabase::GetSearchMatch("", "a OR b NOT c", false));
+}
+
+TEST(TestDatabase, GetSearchMatchFromStart)
+{
+  EXPECT_EQ("^\"love\"*", CDatabase::GetSearchMatch("", "love", true));
+  EXPECT_EQ("^\"\"\"love\"*", CDatabase::GetSearchMatch("", "\"love", true));
+}
+
+TEST(TestDatabase, GetSearchMatchColumns)
+{
+  EXPECT_EQ("{strTitle} : \"love\"*", CDatabase::GetSearchMatch("strTitle", "love", false));
+  EXPECT_EQ("{c00 c01} : \"love\"*", CDatabase::GetSearchMatch("c00 c01", "love", false));
+  EXPECT_EQ("{strTitle} : ^\"love\"*", CDatabase::GetSearchMatch("strTitle", "love", true));
+}
+
+TEST(TestDatabase, GetSearchMatchNoWords)
+{
+  // searches without anything to match fall back to LIKE
+  EXPECT_EQ("", CDatabase::GetSearchMatch("", "", false));
+  EXPECT_EQ("", CDatabase::GetSearchMatch("", "   ", true));
+  EXPECT_EQ("", CDatabase::GetSearchMatch("strTitle", "!?-", false));
+  EXPECT_EQ("", CDatabase::GetSearchMatch("", "\"", false));
+  EXPECT_EQ("\"-1-\"*", CDatabase::GetSearchMatch("", "-1-", false));
+}
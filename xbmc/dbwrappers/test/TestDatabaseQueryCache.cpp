@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/DatabaseQueryCache.h"
+#include "dbwrappers/sqlitedataset.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+typedef CDatabaseQueryCache::Tables Tables;
+
+class TestDatabaseQueryCache : public testing::Test
+{
+protected:
+  TestDatabaseQueryCache() : cache(1024 * 1024, 0)
+  {
+    std::vector<std::string> tables;
+    tables.push_back("song");
+    tables.push_back("album");
+    tables.push_back("artist");
+    tables.push_back("song_artist");
+    tables.push_back("artistsummary");
+
+    // songartistview is a view of a view
+    std::map<std::string, std::string> views;
+    views["songview"] = "CREATE VIEW songview AS SELECT song.*, album.strAlbum FROM song JOIN album ON album.idAlbum = song.idAlbum";
+    views["songartistview"] = "CREATE VIEW songartistview AS SELECT songview.*, artist.strArtist FROM songview "
+                              "JOIN song_artist ON song_artist.idSong = songview.idSong "
+                              "JOIN artist ON artist.idArtist = song_artist.idArtist";
+
+    // deleting a song deletes its links to artists, which updates the artist summary
+    std::multimap<std::string, std::string> triggers;
+    triggers.insert(std::make_pair("song", "CREATE TRIGGER tgrDeleteSong AFTER DELETE ON song FOR EACH ROW BEGIN "
+                                           "DELETE FROM song_artist WHERE idSong = old.idSong; END"));
+    triggers.insert(std::make_pair("song_artist", "CREATE TRIGGER tgrDeleteSongArtist AFTER DELETE ON song_artist FOR EACH ROW BEGIN "
+                                                  "UPDATE artistsummary SET iSongs = iSongs - 1 WHERE idArtist = old.idArtist; END"));
+
+    cache.SetSchema(tables, views, triggers);
+  }
+
+  Tables GetReadTables(const std::string &sql)
+  {
+    CDatabaseQueryCache::SQuery query;
+    cache.Lookup(sql, ds, query);
+
+    Tables tables;
+    for (std::vector<std::pair<std::string, uint64_t> >::const_iterator table = query.tables.begin(); table != query.tables.end(); ++table)
+      tables.insert(table->first);
+    return tables;
+  }
+
+  static Tables MakeTables(const char *table1, const char *table2 = NULL, const char *table3 = NULL, const char *table4 = NULL)
+  {
+    Tables tables;
+    const char *names[] = { table1, table2, table3, table4 };
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+      if (names[i] != NULL)
+        tables.insert(names[i]);
+    }
+    return tables;
+  }
+
+  CDatabaseQueryCache cache;
+  dbiplus::SqliteDataset ds;
+};
+
+TEST_F(TestDatabaseQueryCache, Normalize)
+{
+  EXPECT_EQ("select * from song where idsong = 1",
+            CDatabaseQueryCache::Normalize("  SELECT  *\n  FROM\tsong\r\nWHERE idSong = 1 "));
+  EXPECT_EQ("select * from song where strtitle = 'It''s  A Song'",
+            CDatabaseQueryCache::Normalize("SELECT * FROM song WHERE strTitle = 'It''s  A Song'"));
+  EXPECT_EQ(CDatabaseQueryCache::Normalize("select * from album"),
+            CDatabaseQueryCache::Normalize("SELECT *\nFROM Album"));
+  EXPECT_NE(CDatabaseQueryCache::Normalize("SELECT * FROM album WHERE strAlbum = 'a'"),
+            CDatabaseQueryCache::Normalize("SELECT * FROM album WHERE strAlbum = 'A'"));
+}
+
+TEST_F(TestDatabaseQueryCache, WrittenTables)
+{
+  EXPECT_EQ(MakeTables("album"), cache.Invalidate("INSERT INTO album (strAlbum) VALUES ('delete from artist')"));
+  EXPECT_EQ(MakeTables("album"), cache.Invalidate("REPLACE INTO album (idAlbum, strAlbum) VALUES (1, 'a')"));
+  EXPECT_EQ(MakeTables("artist"), cache.Invalidate("UPDATE artist SET strArtist = 'a' WHERE idArtist = 1"));
+  EXPECT_EQ(MakeTables("artist"), cache.Invalidate("UPDATE OR REPLACE artist SET strArtist = 'a' WHERE idArtist = 1"));
+  EXPECT_EQ(MakeTables("artist"), cache.Invalidate("DELETE FROM artist WHERE strArtist = 'update album'"));
+  EXPECT_EQ(MakeTables("album", "artist"), cache.Invalidate("INSERT INTO album (strAlbum) VALUES ('a;b'); DELETE FROM artist WHERE idArtist = 2"));
+  EXPECT_EQ(MakeTables("unknown"), cache.Invalidate("insert into unknown values (1)"));
+  EXPECT_TRUE(cache.Invalidate("SELECT * FROM album").empty());
+  EXPECT_TRUE(cache.HasSchema());
+
+  // schema changes drop the schema
+  EXPECT_TRUE(cache.Invalidate("CREATE TABLE genre (idGenre integer primary key)").empty());
+  EXPECT_FALSE(cache.HasSchema());
+}
+
+TEST_F(TestDatabaseQueryCache, TriggerFanOut)
+{
+  EXPECT_EQ(MakeTables("song", "song_artist", "artistsummary"), cache.Invalidate("DELETE FROM song WHERE idSong = 1"));
+  EXPECT_EQ(MakeTables("song_artist", "artistsummary"), cache.Invalidate("DELETE FROM song_artist WHERE idSong = 1"));
+  EXPECT_EQ(MakeTables("artistsummary"), cache.Invalidate("UPDATE artistsummary SET iSongs = 0"));
+}
+
+TEST_F(TestDatabaseQueryCache, ViewResolution)
+{
+  EXPECT_EQ(MakeTables("album"), GetReadTables("SELECT * FROM album WHERE strAlbum = 'song'"));
+  EXPECT_EQ(MakeTables("song", "album"), GetReadTables("SELECT * FROM songview WHERE idSong = 1"));
+  EXPECT_EQ(MakeTables("song", "album", "song_artist", "artist"), GetReadTables("SELECT * FROM songartistview"));
+  EXPECT_TRUE(GetReadTables("SELECT 1").empty());
+}
+
+TEST_F(TestDatabaseQueryCache, Invalidation)
+{
+  const std::string sql = "SELECT * FROM songview";
+  CDatabaseQueryCache::SQuery query;
+  EXPECT_FALSE(cache.Lookup(sql, ds, query));
+  EXPECT_TRUE(query.cacheable);
+  cache.Store(query, ds);
+  EXPECT_TRUE(cache.Lookup(sql, ds, query));
+
+  // writes to other tables keep the result
+  cache.Invalidate("UPDATE artist SET strArtist = 'a'");
+  EXPECT_TRUE(cache.Lookup(sql, ds, query));
+
+  // writes to a table of the view drop it
+  cache.Invalidate("UPDATE album SET strAlbum = 'a'");
+  EXPECT_FALSE(cache.Lookup(sql, ds, query));
+
+  CDatabaseQueryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(2U, stats.hits);
+  EXPECT_EQ(2U, stats.misses);
+  EXPECT_EQ(1U, stats.invalidations);
+  EXPECT_EQ(0U, stats.entries);
+}
+
+TEST_F(TestDatabaseQueryCache, WriteDuringQuery)
+{
+  const std::string sql = "SELECT * FROM songview";
+  CDatabaseQueryCache::SQuery query;
+  EXPECT_FALSE(cache.Lookup(sql, ds, query));
+
+  // a write committing while the query runs leaves its rows stale
+  cache.Invalidate("DELETE FROM song WHERE idSong = 1");
+  cache.Store(query, ds);
+  EXPECT_EQ(0U, cache.GetStats().entries);
+  EXPECT_FALSE(cache.Lookup(sql, ds, query));
+
+  cache.Store(query, ds);
+  EXPECT_EQ(1U, cache.GetStats().entries);
+  EXPECT_TRUE(cache.Lookup(sql, ds, query));
+
+  // so does a schema change
+  EXPECT_FALSE(cache.Lookup("SELECT * FROM album", ds, query));
+  cache.Invalidate("DROP VIEW songview");
+  cache.Store(query, ds);
+  EXPECT_EQ(0U, cache.GetStats().entries);
+}
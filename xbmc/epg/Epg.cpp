@@ -436,11 +436,12 @@ bool CEpg::UpdateEntry(const CEpgInfoTagPtr &tag, bool bUpdateDatabase /* = fals
       bNewTag = true;
     }
 
-    infoTag->Update(*tag, bNewTag);
+    bool bChanged = infoTag->Update(*tag, bNewTag) || bNewTag;
     infoTag->SetEpg(this);
     infoTag->SetPVRChannel(m_pvrChannel);
 
-    if (bUpdateDatabase)
+    /* only tags that actually changed need to be written again */
+    if (bUpdateDatabase && bChanged)
       m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
   }
 
@@ -608,30 +609,53 @@ bool CEpg::Persist(void)
 
   {
     CSingleLock lock(m_critSection);
-    if (m_iEpgID <= 0 || m_bChanged)
-    {
-      int iId = database->Persist(*this, m_iEpgID > 0);
-      if (iId > 0)
-        m_iEpgID = iId;
-    }
+    if (!QueuePersistQuery(*database))
+      return false;
+  }
 
-    for (std::map<int, CEpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+  return database->CommitInsertQueries();
+}
 
-    for (std::map<int, CEpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+bool CEpg::QueuePersistQuery(CEpgDatabase &database)
+{
+  if (m_iEpgID <= 0 || m_bChanged)
+  {
+    int iId = database.Persist(*this, m_iEpgID > 0);
+    if (iId > 0)
+      m_iEpgID = iId;
+  }
 
-    if (m_bUpdateLastScanTime)
-      database->PersistLastEpgScanTime(m_iEpgID, true);
+  if (!m_deletedTags.empty())
+  {
+    std::vector<CEpgInfoTagPtr> deletedTags;
+    deletedTags.reserve(m_deletedTags.size());
+    for (const auto &tag : m_deletedTags)
+      deletedTags.push_back(tag.second);
 
-    m_deletedTags.clear();
-    m_changedTags.clear();
-    m_bChanged            = false;
-    m_bTagsChanged        = false;
-    m_bUpdateLastScanTime = false;
+    database.Delete(deletedTags);
   }
 
-  return database->CommitInsertQueries();
+  if (!m_changedTags.empty())
+  {
+    std::vector<CEpgInfoTagPtr> changedTags;
+    changedTags.reserve(m_changedTags.size());
+    for (const auto &tag : m_changedTags)
+      changedTags.push_back(tag.second);
+
+    if (!database.Persist(changedTags))
+      return false;
+  }
+
+  if (m_bUpdateLastScanTime)
+    database.PersistLastEpgScanTime(m_iEpgID, true);
+
+  m_deletedTags.clear();
+  m_changedTags.clear();
+  m_bChanged            = false;
+  m_bTagsChanged        = false;
+  m_bUpdateLastScanTime = false;
+
+  return true;
 }
 
 CDateTime CEpg::GetFirstDate(void) const
@@ -872,6 +896,19 @@ size_t CEpg::Size(void) const
   return m_tags.size();
 }
 
+size_t CEpg::GetMemoryUsage(void) const
+{
+  /* std::map nodes carry three pointers and a color next to the value */
+  static const size_t iNodeOverhead = 4 * sizeof(void*);
+
+  CSingleLock lock(m_critSection);
+  size_t iSize = sizeof(*this);
+  for (const auto &tag : m_tags)
+    iSize += iNodeOverhead + sizeof(tag) + tag.second->GetMemoryUsage();
+
+  return iSize;
+}
+
 bool CEpg::NeedsSave(void) const
 {
   CSingleLock lock(m_critSection);
@@ -38,6 +38,7 @@ namespace PVR
 namespace EPG
 {
   class CEpg;
+  class CEpgDatabase;
   typedef std::shared_ptr<CEpg> CEpgPtr;
   typedef std::map<unsigned int, CEpgPtr> EPGMAP;
 
@@ -279,6 +280,12 @@ namespace EPG
 
     size_t Size(void) const;
 
+    /*!
+     * @brief Get the approximate amount of memory used by this table's entries, excluding interned strings.
+     * @return The memory usage in bytes.
+     */
+    size_t GetMemoryUsage(void) const;
+
     bool NeedsSave(void) const;
 
     /*!
@@ -327,6 +334,13 @@ namespace EPG
      */
     bool UpdateEntries(const CEpg &epg, bool bStoreInDb = true);
 
+    /*!
+     * @brief Queue the queries needed to persist the pending changes of this table.
+     * @param database The database to queue the queries on. The caller has to commit them.
+     * @return True if the queries were queued successfully, false otherwise.
+     */
+    bool QueuePersistQuery(CEpgDatabase &database);
+
     std::map<CDateTime, CEpgInfoTagPtr> m_tags;
     std::map<int, CEpgInfoTagPtr>       m_changedTags;
     std::map<int, CEpgInfoTagPtr>       m_deletedTags;
@@ -36,6 +36,7 @@
 #include "settings/lib/Setting.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 
@@ -292,19 +293,19 @@ void CEpgContainer::LoadFromDB(void)
 
 bool CEpgContainer::PersistAll(void)
 {
-  bool bReturn(true);
+  if (m_bIgnoreDbForClient || !m_database.IsOpen())
+    return true;
+
   m_critSection.lock();
   auto copy = m_epgs;
   m_critSection.unlock();
 
-  for (EPGMAP::const_iterator it = copy.begin(); it != copy.end() && !m_bStop; ++it)
-  {
-    CEpgPtr epg = it->second;
-    if (epg && epg->NeedsSave())
-    {
-      bReturn &= epg->Persist();
-    }
-  }
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+
+  /* all pending changes of all tables are written in a single transaction */
+  bool bReturn = m_database.Persist(copy);
+
+  CLog::Log(LOGDEBUG, "EPG - %s - persisted %u tables in %u ms", __FUNCTION__, (unsigned int) copy.size(), XbmcThreads::SystemClockMillis() - iStart);
 
   return bReturn;
 }
@@ -534,12 +535,31 @@ bool CEpgContainer::RemoveOldEntries(void)
   if (!m_bIgnoreDbForClient && m_database.IsOpen())
     m_database.DeleteEpgEntries(cleanupTime);
 
+  /* drop the interned strings that were only used by the removed entries */
+  CInternPool<std::string>::GetInstance().Cleanup();
+  CInternPool<std::vector<std::string> >::GetInstance().Cleanup();
+
   CSingleLock lock(m_critSection);
   CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(m_iLastEpgCleanup);
 
   return true;
 }
 
+size_t CEpgContainer::GetMemoryUsage(void)
+{
+  m_critSection.lock();
+  auto copy = m_epgs;
+  m_critSection.unlock();
+
+  size_t iSize = CInternPool<std::string>::GetInstance().GetMemoryUsage() +
+                 CInternPool<std::vector<std::string> >::GetInstance().GetMemoryUsage();
+
+  for (const auto &epgEntry : copy)
+    iSize += epgEntry.second->GetMemoryUsage();
+
+  return iSize;
+}
+
 bool CEpgContainer::DeleteEpg(const CEpg &epg, bool bDeleteFromDatabase /* = false */)
 {
   if (epg.EpgID() < 0)
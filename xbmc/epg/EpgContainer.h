@@ -232,6 +232,12 @@ namespace EPG
      */
     void UpdateRequest(int clientID, unsigned int channelID);
 
+    /*!
+     * @brief Get the approximate amount of memory used by all tables and their entries.
+     * @return The memory usage in bytes.
+     */
+    size_t GetMemoryUsage(void);
+
   protected:
     /*!
      * @brief Load the EPG settings.
@@ -18,12 +18,14 @@
  *
  */
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "system.h"
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "dbwrappers/dataset.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 
@@ -33,6 +35,14 @@
 using namespace dbiplus;
 using namespace EPG;
 
+#define EPG_TAGS_COLUMNS "idEpg, iStartTime, " \
+    "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, " \
+    "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, " \
+    "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid"
+
+/* keep multi-row queries well below the compound limits of sqlite and the packet size limit of mysql */
+#define EPG_TAGS_ROWS_PER_QUERY 100
+
 bool CEpgDatabase::Open(void)
 {
   return CDatabase::Open(g_advancedSettings.m_databaseEpg);
@@ -172,6 +182,23 @@ bool CEpgDatabase::Delete(const CEpgInfoTag &tag)
   return DeleteValues("epgtags", filter);
 }
 
+bool CEpgDatabase::Delete(const std::vector<CEpgInfoTagPtr> &tags)
+{
+  std::vector<std::string> ids;
+  for (const auto &tag : tags)
+  {
+    /* tag without a database ID was not persisted */
+    if (tag->BroadcastId() > 0)
+      ids.push_back(StringUtils::Format("%i", tag->BroadcastId()));
+  }
+
+  if (ids.empty())
+    return true;
+
+  /* queued with the inserts so that all changes end up in the same transaction */
+  return QueueInsertQuery(PrepareSQL("DELETE FROM epgtags WHERE idBroadcast IN (%s)", StringUtils::Join(ids, ",").c_str()));
+}
+
 int CEpgDatabase::Get(CEpgContainer &container)
 {
   int iReturn(-1);
@@ -304,8 +331,11 @@ bool CEpgDatabase::Persist(const EPGMAP &epgs)
 {
   for (const auto &epgEntry : epgs)
   {
-    if (epgEntry.second)
-      Persist(*epgEntry.second, true);
+    if (epgEntry.second && epgEntry.second->NeedsSave())
+    {
+      CSingleLock lock(epgEntry.second->m_critSection);
+      epgEntry.second->QueuePersistQuery(*this);
+    }
   }
 
   return CommitInsertQueries();
@@ -337,57 +367,46 @@ int CEpgDatabase::Persist(const CEpg &epg, bool bQueueWrite /* = false */)
   return iReturn;
 }
 
-int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true */)
+std::string CEpgDatabase::GetTagValues(const CEpgInfoTag &tag, bool bWithBroadcastId)
 {
-  int iReturn(-1);
-
-  if (tag.EpgID() <= 0)
-  {
-    CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag.Title(true).c_str());
-    return iReturn;
-  }
-
   time_t iStartTime, iEndTime, iFirstAired;
   tag.StartAsUTC().GetAsTime(iStartTime);
   tag.EndAsUTC().GetAsTime(iEndTime);
   tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
 
-  int iBroadcastId = tag.BroadcastId();
-  std::string strQuery;
-
   /* Only store the genre string when needed */
   std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? StringUtils::Join(tag.Genre(), g_advancedSettings.m_videoItemSeparator) : "";
 
-  if (iBroadcastId < 0)
+  std::string strValues = PrepareSQL("(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i",
+      tag.EpgID(), iStartTime, iEndTime,
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+      tag.OriginalTitle(true).c_str(), tag.Cast().c_str(), tag.Director().c_str(), tag.Writer().c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(),
+      tag.UniqueBroadcastID());
+
+  if (bWithBroadcastId)
+    strValues += PrepareSQL(", %i", tag.BroadcastId());
+
+  return strValues + ")";
+}
+
+int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true */)
+{
+  int iReturn(-1);
+
+  if (tag.EpgID() <= 0)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.Cast().c_str(), tag.Director().c_str(), tag.Writer().c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(),
-        tag.UniqueBroadcastID());
+    CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag.Title(true).c_str());
+    return iReturn;
   }
+
+  std::string strQuery;
+  if (tag.BroadcastId() < 0)
+    strQuery = "REPLACE INTO epgtags (" EPG_TAGS_COLUMNS ") VALUES " + GetTagValues(tag, false) + ";";
   else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.Cast().c_str(), tag.Director().c_str(), tag.Writer().c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName().c_str(), tag.Flags(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+    strQuery = "REPLACE INTO epgtags (" EPG_TAGS_COLUMNS ", idBroadcast) VALUES " + GetTagValues(tag, true) + ";";
 
   if (bSingleUpdate)
   {
@@ -403,6 +422,40 @@ int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true *
   return iReturn;
 }
 
+bool CEpgDatabase::Persist(const std::vector<CEpgInfoTagPtr> &tags)
+{
+  /* new tags get their database ID assigned by the database, so they need a separate column list */
+  std::vector<std::string> newTags, existingTags;
+  for (const auto &tag : tags)
+  {
+    if (tag->EpgID() <= 0)
+    {
+      CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag->Title(true).c_str());
+      continue;
+    }
+
+    if (tag->BroadcastId() < 0)
+      newTags.push_back(GetTagValues(*tag, false));
+    else
+      existingTags.push_back(GetTagValues(*tag, true));
+  }
+
+  bool bReturn(true);
+  for (size_t i = 0; i < newTags.size(); i += EPG_TAGS_ROWS_PER_QUERY)
+  {
+    std::vector<std::string> rows(newTags.begin() + i, newTags.begin() + std::min(newTags.size(), i + EPG_TAGS_ROWS_PER_QUERY));
+    bReturn &= QueueInsertQuery("REPLACE INTO epgtags (" EPG_TAGS_COLUMNS ") VALUES " + StringUtils::Join(rows, ", ") + ";");
+  }
+
+  for (size_t i = 0; i < existingTags.size(); i += EPG_TAGS_ROWS_PER_QUERY)
+  {
+    std::vector<std::string> rows(existingTags.begin() + i, existingTags.begin() + std::min(existingTags.size(), i + EPG_TAGS_ROWS_PER_QUERY));
+    bReturn &= QueueInsertQuery("REPLACE INTO epgtags (" EPG_TAGS_COLUMNS ", idBroadcast) VALUES " + StringUtils::Join(rows, ", ") + ";");
+  }
+
+  return bReturn;
+}
+
 int CEpgDatabase::GetLastEPGId(void)
 {
   std::string strQuery = PrepareSQL("SELECT MAX(idEpg) FROM epg");
@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "XBDateTime.h"
 #include "dbwrappers/Database.h"
@@ -97,6 +98,13 @@ namespace EPG
      */
     virtual bool Delete(const CEpgInfoTag &tag);
 
+    /*!
+     * @brief Queue the removal of a set of EPG entries.
+     * @param tags The entries to remove.
+     * @return True if the query was queued successfully, false otherwise.
+     */
+    bool Delete(const std::vector<CEpgInfoTagPtr> &tags);
+
     /*!
      * @brief Get all EPG tables from the database. Does not get the EPG tables' entries.
      * @param container The container to fill.
@@ -127,6 +135,11 @@ namespace EPG
      */
     virtual bool PersistLastEpgScanTime(int iEpgId = 0, bool bQueueWrite = false);
 
+    /*!
+     * @brief Persist the pending changes of all given EPG tables in a single transaction.
+     * @param epgs The tables to persist. Tables without pending changes are skipped.
+     * @return True if the tables were persisted successfully, false otherwise.
+     */
     bool Persist(const EPGMAP &epgs);
 
     /*!
@@ -145,6 +158,13 @@ namespace EPG
      */
     virtual int Persist(const CEpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Queue a set of infotags using multi-row REPLACE queries.
+     * @param tags The tags to persist.
+     * @return True if the queries were queued successfully, false otherwise.
+     */
+    bool Persist(const std::vector<CEpgInfoTagPtr> &tags);
+
     /*!
      * @return Last EPG id in the database
      */
@@ -169,5 +189,14 @@ namespace EPG
      */
     virtual void UpdateTables(int version);
     virtual int GetMinSchemaVersion() const { return 4; }
+
+  private:
+    /*!
+     * @brief Get the column values of an infotag formatted for a REPLACE query.
+     * @param tag The tag to get the values for.
+     * @param bWithBroadcastId True to include the database ID of the tag.
+     * @return The values, enclosed in parentheses.
+     */
+    std::string GetTagValues(const CEpgInfoTag &tag, bool bWithBroadcastId);
   };
 }
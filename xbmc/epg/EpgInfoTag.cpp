@@ -76,7 +76,6 @@ CEpgInfoTag::CEpgInfoTag(CEpg *epg, PVR::CPVRChannelPtr pvrChannel, const std::s
     m_iFlags(EPG_TAG_FLAG_UNDEFINED),
     m_pvrChannel(pvrChannel)
 {
-  UpdatePath();
 }
 
 CEpgInfoTag::CEpgInfoTag(const EPG_TAG &data) :
@@ -128,8 +127,6 @@ CEpgInfoTag::CEpgInfoTag(const EPG_TAG &data) :
     m_strEpisodeName = data.strEpisodeName;
   if (data.strIconPath)
     m_strIconPath = data.strIconPath;
-
-  UpdatePath();
 }
 
 CEpgInfoTag::~CEpgInfoTag()
@@ -169,7 +166,6 @@ bool CEpgInfoTag::operator ==(const CEpgInfoTag& right) const
           m_genre              == right.m_genre &&
           m_strEpisodeName     == right.m_strEpisodeName &&
           m_strIconPath        == right.m_strIconPath &&
-          m_strFileNameAndPath == right.m_strFileNameAndPath &&
           m_startTime          == right.m_startTime &&
           m_endTime            == right.m_endTime &&
           m_iFlags             == right.m_iFlags);
@@ -192,13 +188,13 @@ void CEpgInfoTag::Serialize(CVariant &value) const
   value["plotoutline"] = m_strPlotOutline;
   value["plot"] = m_strPlot;
   value["originaltitle"] = m_strOriginalTitle;
-  value["cast"] = m_strCast;
-  value["director"] = m_strDirector;
-  value["writer"] = m_strWriter;
+  value["cast"] = m_strCast.Get();
+  value["director"] = m_strDirector.Get();
+  value["writer"] = m_strWriter.Get();
   value["year"] = m_iYear;
   value["imdbnumber"] = m_strIMDBNumber;
-  value["genre"] = m_genre;
-  value["filenameandpath"] = m_strFileNameAndPath;
+  value["genre"] = m_genre.Get();
+  value["filenameandpath"] = Path();
   value["starttime"] = m_startTime.IsValid() ? m_startTime.GetAsDBDateTime() : StringUtils::Empty;
   value["endtime"] = m_endTime.IsValid() ? m_endTime.GetAsDBDateTime() : StringUtils::Empty;
   value["runtime"] = GetDuration() / 60;
@@ -509,7 +505,8 @@ std::string CEpgInfoTag::Icon(void) const
 
 std::string CEpgInfoTag::Path(void) const
 {
-  return m_strFileNameAndPath;
+  /* derived from the table and start time rather than stored, to keep tags small */
+  return StringUtils::Format("pvr://guide/%04i/%s.epg", EpgID(), m_startTime.GetAsDBDateTime().c_str());
 }
 
 bool CEpgInfoTag::HasTimer(void) const
@@ -653,12 +650,20 @@ bool CEpgInfoTag::Update(const CEpgInfoTag &tag, bool bUpdateBroadcastId /* = tr
       m_strIconPath        = tag.m_strIconPath;
     }
   }
-  if (bChanged)
-    UpdatePath();
-
   return bChanged;
 }
 
+size_t CEpgInfoTag::GetMemoryUsage() const
+{
+  return sizeof(*this) +
+         m_strTitle.capacity() +
+         m_strPlotOutline.capacity() +
+         m_strPlot.capacity() +
+         m_strOriginalTitle.capacity() +
+         m_strIMDBNumber.capacity() +
+         m_strEpisodeName.capacity();
+}
+
 bool CEpgInfoTag::Persist(bool bSingleUpdate /* = true */)
 {
   bool bReturn = false;
@@ -686,11 +691,6 @@ bool CEpgInfoTag::Persist(bool bSingleUpdate /* = true */)
   return bReturn;
 }
 
-void CEpgInfoTag::UpdatePath(void)
-{
-  m_strFileNameAndPath = StringUtils::Format("pvr://guide/%04i/%s.epg", EpgID(), m_startTime.GetAsDBDateTime().c_str());
-}
-
 const CEpg *CEpgInfoTag::GetTable() const
 {
   return m_epg;
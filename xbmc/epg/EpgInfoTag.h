@@ -27,6 +27,7 @@
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
+#include "utils/InternPool.h"
 #include "utils/ISerializable.h"
 
 #define EPG_DEBUGGING 0
@@ -404,6 +405,12 @@ namespace EPG
      */
     bool IsSeries() const;
 
+    /*!
+     * @brief Get the approximate amount of memory used by this tag, excluding interned strings.
+     * @return The memory usage in bytes.
+     */
+    size_t GetMemoryUsage() const;
+
   private:
 
     /*!
@@ -413,11 +420,6 @@ namespace EPG
      */
     void SetGenre(int iGenreType, int iGenreSubType, const char* strGenre);
 
-    /*!
-     * @brief Hook that is called when the start date changed.
-     */
-    void UpdatePath(void);
-
     /*!
      * @brief Get current time, taking timeshifting into account.
      */
@@ -443,15 +445,14 @@ namespace EPG
     std::string              m_strPlotOutline;     /*!< plot outline */
     std::string              m_strPlot;            /*!< plot */
     std::string              m_strOriginalTitle;   /*!< original title */
-    std::string              m_strCast;            /*!< cast */
-    std::string              m_strDirector;        /*!< director */
-    std::string              m_strWriter;          /*!< writer */
+    CInterned<std::string>   m_strCast;            /*!< cast */
+    CInterned<std::string>   m_strDirector;        /*!< director */
+    CInterned<std::string>   m_strWriter;          /*!< writer */
     int                      m_iYear;              /*!< year */
     std::string              m_strIMDBNumber;      /*!< imdb number */
-    std::vector<std::string> m_genre;              /*!< genre */
+    CInterned<std::vector<std::string> > m_genre;  /*!< genre */
     std::string              m_strEpisodeName;     /*!< episode name */
-    std::string              m_strIconPath;        /*!< the path to the icon */
-    std::string              m_strFileNameAndPath; /*!< the filename and path */
+    CInterned<std::string>   m_strIconPath;        /*!< the path to the icon */
     CDateTime                m_startTime;          /*!< event start time */
     CDateTime                m_endTime;            /*!< event end time */
     CDateTime                m_firstAired;         /*!< first airdate */
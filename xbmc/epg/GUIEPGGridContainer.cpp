@@ -1661,6 +1661,12 @@ void CGUIEPGGridContainer::HandleChannels(bool bRender, unsigned int currentTime
     // Free memory not used on screen
     if (m_gridModel->ChannelItemsSize() > m_channelsPerPage + cacheBeforeChannel + cacheAfterChannel)
       m_gridModel->FreeChannelMemory(chanOffset - cacheBeforeChannel, chanOffset + m_channelsPerPage + 1 + cacheAfterChannel);
+
+    // Drop grid rows that are more than a page away from the visible channels. The row
+    // of the selected channel must always be kept, as m_item points into it.
+    const int selectedChannel = m_channelOffset + m_channelCursor;
+    m_gridModel->FreeGridMemory(std::min(chanOffset - cacheBeforeChannel - m_channelsPerPage, selectedChannel),
+                                std::max(chanOffset + 2 * m_channelsPerPage + 1 + cacheAfterChannel, selectedChannel));
   }
 
   CPoint originChannel = CPoint(m_channelPosX, m_channelPosY) + m_renderOffset;
@@ -45,12 +45,11 @@ void CGUIEPGGridContainerModel::Reset()
 {
   for (auto &channel : m_gridIndex)
   {
-    for (const auto &block : channel)
+    for (const auto &block : channel.second)
     {
       if (block.item)
         block.item->ClearProperties();
     }
-    channel.clear();
   }
   m_gridIndex.clear();
 
@@ -149,8 +148,7 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
   FreeItemsMemory();
 
   ////////////////////////////////////////////////////////////////////////
-  // Create epg grid
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  // Create epg grid. The blocks of a channel are calculated on first access, see GetGridRow.
   const CDateTimeSpan gridDuration(m_gridEnd - m_gridStart);
   m_blocks = (gridDuration.GetDays() * 24 * 60 + gridDuration.GetHours() * 60 + gridDuration.GetMinutes()) / MINSPERBLOCK;
   if (m_blocks >= MAXBLOCKS)
@@ -158,108 +156,118 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
   else if (m_blocks < iBlocksPerPage)
     m_blocks = iBlocksPerPage;
 
-  m_gridIndex.reserve(m_channelItems.size());
-  const std::vector<GridItem> blocks(m_blocks);
+  m_fBlockSize = fBlockSize;
+}
 
-  for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
+std::vector<GridItem> &CGUIEPGGridContainerModel::GetGridRow(int iChannel) const
+{
+  auto it = m_gridIndex.find(iChannel);
+  if (it == m_gridIndex.end())
   {
-    m_gridIndex.emplace_back(blocks);
+    it = m_gridIndex.insert(std::make_pair(iChannel, std::vector<GridItem>(m_blocks))).first;
+    CalculateGridRow(iChannel, it->second);
+  }
+  return it->second;
+}
 
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[channel].start;
-    unsigned long lastIdx = m_epgItemsPtr[channel].stop;
-    int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    int itemSize          = 1; // size of the programme in blocks
-    int savedBlock        = 0;
-    CFileItemPtr item;
-    CEpgInfoTagPtr tag;
+void CGUIEPGGridContainerModel::CalculateGridRow(int channel, std::vector<GridItem> &blocks) const
+{
+  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
 
-    for (int block = 0; block < m_blocks; ++block)
-    {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
+  CDateTime gridCursor(m_gridStart);
+  unsigned long progIdx = m_epgItemsPtr[channel].start;
+  unsigned long lastIdx = m_epgItemsPtr[channel].stop;
+  int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
+  int itemSize          = 1; // size of the programme in blocks
+  int savedBlock        = 0;
+  CFileItemPtr item;
+  CEpgInfoTagPtr tag;
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
+  for (int block = 0; block < m_blocks; ++block)
+  {
+    while (progIdx <= lastIdx)
+    {
+      item = m_programmeItems[progIdx];
+      tag = item->GetEPGInfoTag();
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
+      if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
+        break;
 
-        progIdx++;
+      if (gridCursor < tag->EndAsUTC())
+      {
+        blocks[block].item = item;
+        blocks[block].progIndex = progIdx;
+        break;
       }
 
-      gridCursor += blockDuration;
+      progIdx++;
+    }
 
-      if (block == 0)
-        continue;
+    gridCursor += blockDuration;
+
+    if (block == 0)
+      continue;
 
-      const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
-      const CFileItemPtr currItem(m_gridIndex[channel][block].item);
+    const CFileItemPtr prevItem(blocks[block - 1].item);
+    const CFileItemPtr currItem(blocks[block].item);
 
-      if (block == m_blocks - 1 || prevItem != currItem)
+    if (block == m_blocks - 1 || prevItem != currItem)
+    {
+      // special handling for last block.
+      int blockDelta = -1;
+      int sizeDelta = 0;
+      if (block == m_blocks - 1 && prevItem == currItem)
       {
-        // special handling for last block.
-        int blockDelta = -1;
-        int sizeDelta = 0;
-        if (block == m_blocks - 1 && prevItem == currItem)
+        itemSize++;
+        blockDelta = 0;
+        sizeDelta = 1;
+      }
+
+      if (prevItem)
+      {
+        blocks[savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+      }
+      else
+      {
+        CEpgInfoTagPtr gapTag(CEpgInfoTag::CreateDefaultTag());
+        gapTag->SetPVRChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
+        CFileItemPtr gapItem(new CFileItem(gapTag));
+        for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
         {
-          itemSize++;
-          blockDelta = 0;
-          sizeDelta = 1;
+          blocks[i].item = gapItem;
         }
+      }
+
+      float fItemWidth = itemSize * m_fBlockSize;
+      blocks[savedBlock].originWidth = fItemWidth;
+      blocks[savedBlock].width = fItemWidth;
 
-        if (prevItem)
+      itemSize = 1;
+      savedBlock = block;
+
+      // special handling for last block.
+      if (block == m_blocks - 1 && prevItem != currItem)
+      {
+        if (currItem)
         {
-          m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+          blocks[savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
         }
         else
         {
           CEpgInfoTagPtr gapTag(CEpgInfoTag::CreateDefaultTag());
           gapTag->SetPVRChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
           CFileItemPtr gapItem(new CFileItem(gapTag));
-          for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
-          {
-            m_gridIndex[channel][i].item = gapItem;
-          }
+          blocks[block].item = gapItem;
         }
 
-        float fItemWidth = itemSize * fBlockSize;
-        m_gridIndex[channel][savedBlock].originWidth = fItemWidth;
-        m_gridIndex[channel][savedBlock].width = fItemWidth;
-
-        itemSize = 1;
-        savedBlock = block;
-
-        // special handling for last block.
-        if (block == m_blocks - 1 && prevItem != currItem)
-        {
-          if (currItem)
-          {
-            m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
-          }
-          else
-          {
-            CEpgInfoTagPtr gapTag(CEpgInfoTag::CreateDefaultTag());
-            gapTag->SetPVRChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
-            CFileItemPtr gapItem(new CFileItem(gapTag));
-            m_gridIndex[channel][block].item = gapItem;
-          }
-
-          m_gridIndex[channel][savedBlock].originWidth = fBlockSize; // size always 1 block here
-          m_gridIndex[channel][savedBlock].width = fBlockSize;
-        }
-      }
-      else
-      {
-        itemSize++;
+        blocks[savedBlock].originWidth = m_fBlockSize; // size always 1 block here
+        blocks[savedBlock].width = m_fBlockSize;
       }
     }
+    else
+    {
+      itemSize++;
+    }
   }
 }
 
@@ -334,37 +342,39 @@ void CGUIEPGGridContainerModel::FreeProgrammeMemory(int channel, int keepStart,
 {
   if (keepStart < keepEnd)
   {
+    std::vector<GridItem> &blocks = GetGridRow(channel);
+
     // remove before keepStart and after keepEnd
     if (keepStart > 0 && keepStart < m_blocks)
     {
       // if item exist and block is not part of visible item
-      CGUIListItemPtr last(m_gridIndex[channel][keepStart].item);
+      CGUIListItemPtr last(blocks[keepStart].item);
       for (int i = keepStart - 1; i > 0; --i)
       {
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (blocks[i].item && blocks[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          blocks[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that ocupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = blocks[i].item;
         }
       }
     }
 
     if (keepEnd > 0 && keepEnd < m_blocks)
     {
-      CGUIListItemPtr last(m_gridIndex[channel][keepEnd].item);
+      CGUIListItemPtr last(blocks[keepEnd].item);
       for (int i = keepEnd + 1; i < m_blocks; ++i)
       {
         // if item exist and block is not part of visible item
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (blocks[i].item && blocks[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          blocks[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that ocupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = blocks[i].item;
         }
       }
     }
@@ -394,6 +404,20 @@ void CGUIEPGGridContainerModel::FreeRulerMemory(int keepStart, int keepEnd)
   }
 }
 
+void CGUIEPGGridContainerModel::FreeGridMemory(int keepStart, int keepEnd)
+{
+  if (keepStart >= keepEnd)
+    return; // wrapping, keep everything
+
+  for (auto it = m_gridIndex.begin(); it != m_gridIndex.end();)
+  {
+    if (it->first < keepStart || it->first > keepEnd)
+      it = m_gridIndex.erase(it);
+    else
+      ++it;
+  }
+}
+
 void CGUIEPGGridContainerModel::FreeItemsMemory()
 {
   for (const auto &programme : m_programmeItems)
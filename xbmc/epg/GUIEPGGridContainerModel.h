@@ -20,6 +20,7 @@
  */
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "XBDateTime.h"
@@ -48,7 +49,7 @@ namespace EPG
     static const int MAXBLOCKS          = 33 * 24 * 60 / MINSPERBLOCK; //! 33 days of 5 minute blocks (31 days for upcoming data + 1 day for past data + 1 day for fillers)
     static const int GRID_START_PADDING = 30; // minutes; latest grid start 'now - GRID_START_PADDING', will be adjusted to this value if shall be set to later
 
-    CGUIEPGGridContainerModel() : m_blocks(0) {}
+    CGUIEPGGridContainerModel() : m_blocks(0), m_fBlockSize(0.0f) {}
     virtual ~CGUIEPGGridContainerModel() { Reset(); }
 
     void Refresh(const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart, const CDateTime &gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize);
@@ -60,6 +61,13 @@ namespace EPG
     void FreeProgrammeMemory(int channel, int keepStart, int keepEnd);
     void FreeRulerMemory(int keepStart, int keepEnd);
 
+    /*!
+     * @brief Drop the calculated grid rows of all channels outside the given range.
+     * @param keepStart The first channel to keep.
+     * @param keepEnd The last channel to keep.
+     */
+    void FreeGridMemory(int keepStart, int keepEnd);
+
     CFileItemPtr GetProgrammeItem(int iIndex) const { return m_programmeItems[iIndex]; }
     bool HasProgrammeItems() const { return !m_programmeItems.empty(); }
     int ProgrammeItemsSize() const { return static_cast<int>(m_programmeItems.size()); }
@@ -72,13 +80,13 @@ namespace EPG
     int RulerItemsSize() const { return static_cast<int>(m_rulerItems.size()); }
 
     int GetBlockCount() const { return m_blocks; }
-    bool HasGridItems() const { return !m_gridIndex.empty(); }
-    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &m_gridIndex[iChannel][iBlock]; }
-    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].item; }
-    float GetGridItemWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].width; }
-    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].originWidth; }
-    int GetGridItemIndex(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].progIndex; }
-    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { m_gridIndex[iChannel][iBlock].width = fWidth; }
+    bool HasGridItems() const { return m_blocks > 0 && !m_channelItems.empty(); }
+    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &GetGridRow(iChannel)[iBlock]; }
+    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].item; }
+    float GetGridItemWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].width; }
+    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].originWidth; }
+    int GetGridItemIndex(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].progIndex; }
+    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { GetGridRow(iChannel)[iBlock].width = fWidth; }
 
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime &GetGridStart() const { return m_gridStart; }
@@ -88,6 +96,14 @@ namespace EPG
     void FreeItemsMemory();
     void Reset();
 
+    /*!
+     * @brief Get the grid blocks of a channel. They are calculated on first access.
+     * @param iChannel The index of the channel.
+     * @return The blocks of the channel.
+     */
+    std::vector<GridItem> &GetGridRow(int iChannel) const;
+    void CalculateGridRow(int iChannel, std::vector<GridItem> &blocks) const;
+
     struct ItemsPtr
     {
       long start;
@@ -101,8 +117,9 @@ namespace EPG
     std::vector<CFileItemPtr> m_channelItems;
     std::vector<CFileItemPtr> m_rulerItems;
     std::vector<ItemsPtr> m_epgItemsPtr;
-    std::vector<std::vector<GridItem> > m_gridIndex;
+    mutable std::unordered_map<int, std::vector<GridItem> > m_gridIndex; //! lazily calculated grid rows, by channel index
 
     int m_blocks;
+    float m_fBlockSize;
   };
 }
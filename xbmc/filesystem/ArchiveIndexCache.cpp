@@ -0,0 +1,275 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "ArchiveIndexCache.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "RarManager.h"
+#include "URL.h"
+#include "ZipManager.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "XBDateTime.h"
+
+#define ARCHIVE_INDEX_PATH "special://temp/archivecache/"
+#define ARCHIVE_INDEX_EXT ".idx"
+
+// bump when the layout of the stored entries changes
+#define ARCHIVE_INDEX_VERSION 1
+#define ARCHIVE_INDEX_END 0x58444e49 // "INDX"
+
+// indexes that haven't been rewritten for this many days are removed
+#define ARCHIVE_INDEX_MAX_AGE 30
+
+// workers used next to the calling thread when indexing a directory
+#define ARCHIVE_INDEX_WORKERS 3
+
+using namespace XFILE;
+
+CArchiveIndexCache& CArchiveIndexCache::GetInstance()
+{
+  static CArchiveIndexCache instance;
+  return instance;
+}
+
+CArchiveIndexCache::CArchiveIndexCache()
+  : m_cleaned(false)
+{
+}
+
+std::string CArchiveIndexCache::GetKey(const std::string &path, int64_t size, time_t mtime)
+{
+  // without a modification time a changed archive can't be detected
+  if (path.empty() || size <= 0 || mtime <= 0)
+    return "";
+
+  return StringUtils::Format("%08x-%" PRIx64"-%" PRIx64, Crc32::Compute(path), (uint64_t)size, (uint64_t)mtime);
+}
+
+std::string CArchiveIndexCache::GetIndexPath(const std::string &key) const
+{
+  return ARCHIVE_INDEX_PATH + key + ARCHIVE_INDEX_EXT;
+}
+
+bool CArchiveIndexCache::Load(const std::string &key, const std::string &path, const Reader &reader)
+{
+  if (key.empty())
+    return false;
+
+  std::string indexPath = GetIndexPath(key);
+  CFile file;
+  if (!file.Open(indexPath))
+    return false;
+
+  bool valid = false;
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    std::string archivePath;
+    ar >> version;
+    if (version == ARCHIVE_INDEX_VERSION)
+    {
+      ar >> archivePath;
+      // a different archive with the same key, leave its index alone
+      if (archivePath != path)
+        return false;
+
+      int end = 0;
+      valid = reader(ar);
+      ar >> end;
+      valid = valid && end == ARCHIVE_INDEX_END;
+    }
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    valid = false;
+  }
+  file.Close();
+
+  if (!valid)
+  {
+    CLog::Log(LOGWARNING, "CArchiveIndexCache::Load - invalid index %s for %s", key.c_str(), CURL::GetRedacted(path).c_str());
+    CFile::Delete(indexPath);
+  }
+  return valid;
+}
+
+bool CArchiveIndexCache::Store(const std::string &key, const std::string &path, const Writer &writer)
+{
+  if (key.empty())
+    return false;
+
+  Clean();
+
+  // write to a temporary file first so readers never see partial indexes
+  std::string indexPath = GetIndexPath(key);
+  std::string tempPath = indexPath + ".tmp";
+  CFile file;
+  if (!file.OpenForWrite(tempPath, true))
+  {
+    CLog::Log(LOGERROR, "CArchiveIndexCache::Store - failed to write %s", tempPath.c_str());
+    return false;
+  }
+
+  {
+    CArchive ar(&file, CArchive::store);
+    ar << (int)ARCHIVE_INDEX_VERSION;
+    ar << path;
+    writer(ar);
+    ar << (int)ARCHIVE_INDEX_END;
+    ar.Close();
+  }
+  file.Close();
+
+  if (!CFile::Rename(tempPath, indexPath))
+  {
+    CFile::Delete(tempPath);
+    return false;
+  }
+  return true;
+}
+
+/* Creates the cache directory and removes old indexes the first time an
+ * index is stored in a session.
+ */
+void CArchiveIndexCache::Clean()
+{
+  CSingleLock lock(m_critSection);
+  if (m_cleaned)
+    return;
+  m_cleaned = true;
+
+  if (!CDirectory::Exists(ARCHIVE_INDEX_PATH))
+  {
+    CDirectory::Create(ARCHIVE_INDEX_PATH);
+    return;
+  }
+
+  CDateTime oldest = CDateTime::GetCurrentDateTime() - CDateTimeSpan(ARCHIVE_INDEX_MAX_AGE, 0, 0, 0);
+  CFileItemList items;
+  CDirectory::GetDirectory(ARCHIVE_INDEX_PATH, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    // left over from an interrupted write or expired
+    if (!URIUtils::HasExtension(item->GetPath(), ARCHIVE_INDEX_EXT) || item->m_dateTime < oldest)
+      CFile::Delete(item->GetPath());
+  }
+}
+
+void CArchiveIndexCache::IndexArchive(const std::string &path)
+{
+  if (URIUtils::HasExtension(path, ".zip"))
+  {
+    std::vector<SZipEntry> entries;
+    g_ZipManager.GetZipList(URIUtils::CreateArchivePath("zip", CURL(path)), entries);
+  }
+  else
+    g_RarManager.IndexArchive(path);
+}
+
+void CArchiveIndexCache::IndexArchives(const CFileItemList &items)
+{
+  struct IndexState
+  {
+    CCriticalSection critSection;
+    CEvent done{true};
+    std::vector<std::string> paths;
+    size_t next = 0;
+    size_t active = 0;
+  };
+
+  std::shared_ptr<IndexState> state(new IndexState);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    if (item->m_bIsFolder || item->IsInternetStream())
+      continue;
+
+    const std::string &path = item->GetPath();
+    if (URIUtils::HasExtension(path, ".zip"))
+      state->paths.push_back(path);
+#ifdef HAS_FILESYSTEM_RAR
+    else if (URIUtils::HasExtension(path, ".rar|.001") && !StringUtils::EndsWithNoCase(path, ".ts.001"))
+    {
+      // only the first volume of a .partXX.rar set is listed
+      std::string volume = URIUtils::GetExtension(URIUtils::ReplaceExtension(path, ""));
+      if (StringUtils::StartsWithNoCase(volume, ".part") && atoi(volume.substr(5).c_str()) > 1)
+        continue;
+      state->paths.push_back(path);
+    }
+#endif
+  }
+
+  // a single archive is indexed when it's opened anyway
+  if (state->paths.size() < 2)
+    return;
+
+  auto index = [state]()
+  {
+    CSingleLock lock(state->critSection);
+    while (state->next < state->paths.size())
+    {
+      std::string path = state->paths[state->next++];
+      state->active++;
+      lock.Leave();
+
+      IndexArchive(path);
+
+      lock.Enter();
+      if (--state->active == 0 && state->next == state->paths.size())
+        state->done.Set();
+    }
+  };
+
+  /* the calling thread takes part, workers that start after all archives
+   * have been taken return right away and aren't waited for */
+  size_t workers = std::min<size_t>(state->paths.size() - 1, ARCHIVE_INDEX_WORKERS);
+  for (size_t i = 0; i < workers; i++)
+    CJobManager::GetInstance().Submit(index, CJob::PRIORITY_NORMAL);
+  index();
+
+  {
+    CSingleLock lock(state->critSection);
+    if (state->active == 0)
+      return;
+  }
+  state->done.Wait();
+}
@@ -0,0 +1,89 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+
+#include "threads/CriticalSection.h"
+
+class CArchive;
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \brief Disk cache of the directory indexes of RAR and ZIP archives.
+
+   Parsing the headers of an archive means reading through the whole archive
+   for RARs, so the indexes are kept in special://temp/archivecache across
+   restarts. An index is stored per archive version, identified by path, size
+   and modification time; indexes that haven't been rewritten for a month are
+   removed. The archive managers serialize their own entries.
+   */
+  class CArchiveIndexCache
+  {
+  public:
+    typedef std::function<bool(CArchive&)> Reader;
+    typedef std::function<void(CArchive&)> Writer;
+
+    static CArchiveIndexCache& GetInstance();
+
+    /*!
+     \brief Get the key identifying a version of an archive.
+     \return The key or an empty string if the archive can't be cached.
+     */
+    static std::string GetKey(const std::string &path, int64_t size, time_t mtime);
+
+    /*!
+     \brief Load a stored index.
+     \param reader Reads the entries, returns false if they are invalid.
+     \return true if the index was stored and read completely.
+     */
+    bool Load(const std::string &key, const std::string &path, const Reader &reader);
+
+    /*!
+     \brief Store an index, replacing an existing one.
+     */
+    bool Store(const std::string &key, const std::string &path, const Writer &writer);
+
+    /*!
+     \brief Index the RAR and ZIP archives in a directory listing in parallel.
+
+     Used before the archives are opened one by one as file directories, so
+     that a directory full of archives isn't indexed archive after archive.
+     */
+    static void IndexArchives(const CFileItemList &items);
+
+  private:
+    CArchiveIndexCache();
+    CArchiveIndexCache(const CArchiveIndexCache&) = delete;
+    CArchiveIndexCache& operator=(const CArchiveIndexCache&) = delete;
+
+    static void IndexArchive(const std::string &path);
+    std::string GetIndexPath(const std::string &key) const;
+    void Clean();
+
+    CCriticalSection m_critSection;
+    bool m_cleaned;
+  };
+}
@@ -0,0 +1,217 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BlockCache.h"
+
+#include <inttypes.h>
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#define BLOCK_CACHE_PATH "special://temp/blockcache/"
+#define BLOCK_CACHE_EXT ".blk"
+
+// head and tail of a file that are stored, in blocks
+#define BLOCK_CACHE_EDGE_BLOCKS 16
+
+using namespace XFILE;
+
+CBlockCache& CBlockCache::GetInstance()
+{
+  static CBlockCache instance;
+  return instance;
+}
+
+CBlockCache::CBlockCache()
+  : m_loaded(false)
+  , m_usedSize(0)
+{
+}
+
+bool CBlockCache::IsEnabled() const
+{
+  return g_advancedSettings.m_blockCacheSize > 0;
+}
+
+std::string CBlockCache::GetKey(const std::string &url, int64_t size, time_t mtime)
+{
+  // without a modification time a changed file can't be detected
+  if (url.empty() || size <= 0 || mtime <= 0)
+    return "";
+
+  return StringUtils::Format("%08x-%" PRIx64"-%" PRIx64, Crc32::Compute(url), (uint64_t)size, (uint64_t)mtime);
+}
+
+bool CBlockCache::ShouldStore(int64_t block, int64_t fileSize)
+{
+  int64_t blocks = (fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  return block < BLOCK_CACHE_EDGE_BLOCKS || block >= blocks - BLOCK_CACHE_EDGE_BLOCKS;
+}
+
+std::string CBlockCache::GetBlockPath(const std::string &name) const
+{
+  return BLOCK_CACHE_PATH + name;
+}
+
+unsigned int CBlockCache::ReadBlock(const std::string &key, int64_t block, char *buffer)
+{
+  if (key.empty() || !IsEnabled())
+    return 0;
+
+  CSingleLock lock(m_critSection);
+  Load();
+
+  std::string name = StringUtils::Format("%s-%" PRId64 BLOCK_CACHE_EXT, key.c_str(), block);
+  std::map<std::string, SEntry>::iterator it = m_entries.find(name);
+  if (it == m_entries.end())
+    return 0;
+  lock.Leave();
+
+  CFile file;
+  ssize_t read = -1;
+  if (file.Open(GetBlockPath(name)))
+    read = file.Read(buffer, BLOCK_SIZE);
+
+  lock.Enter();
+  it = m_entries.find(name);
+  if (read <= 0 || it == m_entries.end() || (uint64_t)read != it->second.size)
+  {
+    CLog::Log(LOGWARNING, "CBlockCache::ReadBlock - invalid block %s", name.c_str());
+    if (it != m_entries.end())
+    {
+      m_usedSize -= it->second.size;
+      m_entries.erase(it);
+    }
+    file.Close();
+    CFile::Delete(GetBlockPath(name));
+    return 0;
+  }
+
+  it->second.lastUsed = time(NULL);
+  return (unsigned int)read;
+}
+
+bool CBlockCache::WriteBlock(const std::string &key, int64_t block, const char *buffer, unsigned int size)
+{
+  if (key.empty() || size == 0 || size > BLOCK_SIZE || !IsEnabled())
+    return false;
+
+  uint64_t maxSize = (uint64_t)g_advancedSettings.m_blockCacheSize * 1024 * 1024;
+  std::string name = StringUtils::Format("%s-%" PRId64 BLOCK_CACHE_EXT, key.c_str(), block);
+  {
+    CSingleLock lock(m_critSection);
+    Load();
+    if (m_entries.find(name) != m_entries.end())
+      return true;
+    Evict(maxSize - std::min<uint64_t>(maxSize, size));
+  }
+
+  // write to a temporary file first so readers never see partial blocks
+  std::string tempPath = GetBlockPath(name + ".tmp");
+  CFile file;
+  if (!file.OpenForWrite(tempPath, true) || file.Write(buffer, size) != (ssize_t)size)
+  {
+    CLog::Log(LOGERROR, "CBlockCache::WriteBlock - failed to write %s", tempPath.c_str());
+    file.Close();
+    CFile::Delete(tempPath);
+    return false;
+  }
+  file.Close();
+
+  if (!CFile::Rename(tempPath, GetBlockPath(name)))
+  {
+    CFile::Delete(tempPath);
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (m_entries.find(name) == m_entries.end())
+  {
+    SEntry entry = { size, time(NULL) };
+    m_entries.insert(std::make_pair(name, entry));
+    m_usedSize += size;
+  }
+  return true;
+}
+
+/* Builds the index from the cache directory the first time it is needed,
+ * using the modification time of the block files as last use.
+ */
+void CBlockCache::Load()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  if (!CDirectory::Exists(BLOCK_CACHE_PATH))
+  {
+    CDirectory::Create(BLOCK_CACHE_PATH);
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(BLOCK_CACHE_PATH, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    std::string name = URIUtils::GetFileName(item->GetPath());
+    if (!URIUtils::HasExtension(name, BLOCK_CACHE_EXT) || item->m_dwSize <= 0)
+    {
+      // left over from an interrupted write
+      CFile::Delete(item->GetPath());
+      continue;
+    }
+
+    SEntry entry = { (uint64_t)item->m_dwSize, 0 };
+    item->m_dateTime.GetAsTime(entry.lastUsed);
+    m_entries.insert(std::make_pair(name, entry));
+    m_usedSize += entry.size;
+  }
+
+  Evict((uint64_t)g_advancedSettings.m_blockCacheSize * 1024 * 1024);
+  CLog::Log(LOGDEBUG, "CBlockCache::Load - %u blocks, %" PRIu64" bytes", (unsigned int)m_entries.size(), m_usedSize);
+}
+
+void CBlockCache::Evict(uint64_t maxSize)
+{
+  while (m_usedSize > maxSize && !m_entries.empty())
+  {
+    std::map<std::string, SEntry>::iterator oldest = m_entries.begin();
+    for (std::map<std::string, SEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->second.lastUsed < oldest->second.lastUsed)
+        oldest = it;
+    }
+
+    CFile::Delete(GetBlockPath(oldest->first));
+    m_usedSize -= oldest->second.size;
+    m_entries.erase(oldest);
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+
+#include "threads/CriticalSection.h"
+
+namespace XFILE
+{
+  /*!
+   \brief Disk cache of file blocks that survives closing the file and restarts.
+
+   Blocks are stored per file version, identified by url, size and modification
+   time, in special://temp/blockcache. The total size is limited by
+   <cache><blockcachesize> (in MB, 0 disables the cache), the least recently used
+   blocks are removed when it is exceeded. Only the head and the tail of a file
+   are stored, that's where demuxers find headers and indexes.
+   */
+  class CBlockCache
+  {
+  public:
+    static const unsigned int BLOCK_SIZE = 1024 * 1024;
+
+    static CBlockCache& GetInstance();
+
+    bool IsEnabled() const;
+
+    /*!
+     \brief Get the key identifying a version of a file.
+     \return The key or an empty string if the file can't be cached.
+     */
+    static std::string GetKey(const std::string &url, int64_t size, time_t mtime);
+
+    /*!
+     \brief Whether a block is worth storing, see class description.
+     */
+    static bool ShouldStore(int64_t block, int64_t fileSize);
+
+    /*!
+     \brief Read a stored block.
+     \param buffer Buffer of at least BLOCK_SIZE bytes.
+     \return Size of the block (smaller than BLOCK_SIZE only for the last block
+             of a file), 0 if the block isn't stored.
+     */
+    unsigned int ReadBlock(const std::string &key, int64_t block, char *buffer);
+
+    /*!
+     \brief Store a block, evicting old blocks if needed.
+     */
+    bool WriteBlock(const std::string &key, int64_t block, const char *buffer, unsigned int size);
+
+  private:
+    CBlockCache();
+    CBlockCache(const CBlockCache&) = delete;
+    CBlockCache& operator=(const CBlockCache&) = delete;
+
+    void Load();
+    void Evict(uint64_t maxSize);
+    std::string GetBlockPath(const std::string &name) const;
+
+    struct SEntry
+    {
+      uint64_t size;
+      time_t   lastUsed;
+    };
+
+    CCriticalSection m_critSection;
+    bool m_loaded;
+    std::map<std::string, SEntry> m_entries; // by file name
+    uint64_t m_usedSize;
+  };
+}
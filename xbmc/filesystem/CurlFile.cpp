@@ -31,6 +31,7 @@
 #include <vector>
 #include <climits>
 #include <cassert>
+#include <iterator>
 
 #ifdef TARGET_POSIX
 #include <errno.h>
@@ -53,6 +54,9 @@ using namespace XCURL;
 #define XMIN(a,b) ((a)<(b)?(a):(b))
 #define FITS_INT(a) (((a) <= INT_MAX) && ((a) >= INT_MIN))
 
+// number of ranges kept open besides the current one, see CCurlFile::Seek
+#define MAX_OLD_STATES 3
+
 curl_proxytype proxyType2CUrlProxyType[] = {
   CURLPROXY_HTTP,
   CURLPROXY_SOCKS4,
@@ -381,7 +385,12 @@ long CCurlFile::CReadState::Connect(unsigned int size)
 void CCurlFile::CReadState::Disconnect()
 {
   if(m_multiHandle && m_easyHandle)
+  {
+    // m_bufferSize is only set while connected
+    if (m_bufferSize)
+      g_curlInterface.UpdateHostStats(m_easyHandle);
     g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
+  }
 
   m_buffer.Clear();
   free(m_overflowBuffer);
@@ -407,7 +416,6 @@ CCurlFile::~CCurlFile()
 {
   Close();
   delete m_state;
-  delete m_oldState;
   g_curlInterface.Unload();
 }
 
@@ -438,7 +446,6 @@ CCurlFile::CCurlFile()
   m_httpauth = "";
   m_cipherlist = "";
   m_state = new CReadState();
-  m_oldState = NULL;
   m_skipshout = false;
   m_httpresponse = -1;
   m_acceptCharset = "UTF-8,*;q=0.8"; /* prefer UTF-8 if available */
@@ -451,14 +458,20 @@ void CCurlFile::SetBufferSize(unsigned int size)
   m_bufferSize = size;
 }
 
+void CCurlFile::ClearOldStates()
+{
+  for (std::vector<CReadState*>::iterator it = m_oldStates.begin(); it != m_oldStates.end(); ++it)
+    delete *it;
+  m_oldStates.clear();
+}
+
 void CCurlFile::Close()
 {
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
   m_state->Disconnect();
-  delete m_oldState;
-  m_oldState = NULL;
+  ClearOldStates();
 
   m_url.clear();
   m_referer.clear();
@@ -522,6 +535,15 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   // resolves. Unfortunately, c-ares does not yet support IPv6.
   g_curlInterface.easy_setopt(h, CURLOPT_NOSIGNAL, TRUE);
 
+  // reuse dns lookups, tls sessions and connections of other sessions
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
+#if LIBCURL_VERSION_NUM >= 0x071900 // 7.25.0
+  // keep idle pooled connections from being dropped by NAT routers
+  g_curlInterface.easy_setopt(h, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+
   // not interested in failed requests
   g_curlInterface.easy_setopt(h, CURLOPT_FAILONERROR, 1);
 
@@ -1293,12 +1315,27 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 
   if (m_multisession)
   {
-    if (!m_oldState)
+    // ranges requested by earlier seeks are kept open, most recently used
+    // last, so jumping between e.g. the index at the end of a file and the
+    // data doesn't need a new request each time
+    for (std::vector<CReadState*>::reverse_iterator it = m_oldStates.rbegin(); it != m_oldStates.rend(); ++it)
+    {
+      if ((*it)->Seek(nextPos))
+      {
+        CReadState *state = *it;
+        m_oldStates.erase(std::next(it).base());
+        m_oldStates.push_back(m_state);
+        m_state = state;
+        return nextPos;
+      }
+    }
+
+    if (m_oldStates.size() < MAX_OLD_STATES)
     {
       CURL url(m_url);
-      m_oldState          = m_state;
+      m_oldStates.push_back(m_state);
       m_state             = new CReadState();
-      m_state->m_fileSize = m_oldState->m_fileSize;
+      m_state->m_fileSize = m_oldStates.back()->m_fileSize;
       g_curlInterface.easy_aquire(url.GetProtocol().c_str(),
                                   url.GetHostName().c_str(),
                                   &m_state->m_easyHandle,
@@ -1306,14 +1343,11 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
     }
     else
     {
-      CReadState *tmp;
-      tmp         = m_state;
-      m_state     = m_oldState;
-      m_oldState  = tmp;
-
-      if (m_state->Seek(nextPos))
-        return nextPos;
-      
+      // reuse the least recently used range
+      CReadState *state = m_oldStates.front();
+      m_oldStates.erase(m_oldStates.begin());
+      m_oldStates.push_back(m_state);
+      m_state = state;
       m_state->Disconnect();
     }
   }
@@ -1335,11 +1369,12 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   {
     if(m_multisession)
     {
-      if (m_oldState)
+      if (!m_oldStates.empty())
       {
         delete m_state;
-        m_state     = m_oldState;
-        m_oldState  = NULL;
+        m_state = m_oldStates.back();
+        m_oldStates.pop_back();
+        ClearOldStates();
       }
       // Retry without mutlisession
       m_multisession = false;
@@ -1438,6 +1473,8 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
 
   }
 
+  g_curlInterface.UpdateHostStats(m_state->m_easyHandle);
+
   if( result != CURLE_ABORTED_BY_CALLBACK && result != CURLE_OK )
   {
     g_curlInterface.easy_release(&m_state->m_easyHandle, NULL);
@@ -23,6 +23,7 @@
 #include "utils/RingBuffer.h"
 #include <map>
 #include <string>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -161,8 +162,10 @@ namespace XFILE
       bool Service(const std::string& strURL, std::string& strHTML);
 
     protected:
+      void ClearOldStates();
+
       CReadState*     m_state;
-      CReadState*     m_oldState;
+      std::vector<CReadState*> m_oldStates; // open ranges of earlier seeks, see Seek()
       unsigned int    m_bufferSize;
       int64_t         m_writeOffset;
 
@@ -19,6 +19,7 @@
  */
 
 #include "Directory.h"
+#include "ArchiveIndexCache.h"
 #include "DirectoryFactory.h"
 #include "FileDirectoryFactory.h"
 #include "commons/Exception.h"
@@ -199,7 +200,7 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
-        g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+        g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url), pDirectory->HasFileInfo(realURL));
     }
 
     // now filter for allowed files
@@ -374,6 +375,8 @@ bool CDirectory::RemoveRecursive(const CURL& url)
 
 void CDirectory::FilterFileDirectories(CFileItemList &items, const std::string &mask)
 {
+  CArchiveIndexCache::IndexArchives(items);
+
   for (int i=0; i< items.Size(); ++i)
   {
     CFileItemPtr pItem=items[i];
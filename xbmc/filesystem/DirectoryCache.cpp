@@ -27,6 +27,8 @@
 #include "URL.h"
 #include "climits"
 
+#include <string.h>
+
 #include <algorithm>
 
 // Maximum number of directories to keep in our cache
@@ -37,6 +39,7 @@ using namespace XFILE;
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
+  m_hasFileInfo = false;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
@@ -92,7 +95,7 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
   return false;
 }
 
-void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, bool hasFileInfo /* = false */)
 {
   if (cacheType == DIR_CACHE_NEVER)
     return; // nothing to do
@@ -120,6 +123,7 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
 
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
+  dir->m_hasFileInfo = hasFileInfo;
   dir->SetLastAccess(m_accessCounter);
   m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
 }
@@ -176,6 +180,7 @@ void CDirectoryCache::AddFile(const std::string& strFile)
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
+    dir->m_hasFileInfo = false; // nothing is known about the new file
     dir->SetLastAccess(m_accessCounter);
   }
 }
@@ -208,6 +213,67 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   return false;
 }
 
+bool CDirectoryCache::Stat(const std::string& strFile, struct __stat64* buffer, bool& bInCache)
+{
+  CSingleLock lock (m_cs);
+  bInCache = false;
+
+  // Get rid of any URL options, else the compare may be wrong
+  std::string strPath = CURL(strFile).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(strPath);
+  std::string storedPath = URIUtils::GetDirectory(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  ciCache i = m_cache.find(storedPath);
+  if (i == m_cache.end() || !i->second->m_hasFileInfo || URIUtils::PathEquals(strPath, storedPath))
+  {
+#ifdef _DEBUG
+    m_cacheMisses++;
+#endif
+    return false;
+  }
+
+  bInCache = true;
+  CDir *dir = i->second;
+  dir->SetLastAccess(m_accessCounter);
+#ifdef _DEBUG
+  m_cacheHits++;
+#endif
+
+  // folders are listed with a trailing slash
+  CFileItemPtr item = dir->m_Items->Get(strFile);
+  if (!item)
+  {
+    std::string folder(strFile);
+    URIUtils::AddSlashAtEnd(folder);
+    item = dir->m_Items->Get(folder);
+  }
+  if (!item)
+    return false;
+
+  // m_dateTime is local time converted with the offset of the file's own date,
+  // it can't be turned back into the file's mtime reliably
+  if (!item->HasProperty("file:mtime"))
+  {
+    bInCache = false;
+    return false;
+  }
+
+  memset(buffer, 0, sizeof(struct __stat64));
+  buffer->st_mode = item->m_bIsFolder ? _S_IFDIR : _S_IFREG;
+  buffer->st_size = item->m_dwSize;
+  buffer->st_mtime = (time_t)item->GetProperty("file:mtime").asInteger();
+  return true;
+}
+
+void CDirectoryCache::ClearFileInfo()
+{
+  CSingleLock lock (m_cs);
+
+  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+    i->second->m_hasFileInfo = false;
+}
+
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
@@ -22,6 +22,7 @@
 #include "IDirectory.h"
 #include "Directory.h"
 #include "threads/CriticalSection.h"
+#include "PlatformDefs.h" // for __stat64
 
 #include <map>
 #include <set>
@@ -43,6 +44,8 @@ namespace XFILE
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      bool m_hasFileInfo; ///< items carry size, modification time and type, see IDirectory::HasFileInfo
+
     private:
       unsigned int m_lastAccess;
     };
@@ -50,13 +53,24 @@ namespace XFILE
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
-    void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
+    void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, bool hasFileInfo = false);
     void ClearDirectory(const std::string& strPath);
     void ClearFile(const std::string& strFile);
     void ClearSubPaths(const std::string& strPath);
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+    /*! \brief Fill size, modification time and type of a file from the listing of its directory
+     \param strPath File to stat.
+     \param buffer Stat buffer to fill.
+     \param bInCache Set to true if the directory is cached with file info, so a file that isn't found doesn't exist.
+     \return true if the file was found, buffer is filled then.
+     */
+    bool Stat(const std::string& strPath, struct __stat64* buffer, bool& bInCache);
+    /*! \brief Stop answering Stat() from the directories cached so far, for callers that
+     need file info at least as recent as their own listings (e.g. scanners at their start).
+     */
+    void ClearFileInfo();
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
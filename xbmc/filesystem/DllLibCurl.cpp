@@ -22,6 +22,7 @@
 #include "system.h"
 #include "DllLibCurl.h"
 #include "threads/SingleLock.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 
 #include <assert.h>
@@ -61,6 +62,19 @@ unsigned long ssl_thread_id(void)
 
 using namespace XCURL;
 
+/* one lock for each kind of data shared between the handles of g_curlInterface */
+static CCriticalSection g_shareLocks[CURL_LOCK_DATA_LAST];
+
+static void share_lock(CURL_HANDLE *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+  g_shareLocks[data].lock();
+}
+
+static void share_unlock(CURL_HANDLE *handle, curl_lock_data data, void *userptr)
+{
+  g_shareLocks[data].unlock();
+}
+
 /* okey this is damn ugly. our dll loader doesn't allow for postload, preunload functions */
 static long g_curlReferences = 0;
 #if(0)
@@ -91,6 +105,19 @@ bool DllLibCurlGlobal::Load()
   /* check idle will clean up the last one */
   g_curlReferences = 2;
 
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    /* connection cache can be shared since 7.57.0 */
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+
 #if defined(HAS_CURL_STATIC)
   // Initialize ssl locking array
   m_sslLockArray = new CCriticalSection*[CRYPTO_num_locks()];
@@ -112,6 +139,10 @@ void DllLibCurlGlobal::Unload()
     if (!IsLoaded())
       return;
 
+    if (m_share)
+      share_cleanup(m_share);
+    m_share = NULL;
+
     // close libcurl
     global_cleanup();
 
@@ -142,8 +173,8 @@ void DllLibCurlGlobal::CheckIdle()
     return;
 
   CSingleLock lock(m_critSection);
-  /* 20 seconds idle time before closing handle */
-  const unsigned int idletime = 30000;
+  /* idle time before closing handle, keeping its connections alive until then */
+  const unsigned int idletime = g_advancedSettings.m_curlKeepAliveTime * 1000;
 
   VEC_CURLSESSIONS::iterator it = m_sessions.begin();
   while(it != m_sessions.end())
@@ -159,9 +190,21 @@ void DllLibCurlGlobal::CheckIdle()
       if(it->m_multi)
         multi_cleanup(it->m_multi);
 
+      std::string host = it->m_protocol + "://" + it->m_hostname;
+
       Unload();
 
       it = m_sessions.erase(it);
+
+      /* report what the host cost us once its last session is gone and forget it, */
+      /* so only hosts with open sessions are kept */
+      MAP_HOSTSTATS::iterator stats = m_hostStats.find(host);
+      if (stats != m_hostStats.end() && !HasSession(host))
+      {
+        CLog::Log(LOGDEBUG, "%s - %s: %u requests, %u connections, %" PRIu64" bytes in %.1f s", __FUNCTION__, host.c_str(),
+                  stats->second.m_requests, stats->second.m_connects, stats->second.m_bytes, stats->second.m_transferTime);
+        m_hostStats.erase(stats);
+      }
       continue;
     }
     ++it;
@@ -326,3 +369,42 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
   }
   return;
 }
+
+bool DllLibCurlGlobal::HasSession(const std::string &host) const
+{
+  for (VEC_CURLSESSIONS::const_iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
+  {
+    if (it->m_protocol + "://" + it->m_hostname == host)
+      return true;
+  }
+  return false;
+}
+
+void DllLibCurlGlobal::UpdateHostStats(CURL_HANDLE* easy_handle)
+{
+  long connects = 0;
+  double bytes = 0.0;
+  double time = 0.0;
+
+  if (!easy_handle ||
+      easy_getinfo(easy_handle, CURLINFO_NUM_CONNECTS, &connects) != CURLE_OK ||
+      easy_getinfo(easy_handle, CURLINFO_SIZE_DOWNLOAD, &bytes) != CURLE_OK ||
+      easy_getinfo(easy_handle, CURLINFO_TOTAL_TIME, &time) != CURLE_OK)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  VEC_CURLSESSIONS::iterator it;
+  for(it = m_sessions.begin(); it != m_sessions.end(); ++it)
+  {
+    if( it->m_easy == easy_handle )
+    {
+      SHostStats &stats = m_hostStats[it->m_protocol + "://" + it->m_hostname];
+      stats.m_requests++;
+      stats.m_connects += connects;
+      stats.m_bytes += (uint64_t)bytes;
+      stats.m_transferTime += time;
+      return;
+    }
+  }
+}
@@ -21,7 +21,10 @@
 
 #include "DynamicDll.h"
 #include "threads/CriticalSection.h"
+#include <stdint.h>
 #include <stdio.h>
+#include <map>
+#include <string>
 #include <vector>
 
 /* put types of curl in namespace to avoid namespace pollution */
@@ -55,6 +58,8 @@ namespace XCURL
     virtual CURLMcode multi_cleanup(CURLM * handle )=0;
     virtual struct curl_slist* slist_append(struct curl_slist *, const char *)=0;
     virtual void  slist_free_all(struct curl_slist *)=0;
+    virtual CURLSH * share_init(void)=0;
+    virtual CURLSHcode share_cleanup(CURLSH *share_handle)=0;
   };
 
   class DllLibCurl : public DllDynamic, DllLibCurlInterface
@@ -81,6 +86,9 @@ namespace XCURL
     DEFINE_METHOD2(struct curl_slist*, slist_append, (struct curl_slist * p1, const char * p2))
     DEFINE_METHOD1(void, slist_free_all, (struct curl_slist * p1))
     DEFINE_METHOD1(const char *, easy_strerror, (CURLcode p1))
+    DEFINE_METHOD0(CURLSH *, share_init)
+    DEFINE_METHOD_FP(CURLSHcode, share_setopt, (CURLSH *p1, CURLSHoption p2, ...))
+    DEFINE_METHOD1(CURLSHcode, share_cleanup, (CURLSH *p1))
 #if defined(HAS_CURL_STATIC)
     DEFINE_METHOD1(void, crypto_set_id_callback, (unsigned long (*p1)(void)))
     DEFINE_METHOD1(void, crypto_set_locking_callback, (void (*p1)(int, int, const char *, int)))
@@ -107,6 +115,9 @@ namespace XCURL
       RESOLVE_METHOD_RENAME(curl_multi_cleanup, multi_cleanup)
       RESOLVE_METHOD_RENAME(curl_slist_append, slist_append)
       RESOLVE_METHOD_RENAME(curl_slist_free_all, slist_free_all)
+      RESOLVE_METHOD_RENAME(curl_share_init, share_init)
+      RESOLVE_METHOD_RENAME_FP(curl_share_setopt, share_setopt)
+      RESOLVE_METHOD_RENAME(curl_share_cleanup, share_cleanup)
 #if defined(HAS_CURL_STATIC)
       RESOLVE_METHOD_RENAME(CRYPTO_set_id_callback, crypto_set_id_callback)
       RESOLVE_METHOD_RENAME(CRYPTO_set_locking_callback, crypto_set_locking_callback)
@@ -129,6 +140,25 @@ namespace XCURL
     virtual bool Load();
     virtual void Unload();
 
+    /* share handle so dns cache, ssl sessions and (if supported) connections */
+    /* are reused by all sessions, not just the one to the same host */
+    CURLSH* GetShare() { return m_share; }
+
+    /* transfer statistics collected per protocol://hostname, logged and */
+    /* dropped when the last session to the host is closed */
+    typedef struct SHostStats
+    {
+      unsigned int  m_requests;       // number of finished transfers
+      unsigned int  m_connects;       // number of new connections these needed
+      uint64_t      m_bytes;          // bytes received
+      double        m_transferTime;   // seconds spent in transfers
+    } SHostStats;
+
+    typedef std::map<std::string, SHostStats> MAP_HOSTSTATS;
+
+    /* account the last transfer done by easy_handle to its session's host */
+    void UpdateHostStats(CURL_HANDLE* easy_handle);
+
     /* structure holding a session info */
     typedef struct SSession
     {
@@ -142,7 +172,11 @@ namespace XCURL
 
     typedef std::vector<SSession> VEC_CURLSESSIONS;
 
+    bool HasSession(const std::string &host) const;
+
     VEC_CURLSESSIONS m_sessions;
+    MAP_HOSTSTATS    m_hostStats;
+    CURLSH*          m_share = NULL;
     CCriticalSection m_critSection;
   };
 }
@@ -35,6 +35,8 @@
 
 #include "commons/Exception.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
 //////////////////////////////////////////////////////////////////////
@@ -44,6 +46,11 @@ using namespace XFILE;
 #pragma warning (disable:4244)
 #endif
 
+// largest read buffer used when copying from network sources
+#define COPY_MAX_BUFFER_SIZE (4 * 1024 * 1024)
+// bytes copied inside the kernel between progress callbacks
+#define COPY_KERNEL_CHUNK_SIZE (16 * 1024 * 1024)
+
 //*********************************************************************************************
 CFile::CFile()
 {
@@ -82,10 +89,7 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
   if (pathToUrl.empty())
     return false;
 
-  // special case for zips - ignore caching
   CURL url(url2);
-  if (URIUtils::IsInZIP(url.Get()) || URIUtils::IsInAPK(url.Get()))
-    url.SetOptions("?cache=no");
   if (file.Open(url.Get(), READ_TRUNCATED | READ_CHUNKED))
   {
 
@@ -137,6 +141,8 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
     }
 
     int iBufferSize = GetChunkSize(file.GetChunkSize(), 128 * 1024);
+    // reads from network sources grow while they keep filling the buffer
+    const int iMaxBufferSize = URIUtils::IsHD(url.Get()) ? iBufferSize : std::max(iBufferSize, COPY_MAX_BUFFER_SIZE);
 
     auto_buffer buffer(iBufferSize);
     ssize_t iRead, iWrite;
@@ -144,6 +150,9 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
     UINT64 llFileSize = file.GetLength();
     UINT64 llPos = 0;
 
+    // unbuffered files of the same protocol may copy without passing the data through userspace
+    bool bInKernel = !file.m_pBuffer && !newFile.m_pBuffer;
+
     CStopWatch timer;
     timer.StartZero();
     float start = 0.0f;
@@ -151,30 +160,50 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
     {
       g_application.ResetScreenSaver();
 
-      iRead = file.Read(buffer.get(), iBufferSize);
-      if (iRead == 0) break;
-      else if (iRead < 0)
+      if (bInKernel)
       {
-        CLog::Log(LOGERROR, "%s - Failed read from file %s", __FUNCTION__, url.GetRedacted().c_str());
-        llFileSize = (uint64_t)-1;
-        break;
+        iRead = newFile.m_pFile->CopyFrom(file.m_pFile, COPY_KERNEL_CHUNK_SIZE);
+        if (iRead < 0)
+        {
+          // not supported, carry on from the current position with read/write
+          bInKernel = false;
+          continue;
+        }
+        if (iRead == 0) break;
       }
-
-      /* write data and make sure we managed to write it all */
-      iWrite = 0;
-      while(iWrite < iRead)
+      else
       {
-        ssize_t iWrite2 = newFile.Write(buffer.get() + iWrite, iRead - iWrite);
-        if(iWrite2 <=0)
+        iRead = file.Read(buffer.get(), iBufferSize);
+        if (iRead == 0) break;
+        else if (iRead < 0)
+        {
+          CLog::Log(LOGERROR, "%s - Failed read from file %s", __FUNCTION__, url.GetRedacted().c_str());
+          llFileSize = (uint64_t)-1;
           break;
-        iWrite+=iWrite2;
-      }
+        }
 
-      if (iWrite != iRead)
-      {
-        CLog::Log(LOGERROR, "%s - Failed write to file %s", __FUNCTION__, dest.GetRedacted().c_str());
-        llFileSize = (uint64_t)-1;
-        break;
+        /* write data and make sure we managed to write it all */
+        iWrite = 0;
+        while(iWrite < iRead)
+        {
+          ssize_t iWrite2 = newFile.Write(buffer.get() + iWrite, iRead - iWrite);
+          if(iWrite2 <=0)
+            break;
+          iWrite+=iWrite2;
+        }
+
+        if (iWrite != iRead)
+        {
+          CLog::Log(LOGERROR, "%s - Failed write to file %s", __FUNCTION__, dest.GetRedacted().c_str());
+          llFileSize = (uint64_t)-1;
+          break;
+        }
+
+        if (iRead == iBufferSize && iBufferSize < iMaxBufferSize)
+        {
+          iBufferSize = std::min(iBufferSize * 2, iMaxBufferSize);
+          buffer.allocate(iBufferSize);
+        }
       }
 
       llPos += iRead;
@@ -500,19 +529,31 @@ bool CFile::SkipNext()
   return false;
 }
 
-int CFile::Stat(const std::string& strFileName, struct __stat64* buffer)
+int CFile::Stat(const std::string& strFileName, struct __stat64* buffer, bool bUseCache /* = false */)
 {
   const CURL pathToUrl(strFileName);
-  return Stat(pathToUrl, buffer);
+  return Stat(pathToUrl, buffer, bUseCache);
 }
 
-int CFile::Stat(const CURL& file, struct __stat64* buffer)
+int CFile::Stat(const CURL& file, struct __stat64* buffer, bool bUseCache /* = false */)
 {
   if (!buffer)
     return -1;
 
   CURL url(URIUtils::SubstitutePath(file));
 
+  if (bUseCache)
+  {
+    bool bPathInCache;
+    if (g_directoryCache.Stat(url.Get(), buffer, bPathInCache))
+      return 0;
+    if (bPathInCache)
+    {
+      errno = ENOENT;
+      return -1;
+    }
+  }
+
   try
   {
     std::unique_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
@@ -144,9 +144,11 @@ public:
   * information will be set to zero (st_nlink can be set ether to 1 or zero).
   * @param file        specifies requested file
   * @param buffer      pointer to __stat64 buffer to receive information about file
+  * @param bUseCache   answer from the cached listing of the parent folder if it has file info,
+  *                    only st_mode, st_size and st_mtime are set then
   * @return zero of success, -1 otherwise.
   */
-  static int  Stat(const CURL& file, struct __stat64* buffer);
+  static int  Stat(const CURL& file, struct __stat64* buffer, bool bUseCache = false);
   static bool Rename(const CURL& file, const CURL& urlNew);
   static bool Copy(const CURL& file, const CURL& dest, XFILE::IFileCallback* pCallback = NULL, void* pContext = NULL);
   static bool SetHidden(const CURL& file, bool hidden);
@@ -163,9 +165,11 @@ public:
   * information will be set to zero (st_nlink can be set ether to 1 or zero).
   * @param strFileName specifies requested file
   * @param buffer      pointer to __stat64 buffer to receive information about file
+  * @param bUseCache   answer from the cached listing of the parent folder if it has file info,
+  *                    only st_mode, st_size and st_mtime are set then
   * @return zero of success, -1 otherwise.
   */
-  static int  Stat(const std::string& strFileName, struct __stat64* buffer);
+  static int  Stat(const std::string& strFileName, struct __stat64* buffer, bool bUseCache = false);
   /**
   * Fills struct __stat64 with information about currently open file
   * For st_mode function will set correctly _S_IFDIR (directory) flag and may set
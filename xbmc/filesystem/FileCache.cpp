@@ -24,7 +24,11 @@
 #include "File.h"
 #include "URL.h"
 
+#include "BlockCache.h"
 #include "CircularCache.h"
+#include "SegmentedCache.h"
+#include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -34,6 +38,7 @@
 #endif
 
 #include <cassert>
+#include <string.h>
 #include <algorithm>
 #include <memory>
 
@@ -106,6 +111,13 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forwardCacheSize(0)
   , m_fileSize(0)
   , m_flags(flags)
+  , m_cacheHits(0)
+  , m_cacheRequests(0)
+  , m_blockIndex(-1)
+  , m_blockSize(0)
+  , m_blockCached(false)
+  , m_blockPos(0)
+  , m_sourcePos(0)
 {
 }
 
@@ -116,6 +128,14 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   , m_writeRate(0)
   , m_writeRateActual(0)
   , m_forwardCacheSize(0)
+  , m_flags(0)
+  , m_cacheHits(0)
+  , m_cacheRequests(0)
+  , m_blockIndex(-1)
+  , m_blockSize(0)
+  , m_blockCached(false)
+  , m_blockPos(0)
+  , m_sourcePos(0)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -177,8 +197,20 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  // blocks stored on disk are only valid for this version of the file
+  m_blockKey.clear();
+  if (m_seekPossible > 0 && CBlockCache::GetInstance().IsEnabled())
+  {
+    struct __stat64 st;
+    if (m_source.Stat(&st) == 0 || CFile::Stat(m_sourcePath, &st) == 0)
+      m_blockKey = CBlockCache::GetKey(m_sourcePath, m_fileSize, st.st_mtime);
+  }
+  if (!m_blockKey.empty() && !m_block)
+    m_block.reset(new char[CBlockCache::BLOCK_SIZE]);
+
   if (!m_pCache)
   {
+    bool segmented = false;
     if (g_advancedSettings.m_cacheMemSize == 0)
     {
       // Use cache on disk
@@ -201,17 +233,26 @@ bool CFileCache::Open(const CURL& url)
       size_t back = cacheSize / 4;
       size_t front = cacheSize - back;
       
-      if (m_flags & READ_MULTI_STREAM)
+      if (m_seekPossible > 0 && g_advancedSettings.m_cacheSegments > 1)
       {
-        // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
-        front /= 2;
-        back /= 2;
+        // segments share one budget, READ_MULTI_STREAM gets its own segments instead of double buffering
+        m_pCache = new CSegmentedCache(cacheSize, back, g_advancedSettings.m_cacheSegments);
+        segmented = true;
+      }
+      else
+      {
+        if (m_flags & READ_MULTI_STREAM)
+        {
+          // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
+          front /= 2;
+          back /= 2;
+        }
+        m_pCache = new CCircularCache(front, back);
       }
-      m_pCache = new CCircularCache(front, back);
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if ((m_flags & READ_MULTI_STREAM) && !segmented)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = new CDoubleCache(m_pCache);
@@ -230,6 +271,13 @@ bool CFileCache::Open(const CURL& url)
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+  m_cacheHits = 0;
+  m_cacheRequests = 0;
+  m_blockIndex = -1;
+  m_blockSize = 0;
+  m_blockCached = false;
+  m_blockPos = 0;
+  m_sourcePos = 0;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -270,7 +318,13 @@ void CFileCache::Process()
       int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
       cacheReachEOF = (cacheMaxPos == m_fileSize);
       bool sourceSeekFailed = false;
-      if (!cacheReachEOF)
+      if (!cacheReachEOF && !m_blockKey.empty())
+      {
+        // the source is only seeked once a block isn't found in the block cache
+        m_blockPos = cacheMaxPos;
+        m_nSeekResult = cacheMaxPos;
+      }
+      else if (!cacheReachEOF)
       {
         m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
         if (m_nSeekResult != cacheMaxPos)
@@ -326,7 +380,7 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+      iRead = ReadSource(buffer.get(), maxWrite);
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -449,17 +503,22 @@ ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
+  bool hit = true;
+
 retry:
   // attempt to read
   iRc = m_pCache->ReadFromCache((char *)lpBuf, (size_t)uiBufSize);
   if (iRc > 0)
   {
     m_readPos += iRc;
+    UpdateCacheStats(hit, false);
     return (int)iRc;
   }
 
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
+    hit = false;
+
     // just wait for some data to show up
     iRc = m_pCache->WaitForData(1, 10000);
     if (iRc > 0)
@@ -502,6 +561,8 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  UpdateCacheStats(m_pCache->IsCachedPosition(iTarget), true);
+
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
     if (m_seekPossible == 0)
@@ -537,11 +598,88 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   return m_nSeekResult;
 }
 
+/* Reads at most up to the end of the current block. Blocks found in
+ * CBlockCache are served from it, other blocks are read from the source and
+ * stored if they were read from their start and CBlockCache wants them.
+ */
+ssize_t CFileCache::ReadSource(char* buffer, size_t size)
+{
+  if (m_blockKey.empty())
+    return m_source.Read(buffer, size);
+
+  CBlockCache &blockCache = CBlockCache::GetInstance();
+  int64_t block = m_blockPos / CBlockCache::BLOCK_SIZE;
+  unsigned int offset = (unsigned int)(m_blockPos % CBlockCache::BLOCK_SIZE);
+  if (block != m_blockIndex)
+  {
+    m_blockIndex = block;
+    m_blockSize = blockCache.ReadBlock(m_blockKey, block, m_block.get());
+    m_blockCached = m_blockSize > 0;
+  }
+
+  if (m_blockCached && offset < m_blockSize)
+  {
+    size = std::min(size, (size_t)(m_blockSize - offset));
+    memcpy(buffer, m_block.get() + offset, size);
+    m_blockPos += size;
+    return size;
+  }
+  else if (m_blockCached && m_blockSize < CBlockCache::BLOCK_SIZE)
+    return 0; // end of the last block
+
+  if (m_sourcePos != m_blockPos)
+  {
+    m_sourcePos = m_source.Seek(m_blockPos, SEEK_SET);
+    if (m_sourcePos != m_blockPos)
+    {
+      CLog::Log(LOGERROR, "CFileCache::ReadSource - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_sourcePos);
+      return -1;
+    }
+  }
+
+  size = std::min(size, (size_t)(CBlockCache::BLOCK_SIZE - offset));
+  ssize_t iRead = m_source.Read(buffer, size);
+  if (iRead <= 0)
+    return iRead;
+
+  m_sourcePos += iRead;
+  m_blockPos += iRead;
+
+  if (!m_blockCached && offset == m_blockSize)
+  {
+    memcpy(m_block.get() + offset, buffer, iRead);
+    m_blockSize += iRead;
+    if ((m_blockSize == CBlockCache::BLOCK_SIZE || m_blockPos == m_fileSize) &&
+        CBlockCache::ShouldStore(block, m_fileSize))
+      m_blockCached = blockCache.WriteBlock(m_blockKey, block, m_block.get(), m_blockSize);
+  }
+
+  return iRead;
+}
+
+void CFileCache::UpdateCacheStats(bool hit, bool report)
+{
+  m_cacheRequests++;
+  if (hit)
+    m_cacheHits++;
+
+  // reads are only reported along with seeks and misses, no need to lock for every read
+  if ((m_flags & READ_AUDIO_VIDEO) && (report || !hit))
+    CServiceBroker::GetDataCacheCore().SetFileCacheStats(m_cacheHits, m_cacheRequests);
+}
+
 void CFileCache::Close()
 {
   StopThread();
 
   CSingleLock lock(m_sync);
+  if (m_cacheRequests > 0)
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Close - %" PRIu64" of %" PRIu64" reads and seeks served from cache", m_cacheHits, m_cacheRequests);
+    if (m_flags & READ_AUDIO_VIDEO)
+      CServiceBroker::GetDataCacheCore().SetFileCacheStats(m_cacheHits, m_cacheRequests);
+  }
+
   if (m_pCache)
     m_pCache->Close();
 
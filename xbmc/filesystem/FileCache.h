@@ -25,6 +25,7 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include <atomic>
+#include <memory>
 
 namespace XFILE
 {
@@ -63,6 +64,12 @@ namespace XFILE
     virtual std::string GetContentCharset(void);
 
   private:
+    /*! \brief Count a read or seek as served from cache or not, reporting to CDataCacheCore */
+    void UpdateCacheStats(bool hit, bool report);
+
+    /*! \brief Read from the source through the persistent block cache, if it's used for this file */
+    ssize_t ReadSource(char* buffer, size_t size);
+
     CCacheStrategy *m_pCache;
     bool      m_bDeleteCache;
     int        m_seekPossible;
@@ -80,6 +87,15 @@ namespace XFILE
     int64_t      m_forwardCacheSize;
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
+    uint64_t     m_cacheHits;
+    uint64_t     m_cacheRequests;
+    std::string  m_blockKey;        // key in CBlockCache, empty if not used
+    std::unique_ptr<char[]> m_block;
+    int64_t      m_blockIndex;      // block held in m_block
+    unsigned int m_blockSize;       // valid data in m_block
+    bool         m_blockCached;     // m_block was read from or written to CBlockCache
+    int64_t      m_blockPos;        // position of the next source read
+    int64_t      m_sourcePos;       // position of m_source, seeks are only done when needed
     CCriticalSection m_sync;
   };
 
@@ -127,6 +127,15 @@ public:
   */
   virtual DIR_CACHE_TYPE GetCacheType(const CURL& url) const { return DIR_CACHE_ONCE; };
 
+  /*!
+  \brief Whether the last listing returned size, modification time and type of all
+  items, so the directory cache can answer stat requests for them. The modification
+  time is the file's st_mtime in the "file:mtime" property of the items.
+  \param url Directory at hand.
+  \return Returns \e true if the items carry complete file info.
+  */
+  virtual bool HasFileInfo(const CURL& url) const { return false; }
+
   void SetMask(const std::string& strMask);
   void SetFlags(int flags);
 
@@ -125,6 +125,17 @@ public:
 
   virtual bool SkipNext(){return false;}
 
+  /**
+   * Copy data from another opened file to this one inside the kernel, without
+   * passing it through a userspace buffer. Both files are read and written at
+   * their current positions.
+   * @param source  file opened for reading, of the same implementation
+   * @param size    maximum number of bytes to copy
+   * @return number of bytes copied, 0 at the end of the source or -1 if the
+   *         files can't be copied this way (fall back to Read()/Write())
+   */
+  virtual ssize_t CopyFrom(IFile* source, size_t size) { return -1; }
+
   virtual bool Delete(const CURL& url) { return false; }
   virtual bool Rename(const CURL& url, const CURL& urlnew) { return false; }
   virtual bool SetHidden(const CURL& url, bool hidden) { return false; }
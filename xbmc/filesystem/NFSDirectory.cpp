@@ -42,6 +42,7 @@ using namespace XFILE;
 #include <nfsc/libnfs-raw-nfs.h>
 
 CNFSDirectory::CNFSDirectory(void)
+  : m_hasFileInfo(false)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -192,6 +193,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   std::string strDirName="";
   std::string myStrPath(url.Get());
   URIUtils::AddSlashAtEnd(myStrPath); //be sure the dir ends with a slash
+  m_hasFileInfo = false;
    
   if(!gNfsConnection.Connect(url,strDirName))
   {
@@ -224,6 +226,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
     return false;
   }
   lock.Leave();
+  m_hasFileInfo = true;
   
   while((nfsdirent = gNfsConnection.GetImpl()->nfs_readdir(gNfsConnection.GetNfsContext(), nfsdir)) != NULL) 
   {
@@ -266,6 +269,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
 
       CFileItemPtr pItem(new CFileItem(tmpDirent.name));
       pItem->m_dateTime=localTime;   
+      pItem->SetProperty("file:mtime", (int64_t)lTimeDate);
       pItem->m_dwSize = iSize;        
       
       if (bIsDir)
@@ -31,6 +31,7 @@ namespace XFILE
       virtual ~CNFSDirectory(void);
       virtual bool GetDirectory(const CURL& url, CFileItemList &items);
       virtual DIR_CACHE_TYPE GetCacheType(const CURL& url) const { return DIR_CACHE_ONCE; };
+      virtual bool HasFileInfo(const CURL& url) const { return m_hasFileInfo; }
       virtual bool Create(const CURL& url);
       virtual bool Exists(const CURL& url);
       virtual bool Remove(const CURL& url);
@@ -38,6 +39,8 @@ namespace XFILE
       bool GetServerList(CFileItemList &items);
       bool GetDirectoryFromExportList(const std::string& strPath, CFileItemList &items);
       bool ResolveSymlink( const std::string &dirName, struct nfsdirent *dirent, CURL &resolvedUrl);
+
+      bool m_hasFileInfo; // readdir returns the attributes of the entries, except for export lists
   };
 }
 
@@ -30,13 +30,20 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "network/DNSNameCache.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SystemClock.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <nfsc/libnfs-raw-mount.h>
 
 #ifdef TARGET_WINDOWS
 #include <fcntl.h>
 #include <sys\stat.h>
+#define poll WSAPoll
+#else
+#include <poll.h>
 #endif
 
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
@@ -53,6 +60,12 @@
 #define CONTEXT_NEW      1    //new context created
 #define CONTEXT_CACHED   2    //context cached and therefore already mounted (no new mount needed)
 
+//timeout in ms for a single wait on the nfs socket while async reads are pending
+#define READ_POLL_TIMEOUT 1000
+
+//timeout in ms for all async reads of one pipelined read, the connection is locked meanwhile
+#define READ_TIMEOUT 30000
+
 using namespace XFILE;
 
 CNfsConnection::CNfsConnection()
@@ -502,10 +515,52 @@ void CNfsConnection::AddIdleConnection()
 
 CNfsConnection gNfsConnection;
 
+namespace
+{
+struct SReadBatch;
+
+struct SReadRequest
+{
+  SReadBatch *batch;
+  char *buffer;
+  uint64_t size;
+  int result;
+  bool done;
+};
+
+//state of one pipelined read - owned by CNFSFile::ReadPipelined unless it had to
+//give up with requests still pending, then the last callback frees it
+struct SReadBatch
+{
+  std::vector<SReadRequest> requests;
+  int pending;
+  bool abandoned;
+};
+
+void ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data)
+{
+  SReadRequest *request = static_cast<SReadRequest*>(private_data);
+  SReadBatch *batch = request->batch;
+
+  if (!batch->abandoned)
+  {
+    request->result = err;
+    request->done = true;
+    if (err > 0)
+      memcpy(request->buffer, data, std::min<uint64_t>(err, request->size));
+  }
+
+  if (--batch->pending == 0 && batch->abandoned)
+    delete batch;
+}
+}
+
 CNFSFile::CNFSFile()
 : m_fileSize(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_readChunkSize(0)
+, m_readWindow(1)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -560,6 +615,7 @@ bool CNFSFile::Open(const CURL& url)
   
   m_pNfsContext = gNfsConnection.GetNfsContext(); 
   m_exportPath = gNfsConnection.GetContextMapId();
+  m_readChunkSize = gNfsConnection.GetMaxReadChunkSize();
   
   ret = gNfsConnection.GetImpl()->nfs_open(m_pNfsContext, filename.c_str(), O_RDONLY, &m_pFileHandle);
   
@@ -656,7 +712,10 @@ ssize_t CNFSFile::Read(void *lpBuf, size_t uiBufSize)
   if (m_pFileHandle == NULL || m_pNfsContext == NULL )
     return -1;
 
-  numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
+  if (m_readWindow > 1 && m_readChunkSize > 0 && uiBufSize > m_readChunkSize)
+    numberOfBytesRead = ReadPipelined((char *)lpBuf, uiBufSize);
+  else
+    numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
 
   lock.Leave();//no need to keep the connection lock after that
   
@@ -669,6 +728,118 @@ ssize_t CNFSFile::Read(void *lpBuf, size_t uiBufSize)
   return numberOfBytesRead;
 }
 
+//called with gNfsConnection locked - instead of waiting a full round trip
+//per chunk like nfs_read does, keep up to m_readWindow chunk requests in
+//flight and only wait for the answers. Afterwards the file position is
+//moved behind the bytes read, just like nfs_read would have done.
+ssize_t CNFSFile::ReadPipelined(char *buffer, size_t uiBufSize)
+{
+  DllLibNfs *pLibNfs = gNfsConnection.GetImpl();
+  uint64_t offset = 0;
+
+  if (pLibNfs->nfs_lseek(m_pNfsContext, m_pFileHandle, 0, SEEK_CUR, &offset) < 0)
+    return -1;
+
+  //no clamping to the size seen on open, the file may still be growing (recordings,
+  //downloads) - reads behind eof come back short and end the read
+  SReadBatch *batch = new SReadBatch;
+  batch->requests.resize((uiBufSize + m_readChunkSize - 1) / m_readChunkSize);
+  batch->pending = 0;
+  batch->abandoned = false;
+
+  XbmcThreads::EndTime endTime(READ_TIMEOUT);
+  size_t next = 0;
+  bool failed = false;
+  bool shortRead = false;
+  while (!failed && (next < batch->requests.size() || batch->pending > 0))
+  {
+    if (endTime.IsTimePast())
+    {
+      CLog::Log(LOGERROR, "NFS: Timed out waiting for %d reads", batch->pending);
+      failed = true;
+      break;
+    }
+
+    //stop issuing new requests once a chunk came back short or failed
+    for (size_t i = 0; i < next && !shortRead; i++)
+      shortRead = batch->requests[i].done && (batch->requests[i].result < 0 || (uint64_t)batch->requests[i].result < batch->requests[i].size);
+
+    while (!shortRead && next < batch->requests.size() && batch->pending < m_readWindow)
+    {
+      SReadRequest &request = batch->requests[next];
+      request.batch = batch;
+      request.buffer = buffer + next * m_readChunkSize;
+      request.size = std::min<uint64_t>(m_readChunkSize, uiBufSize - next * m_readChunkSize);
+      request.result = 0;
+      request.done = false;
+
+      if (pLibNfs->nfs_pread_async(m_pNfsContext, m_pFileHandle, offset + next * m_readChunkSize,
+                                   request.size, ReadCallback, &request) != 0)
+      {
+        CLog::Log(LOGERROR, "NFS: Failed to queue read - %s", pLibNfs->nfs_get_error(m_pNfsContext));
+        request.result = -1;
+        request.done = true;
+        failed = true;
+        break;
+      }
+      batch->pending++;
+      next++;
+    }
+
+    if (batch->pending == 0)
+      break;
+
+    struct pollfd pfd;
+    pfd.fd = pLibNfs->nfs_get_fd(m_pNfsContext);
+    pfd.events = pLibNfs->nfs_which_events(m_pNfsContext);
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, std::min<unsigned int>(READ_POLL_TIMEOUT, endTime.MillisLeft())) < 0 && errno != EINTR)
+    {
+      CLog::Log(LOGERROR, "NFS: poll failed while reading (%d)", errno);
+      failed = true;
+    }
+    else if (pLibNfs->nfs_service(m_pNfsContext, pfd.revents) < 0)
+    {
+      CLog::Log(LOGERROR, "NFS: Failed to service context while reading - %s", pLibNfs->nfs_get_error(m_pNfsContext));
+      failed = true;
+    }
+  }
+
+  //only bytes up to the first short or failed chunk are handed out
+  ssize_t numberOfBytesRead = 0;
+  for (size_t i = 0; i < next; i++)
+  {
+    const SReadRequest &request = batch->requests[i];
+    if (!request.done)
+      break;
+    if (request.result < 0)
+    {
+      if (numberOfBytesRead == 0)
+        numberOfBytesRead = -1;
+      break;
+    }
+    numberOfBytesRead += request.result;
+    if ((uint64_t)request.result < request.size)
+      break;
+  }
+
+  if (batch->pending > 0)
+  {
+    //requests are still owned by libnfs, the last callback cleans up
+    batch->abandoned = true;
+    if (numberOfBytesRead == 0)
+      numberOfBytesRead = -1;
+  }
+  else
+    delete batch;
+
+  if (numberOfBytesRead > 0)
+    pLibNfs->nfs_lseek(m_pNfsContext, m_pFileHandle, offset + numberOfBytesRead, SEEK_SET, &offset);
+
+  return numberOfBytesRead;
+}
+
 int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
 {
   int ret = 0;
@@ -687,6 +858,28 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
   return (int64_t)offset;
 }
 
+int CNFSFile::IoControl(EIoControl request, void* param)
+{
+  if (request == IOCTRL_SEEK_POSSIBLE)
+    return 1;
+
+  //a cache reads big blocks sequentially - let it pipeline them
+  if (request == IOCTRL_SET_CACHE)
+  {
+    m_readWindow = std::max(g_advancedSettings.m_nfsReadWindow, 1);
+    return 0;
+  }
+
+  return -1;
+}
+
+int CNFSFile::GetChunkSize()
+{
+  if (m_readWindow > 1 && m_readChunkSize > 0)
+    return (int)std::min<uint64_t>(m_readChunkSize * m_readWindow, INT_MAX);
+  return 1;
+}
+
 int CNFSFile::Truncate(int64_t iSize)
 {
   int ret = 0;
@@ -725,6 +918,8 @@ void CNFSFile::Close()
     m_pNfsContext = NULL;    
     m_fileSize = 0;
     m_exportPath.clear();
+    m_readChunkSize = 0;
+    m_readWindow = 1;
   }
 }
 
@@ -146,8 +146,9 @@ namespace XFILE
 
     //implement iocontrol for seek_possible for preventing the stat in File class for
     //getting this info ...
-    virtual int IoControl(EIoControl request, void* param){ if(request == IOCTRL_SEEK_POSSIBLE) return 1;return -1;};    
-    virtual int  GetChunkSize() {return 1;}
+    virtual int IoControl(EIoControl request, void* param);
+    //returns the size of a full read window once a cache is attached
+    virtual int  GetChunkSize();
     
     virtual bool OpenForWrite(const CURL& url, bool bOverWrite = false);
     virtual bool Delete(const CURL& url);
@@ -159,6 +160,12 @@ namespace XFILE
     struct nfsfh  *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context
     std::string m_exportPath;
+    uint64_t m_readChunkSize;//read chunksize of the server this file lives on
+    int m_readWindow;//number of reads kept in flight, 1 reads synchronously
+
+    //reads uiBufSize bytes from the current position, split into chunks
+    //of m_readChunkSize with up to m_readWindow async requests pending
+    ssize_t ReadPipelined(char *buffer, size_t uiBufSize);
   };
 }
 #endif // FILENFS_H_
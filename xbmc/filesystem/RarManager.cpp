@@ -20,9 +20,11 @@
 
 #include "system.h"
 #include "Application.h"
+#include "ArchiveIndexCache.h"
 #include "RarManager.h"
 #include "Util.h"
 #include "utils/CharsetConverter.h"
+#include "utils/Crc32.h"
 #include "utils/URIUtils.h"
 #include "threads/SingleLock.h"
 #include "Directory.h"
@@ -36,9 +38,11 @@
 #include "dialogs/GUIDialogYesNo.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/GUIWindowManager.h"
+#include "utils/Archive.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <inttypes.h>
 #include <set>
 
 #ifdef TARGET_POSIX
@@ -304,19 +308,8 @@ bool CRarManager::GetFilesInRar(CFileItemList& vecpItems, const std::string& str
   CSingleLock lock(m_CritSection);
 
   ArchiveList_struct* pFileList = NULL;
-  std::map<std::string, std::pair<ArchiveList_struct*, std::vector<CFileInfo> > >::iterator it = m_ExFiles.find(strRarPath);
-  if (it == m_ExFiles.end())
-  {
-    if( urarlib_list((char*) strRarPath.c_str(), &pFileList, NULL) )
-      m_ExFiles.insert(std::make_pair(strRarPath, std::make_pair(pFileList, std::vector<CFileInfo>())));
-    else
-    {
-      if( pFileList ) urarlib_freelist(pFileList);
-      return false;
-    }
-  }
-  else
-    pFileList = it->second.first;
+  if (!GetArchiveList(lock, strRarPath, pFileList))
+    return false;
 
   CFileItemPtr pFileItem;
   std::vector<std::string> vec;
@@ -397,15 +390,207 @@ bool CRarManager::GetFilesInRar(CFileItemList& vecpItems, const std::string& str
 #endif
 }
 
+#ifdef HAS_FILESYSTEM_RAR
+/* Returns the name of the volume following a volume of a multi volume
+ * archive, e.g. name.part2.rar after name.part1.rar or name.r00 after
+ * name.rar, empty if the name isn't one of a volume.
+ */
+static std::string GetNextVolume(const std::string& strVolume)
+{
+  size_t ext = strVolume.rfind('.');
+  if (ext == std::string::npos)
+    return "";
+
+  std::string strExt = strVolume.substr(ext + 1);
+  if (StringUtils::EqualsNoCase(strExt, "rar"))
+  {
+    std::string strLower = strVolume.substr(0, ext);
+    StringUtils::ToLower(strLower);
+    size_t part = strLower.rfind(".part");
+    if (part != std::string::npos && part + 5 < ext &&
+        strLower.find_first_not_of("0123456789", part + 5) == std::string::npos)
+    {
+      int width = ext - part - 5;
+      int number = atoi(strLower.c_str() + part + 5) + 1;
+      return strVolume.substr(0, part + 5) + StringUtils::Format("%0*d", width, number) + strVolume.substr(ext);
+    }
+    return strVolume.substr(0, ext) + ".r00";
+  }
+
+  // old style numbering: .r00 to .r99, then .s00 and so on
+  if (strExt.size() != 3 || !isalpha((unsigned char)strExt[0]) ||
+      !isdigit((unsigned char)strExt[1]) || !isdigit((unsigned char)strExt[2]))
+    return "";
+
+  char letter = strExt[0];
+  int number = atoi(strExt.c_str() + 1) + 1;
+  if (number == 100)
+  {
+    number = 0;
+    if (!isalpha((unsigned char)++letter))
+      return "";
+  }
+  return strVolume.substr(0, ext) + StringUtils::Format(".%c%02d", letter, number);
+}
+
+/* Multi volume archives are identified by their first volume, but their
+ * listing changes with any of their volumes. The key covers all volumes
+ * found, so a listing made while volumes were missing or still being
+ * written isn't used once they are complete.
+ */
+static std::string GetIndexKey(const std::string& strRarPath)
+{
+  struct __stat64 buffer = {};
+  if (CFile::Stat(strRarPath, &buffer, true) != 0)
+    return "";
+
+  std::string key = CArchiveIndexCache::GetKey(strRarPath, buffer.st_size, buffer.st_mtime);
+  if (key.empty())
+    return key;
+
+  std::string strVolumes;
+  for (std::string strVolume = GetNextVolume(strRarPath); !strVolume.empty(); strVolume = GetNextVolume(strVolume))
+  {
+    if (CFile::Stat(strVolume, &buffer, true) != 0)
+      break;
+    strVolumes += StringUtils::Format("%" PRId64 ":%" PRId64 ";", (int64_t)buffer.st_size, (int64_t)buffer.st_mtime);
+  }
+  if (!strVolumes.empty())
+    key += StringUtils::Format("-%08x", Crc32::Compute(strVolumes));
+  return key;
+}
+
+static void StoreIndex(CArchive& ar, const ArchiveList_struct* pArchiveList)
+{
+  unsigned int count = 0;
+  for (const ArchiveList_struct* pIterator = pArchiveList; pIterator; pIterator = pIterator->next)
+    count++;
+
+  ar << count;
+  for (const ArchiveList_struct* pIterator = pArchiveList; pIterator; pIterator = pIterator->next)
+  {
+    const RAR20_archive_entry& item = pIterator->item;
+    ar << std::string(item.Name) << std::wstring(item.NameW ? item.NameW : L"");
+    ar << item.PackSize << item.UnpSize << (char)item.HostOS << item.FileCRC << item.FileTime;
+    ar << (char)item.UnpVer << (char)item.Method << item.FileAttr << item.iOffset;
+  }
+}
+
+/* Builds the list the way urarlib_list() does, so that urarlib_freelist()
+ * can free it.
+ */
+static bool LoadIndex(CArchive& ar, ArchiveList_struct* &pArchiveList)
+{
+  unsigned int count = 0;
+  ar >> count;
+
+  ArchiveList_struct* pPrev = NULL;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string strName;
+    std::wstring strNameW;
+    char hostOS, unpVer, method;
+    ArchiveList_struct* pCurr = (ArchiveList_struct*)calloc(1, sizeof(ArchiveList_struct));
+    if (!pCurr)
+      return false;
+    if (pPrev)
+      pPrev->next = pCurr;
+    else
+      pArchiveList = pCurr;
+    pPrev = pCurr;
+
+    RAR20_archive_entry& item = pCurr->item;
+    ar >> strName >> strNameW;
+    ar >> item.PackSize >> item.UnpSize >> hostOS >> item.FileCRC >> item.FileTime;
+    ar >> unpVer >> method >> item.FileAttr >> item.iOffset;
+    item.HostOS = hostOS;
+    item.UnpVer = unpVer;
+    item.Method = method;
+    item.NameSize = strName.size();
+    item.Name = (char*)malloc(strName.size() + 1);
+    item.NameW = (wchar_t*)malloc((strNameW.size() + 1) * sizeof(wchar_t));
+    if (!item.Name || !item.NameW)
+      return false;
+    memcpy(item.Name, strName.c_str(), strName.size() + 1);
+    memcpy(item.NameW, strNameW.c_str(), (strNameW.size() + 1) * sizeof(wchar_t));
+  }
+  return count > 0;
+}
+#endif
+
 bool CRarManager::ListArchive(const std::string& strRarPath, ArchiveList_struct* &pArchiveList)
 {
 #ifdef HAS_FILESYSTEM_RAR
- return urarlib_list((char*) strRarPath.c_str(), &pArchiveList, NULL) == 1;
+  CArchiveIndexCache& indexCache = CArchiveIndexCache::GetInstance();
+  std::string key = GetIndexKey(strRarPath);
+  pArchiveList = NULL;
+  if (indexCache.Load(key, strRarPath, [&pArchiveList](CArchive& ar) { return LoadIndex(ar, pArchiveList); }))
+    return true;
+
+  if (pArchiveList)
+    urarlib_freelist(pArchiveList);
+  pArchiveList = NULL;
+
+  if (urarlib_list((char*) strRarPath.c_str(), &pArchiveList, NULL) > 0)
+  {
+    indexCache.Store(key, strRarPath, [pArchiveList](CArchive& ar) { StoreIndex(ar, pArchiveList); });
+    return true;
+  }
+
+  if (pArchiveList)
+    urarlib_freelist(pArchiveList);
+  pArchiveList = NULL;
+  return false;
 #else
- return false;
+  return false;
 #endif
 }
 
+/* Returns the listing of an archive, listing it if needed. The lock is held
+ * on entry and exit but not while the archive is read, so that several
+ * archives can be listed at the same time.
+ */
+bool CRarManager::GetArchiveList(CSingleLock& lock, const std::string& strRarPath, ArchiveList_struct* &pArchiveList)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  std::map<std::string, std::pair<ArchiveList_struct*, std::vector<CFileInfo> > >::iterator it = m_ExFiles.find(strRarPath);
+  if (it != m_ExFiles.end())
+  {
+    pArchiveList = it->second.first;
+    return true;
+  }
+
+  ArchiveList_struct* pFileList = NULL;
+  lock.Leave();
+  bool bListed = ListArchive(strRarPath, pFileList);
+  lock.Enter();
+  if (!bListed)
+    return false;
+
+  // listed by another thread meanwhile
+  it = m_ExFiles.find(strRarPath);
+  if (it != m_ExFiles.end())
+  {
+    urarlib_freelist(pFileList);
+    pArchiveList = it->second.first;
+    return true;
+  }
+
+  m_ExFiles.insert(std::make_pair(strRarPath, std::make_pair(pFileList, std::vector<CFileInfo>())));
+  pArchiveList = pFileList;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool CRarManager::IndexArchive(const std::string& strRarPath)
+{
+  CSingleLock lock(m_CritSection);
+  ArchiveList_struct* pArchiveList = NULL;
+  return GetArchiveList(lock, strRarPath, pArchiveList);
+}
+
 CFileInfo* CRarManager::GetFileInRar(const std::string& strRarPath, const std::string& strPathInRar)
 {
 #ifdef HAS_FILESYSTEM_RAR
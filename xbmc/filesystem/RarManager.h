@@ -30,6 +30,7 @@
 #include "utils/GlobalsHandling.h"
 
 class CFileItemList;
+class CSingleLock;
 
 #define EXFILE_OVERWRITE 1
 #define EXFILE_AUTODELETE 2
@@ -75,12 +76,15 @@ public:
                      bool bMask=true, const std::string& strPathInRar="");
   CFileInfo* GetFileInRar(const std::string& strRarPath, const std::string& strPathInRar);
   bool IsFileInRar(bool& bResult, const std::string& strRarPath, const std::string& strPathInRar);
+  /*! \brief List an archive ahead of its first use, see CArchiveIndexCache::IndexArchives. */
+  bool IndexArchive(const std::string& strRarPath);
   void ClearCache(bool force=false);
   void ClearCachedFile(const std::string& strRarPath, const std::string& strPathInRar);
   void ExtractArchive(const std::string& strArchive, const std::string& strPath);
 protected:
 
   bool ListArchive(const std::string& strRarPath, ArchiveList_struct* &pArchiveList);
+  bool GetArchiveList(CSingleLock& lock, const std::string& strRarPath, ArchiveList_struct* &pArchiveList);
   std::map<std::string, std::pair<ArchiveList_struct*,std::vector<CFileInfo> > > m_ExFiles;
   CCriticalSection m_CritSection;
 
@@ -51,11 +51,16 @@ struct CachedDirEntry
 {
   unsigned int type;
   std::string name;
+  bool hasInfo; // size, time and hidden are valid, no stat needed
+  int64_t size;
+  int64_t time;
+  bool hidden;
 };
 
 using namespace XFILE;
 
 CSMBDirectory::CSMBDirectory(void)
+  : m_hasFileInfo(false)
 {
   smb.AddActiveConnection();
 }
@@ -94,13 +99,48 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   std::vector<CachedDirEntry> vecEntries;
   struct smbc_dirent* dirEnt;
 
+  // inside a share the attributes can be listed along with the names,
+  // saving a stat and a getxattr round trip per entry
+#ifdef HAVE_SMBC_READDIRPLUS
+  const bool readDirPlus = !url.GetShareName().empty();
+#else
+  const bool readDirPlus = false;
+#endif
+  m_hasFileInfo = readDirPlus || ((m_flags & DIR_FLAG_NO_FILE_INFO) == 0 && g_advancedSettings.m_sambastatfiles && !url.GetShareName().empty());
+
   lock.Enter();
-  while ((dirEnt = smbc_readdir(fd)))
+#ifdef HAVE_SMBC_READDIRPLUS
+  if (readDirPlus)
+  {
+    const struct libsmb_file_info* info;
+    while ((info = smbc_readdirplus(fd)))
+    {
+      CachedDirEntry aDir;
+      aDir.type = (info->attrs & SMBC_DOS_MODE_DIRECTORY) ? SMBC_DIR : SMBC_FILE;
+      aDir.name = info->name;
+      aDir.hasInfo = true;
+      aDir.size = info->size;
+      aDir.time = info->mtime_ts.tv_sec;
+      if (aDir.time == 0) // if modification date is missing, use create date
+        aDir.time = info->ctime_ts.tv_sec;
+      aDir.hidden = (info->attrs & SMBC_DOS_MODE_HIDDEN) != 0;
+      vecEntries.push_back(aDir);
+    }
+  }
+  else
+#endif
   {
-    CachedDirEntry aDir;
-    aDir.type = dirEnt->smbc_type;
-    aDir.name = dirEnt->name;
-    vecEntries.push_back(aDir);
+    while ((dirEnt = smbc_readdir(fd)))
+    {
+      CachedDirEntry aDir;
+      aDir.type = dirEnt->smbc_type;
+      aDir.name = dirEnt->name;
+      aDir.hasInfo = false;
+      aDir.size = 0;
+      aDir.time = 0;
+      aDir.hidden = false;
+      vecEntries.push_back(aDir);
+    }
   }
   smbc_closedir(fd);
   lock.Leave();
@@ -127,9 +167,17 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       if (StringUtils::StartsWith(strFile, "."))
         hidden = true;
 
+      if (aDir.hasInfo)
+      {
+        bIsDir = (aDir.type == SMBC_DIR);
+        lTimeDate = aDir.time;
+        iSize = aDir.size;
+        if (aDir.hidden)
+          hidden = true;
+      }
       // only stat files that can give proper responses
-      if ( aDir.type == SMBC_FILE ||
-           aDir.type == SMBC_DIR )
+      else if ( aDir.type == SMBC_FILE ||
+                aDir.type == SMBC_DIR )
       {
         // set this here to if the stat should fail
         bIsDir = (aDir.type == SMBC_DIR);
@@ -194,6 +242,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->SetPath(path);
         pItem->m_bIsFolder = true;
         pItem->m_dateTime=localTime;
+        pItem->SetProperty("file:mtime", (int64_t)lTimeDate);
         if (hidden)
           pItem->SetProperty("file:hidden", true);
         items.Add(pItem);
@@ -205,6 +254,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->m_bIsFolder = false;
         pItem->m_dwSize = iSize;
         pItem->m_dateTime=localTime;
+        pItem->SetProperty("file:mtime", (int64_t)lTimeDate);
         if (hidden)
           pItem->SetProperty("file:hidden", true);
         items.Add(pItem);
@@ -32,6 +32,7 @@ public:
   virtual ~CSMBDirectory(void);
   virtual bool GetDirectory(const CURL& url, CFileItemList &items);
   virtual DIR_CACHE_TYPE GetCacheType(const CURL& url) const { return DIR_CACHE_ONCE; };
+  virtual bool HasFileInfo(const CURL& url) const { return m_hasFileInfo; }
   virtual bool Create(const CURL& url);
   virtual bool Exists(const CURL& url);
   virtual bool Remove(const CURL& url);
@@ -40,5 +41,7 @@ public:
 
 private:
   int OpenDir(const CURL &url, std::string& strAuth);
+
+  bool m_hasFileInfo;
 };
 }
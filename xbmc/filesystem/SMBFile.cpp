@@ -60,6 +60,96 @@ SMBCSRV* xb_smbc_cache(SMBCCTX* c, const char* server, const char* share, const
   return orig_cache(c, server, share, workgroup, username);
 }
 
+/* maximum number of unused session contexts kept for reuse */
+#define SMB_MAX_IDLE_CONTEXTS 4
+
+/* Calls on the per-file contexts only need to be serialized if libsmbclient
+   isn't able to handle different contexts from different threads */
+class CSMBContextLock
+{
+public:
+#ifdef HAVE_SMBC_THREAD_POSIX
+  CSMBContextLock() {}
+#else
+  CSMBContextLock() : m_lock(smb) {}
+private:
+  CSingleLock m_lock;
+#endif
+};
+
+/* wrappers around the context function table of both samba interfaces */
+static SMBCFILE *smb_open(SMBCCTX *context, const char *fname, int flags, mode_t mode)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionOpen(context)(context, fname, flags, mode);
+#else
+  return context->open(context, fname, flags, mode);
+#endif
+}
+
+static SMBCFILE *smb_creat(SMBCCTX *context, const char *fname, mode_t mode)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionCreat(context)(context, fname, mode);
+#else
+  return context->creat(context, fname, mode);
+#endif
+}
+
+static ssize_t smb_read(SMBCCTX *context, SMBCFILE *file, void *buf, size_t count)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionRead(context)(context, file, buf, count);
+#else
+  return context->read(context, file, buf, count);
+#endif
+}
+
+static ssize_t smb_write(SMBCCTX *context, SMBCFILE *file, const void *buf, size_t count)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionWrite(context)(context, file, buf, count);
+#else
+  return context->write(context, file, (void*)buf, count);
+#endif
+}
+
+static off_t smb_lseek(SMBCCTX *context, SMBCFILE *file, off_t offset, int whence)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionLseek(context)(context, file, offset, whence);
+#else
+  return context->lseek(context, file, offset, whence);
+#endif
+}
+
+static int smb_stat(SMBCCTX *context, const char *fname, struct stat *st)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionStat(context)(context, fname, st);
+#else
+  return context->stat(context, fname, st);
+#endif
+}
+
+static int smb_fstat(SMBCCTX *context, SMBCFILE *file, struct stat *st)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionFstat(context)(context, file, st);
+#else
+  return context->fstat(context, file, st);
+#endif
+}
+
+static int smb_close(SMBCCTX *context, SMBCFILE *file)
+{
+#ifdef DEPRECATED_SMBC_INTERFACE
+  return smbc_getFunctionClose(context)(context, file);
+#else
+  return context->close_fn(context, file);
+#endif
+}
+
 bool CSMB::IsFirstInit = true;
 
 CSMB::CSMB()
@@ -80,6 +170,8 @@ void CSMB::Deinit()
 {
   CSingleLock lock(*this);
 
+  FreeIdleContexts();
+
   /* samba goes loco if deinited while it has some files opened */
   if (m_context)
   {
@@ -148,39 +240,15 @@ void CSMB::Init()
     // 48 bytes -> smb_xmalloc_array
     // 32 bytes -> set_param_opt
     // 16 bytes -> set_param_opt
-    smbc_init(xb_smbc_auth, 0);
-
-    // setup our context
-    m_context = smbc_new_context();
-#ifdef DEPRECATED_SMBC_INTERFACE
-    smbc_setDebug(m_context, g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
-    smbc_setFunctionAuthData(m_context, xb_smbc_auth);
-    orig_cache = smbc_getFunctionGetCachedServer(m_context);
-    smbc_setFunctionGetCachedServer(m_context, xb_smbc_cache);
-    smbc_setOptionOneSharePerServer(m_context, false);
-    smbc_setOptionBrowseMaxLmbCount(m_context, 0);
-    smbc_setTimeout(m_context, g_advancedSettings.m_sambaclienttimeout * 1000);
-    // we do not need to strdup these, smbc_setXXX below will make their own copies
-    if (CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).length() > 0)
-      smbc_setWorkgroup(m_context, (char*)CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).c_str());
-    std::string guest = "guest";
-    smbc_setUser(m_context, (char*)guest.c_str());
-#else
-    m_context->debug = (g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
-    m_context->callbacks.auth_fn = xb_smbc_auth;
-    orig_cache = m_context->callbacks.get_cached_srv_fn;
-    m_context->callbacks.get_cached_srv_fn = xb_smbc_cache;
-    m_context->options.one_share_per_server = false;
-    m_context->options.browse_max_lmb_count = 0;
-    m_context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
-    // we need to strdup these, they will get free'ed on smbc_free_context
-    if (CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).length() > 0)
-      m_context->workgroup = strdup(CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).c_str());
-    m_context->user = strdup("guest");
+#ifdef HAVE_SMBC_THREAD_POSIX
+    // allow the contexts of different files to be used from different threads
+    smbc_thread_posix();
 #endif
+    smbc_init(xb_smbc_auth, 0);
 
-    // initialize samba and do some hacking into the settings
-    if (smbc_init_context(m_context))
+    // setup and initialize our context
+    m_context = CreateContext();
+    if (m_context)
     {
       // setup context using the smb old interface compatibility
       SMBCCTX *old_context = smbc_set_context(m_context);
@@ -196,15 +264,91 @@ void CSMB::Init()
         IsFirstInit = false;
       }
     }
-    else
-    {
-      smbc_free_context(m_context, 1);
-      m_context = NULL;
-    }
   }
   m_IdleTimeout = 180;
 }
 
+SMBCCTX *CSMB::CreateContext()
+{
+  SMBCCTX *context = smbc_new_context();
+  if (!context)
+    return NULL;
+
+#ifdef DEPRECATED_SMBC_INTERFACE
+  smbc_setDebug(context, g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
+  smbc_setFunctionAuthData(context, xb_smbc_auth);
+  orig_cache = smbc_getFunctionGetCachedServer(context);
+  smbc_setFunctionGetCachedServer(context, xb_smbc_cache);
+  smbc_setOptionOneSharePerServer(context, false);
+  smbc_setOptionBrowseMaxLmbCount(context, 0);
+  smbc_setTimeout(context, g_advancedSettings.m_sambaclienttimeout * 1000);
+  // we do not need to strdup these, smbc_setXXX below will make their own copies
+  if (CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).length() > 0)
+    smbc_setWorkgroup(context, (char*)CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).c_str());
+  std::string guest = "guest";
+  smbc_setUser(context, (char*)guest.c_str());
+#else
+  context->debug = (g_advancedSettings.CanLogComponent(LOGSAMBA) ? 10 : 0);
+  context->callbacks.auth_fn = xb_smbc_auth;
+  orig_cache = context->callbacks.get_cached_srv_fn;
+  context->callbacks.get_cached_srv_fn = xb_smbc_cache;
+  context->options.one_share_per_server = false;
+  context->options.browse_max_lmb_count = 0;
+  context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
+  // we need to strdup these, they will get free'ed on smbc_free_context
+  if (CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).length() > 0)
+    context->workgroup = strdup(CSettings::GetInstance().GetString(CSettings::SETTING_SMB_WORKGROUP).c_str());
+  context->user = strdup("guest");
+#endif
+
+  if (!smbc_init_context(context))
+  {
+    smbc_free_context(context, 1);
+    return NULL;
+  }
+
+  return context;
+}
+
+SMBCCTX *CSMB::AcquireContext()
+{
+  Init();
+
+  CSingleLock lock(*this);
+  if (!m_idleContexts.empty())
+  {
+    SMBCCTX *context = m_idleContexts.back();
+    m_idleContexts.pop_back();
+    return context;
+  }
+
+  SMBCCTX *context = CreateContext();
+  if (!context)
+    CLog::Log(LOGERROR, "%s - unable to create samba context", __FUNCTION__);
+
+  return context;
+}
+
+void CSMB::ReleaseContext(SMBCCTX *context)
+{
+  if (!context)
+    return;
+
+  CSingleLock lock(*this);
+  /* keep the context, and with it its server connections, for the next file */
+  if (m_context && m_idleContexts.size() < SMB_MAX_IDLE_CONTEXTS)
+    m_idleContexts.push_back(context);
+  else
+    smbc_free_context(context, 1);
+}
+
+void CSMB::FreeIdleContexts()
+{
+  for (std::vector<SMBCCTX*>::iterator it = m_idleContexts.begin(); it != m_idleContexts.end(); ++it)
+    smbc_free_context(*it, 1);
+  m_idleContexts.clear();
+}
+
 std::string CSMB::URLEncode(const CURL &url)
 {
   /* due to smb wanting encoded urls we have to build it manually */
@@ -302,7 +446,8 @@ CSMB smb;
 CSMBFile::CSMBFile()
 {
   smb.Init();
-  m_fd = -1;
+  m_context = NULL;
+  m_file = NULL;
   smb.AddActiveConnection();
   m_allowRetry = true;
 }
@@ -315,15 +460,15 @@ CSMBFile::~CSMBFile()
 
 int64_t CSMBFile::GetPosition()
 {
-  if (m_fd == -1)
+  if (!m_file)
     return -1;
-  CSingleLock lock(smb);
-  return smbc_lseek(m_fd, 0, SEEK_CUR);
+  CSMBContextLock lock;
+  return smb_lseek(m_context, m_file, 0, SEEK_CUR);
 }
 
 int64_t CSMBFile::GetLength()
 {
-  if (m_fd == -1)
+  if (!m_file)
     return -1;
   return m_fileSize;
 }
@@ -346,34 +491,34 @@ bool CSMBFile::Open(const CURL& url)
   // listed, which will create lot's of open sessions.
 
   std::string strFileName;
-  m_fd = OpenFile(url, strFileName);
+  OpenFile(url, strFileName);
 
-  CLog::Log(LOGDEBUG,"CSMBFile::Open - opened %s, fd=%d",url.GetRedacted().c_str(), m_fd);
-  if (m_fd == -1)
+  CLog::Log(LOGDEBUG,"CSMBFile::Open - opened %s, file=%p",url.GetRedacted().c_str(), (void*)m_file);
+  if (!m_file)
   {
     // write error to logfile
     CLog::Log(LOGINFO, "SMBFile->Open: Unable to open file : '%s'\nunix_err:'%x' error : '%s'", CURL::GetRedacted(strFileName).c_str(), errno, strerror(errno));
     return false;
   }
 
-  CSingleLock lock(smb);
   struct stat tmpBuffer;
-  if (smbc_stat(strFileName.c_str(), &tmpBuffer) < 0)
+  int64_t ret;
   {
-    smbc_close(m_fd);
-    m_fd = -1;
-    return false;
+    CSMBContextLock lock;
+    if (smb_stat(m_context, strFileName.c_str(), &tmpBuffer) < 0)
+      ret = -1;
+    else
+      ret = smb_lseek(m_context, m_file, 0, SEEK_SET);
   }
 
-  m_fileSize = tmpBuffer.st_size;
-
-  int64_t ret = smbc_lseek(m_fd, 0, SEEK_SET);
   if ( ret < 0 )
   {
-    smbc_close(m_fd);
-    m_fd = -1;
+    Close();
     return false;
   }
+
+  m_fileSize = tmpBuffer.st_size;
+
   // We've successfully opened the file!
   return true;
 }
@@ -404,23 +549,27 @@ int CSMBFile::OpenFile(std::string& strAuth)
 }
 */
 
-int CSMBFile::OpenFile(const CURL &url, std::string& strAuth)
+bool CSMBFile::OpenFile(const CURL &url, std::string& strAuth)
 {
-  int fd = -1;
-  smb.Init();
-
   strAuth = GetAuthenticatedPath(url);
-  std::string strPath = strAuth;
+
+  m_context = smb.AcquireContext();
+  if (!m_context)
+    return false;
 
   {
-    CSingleLock lock(smb);
-    fd = smbc_open(strPath.c_str(), O_RDONLY, 0);
+    CSMBContextLock lock;
+    m_file = smb_open(m_context, strAuth.c_str(), O_RDONLY, 0);
   }
 
-  if (fd >= 0)
-    strAuth = strPath;
+  if (!m_file)
+  {
+    smb.ReleaseContext(m_context);
+    m_context = NULL;
+    return false;
+  }
 
-  return fd;
+  return true;
 }
 
 bool CSMBFile::Exists(const CURL& url)
@@ -429,46 +578,46 @@ bool CSMBFile::Exists(const CURL& url)
   // if a file matches the if below return false, it can't exist on a samba share.
   if (!IsValidFile(url.GetFileName())) return false;
 
-  smb.Init();
-  std::string strFileName = GetAuthenticatedPath(url);
-
-  struct stat info;
-
-  CSingleLock lock(smb);
-  int iResult = smbc_stat(strFileName.c_str(), &info);
-
-  if (iResult < 0) return false;
-  return true;
+  struct __stat64 info;
+  return Stat(url, &info) == 0;
 }
 
 int CSMBFile::Stat(struct __stat64* buffer)
 {
-  if (m_fd == -1)
+  if (!m_file)
     return -1;
 
   struct stat tmpBuffer = {0};
 
-  CSingleLock lock(smb);
-  int iResult = smbc_fstat(m_fd, &tmpBuffer);
+  CSMBContextLock lock;
+  int iResult = smb_fstat(m_context, m_file, &tmpBuffer);
   CUtil::StatToStat64(buffer, &tmpBuffer);
   return iResult;
 }
 
 int CSMBFile::Stat(const CURL& url, struct __stat64* buffer)
 {
-  smb.Init();
   std::string strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
+
+  SMBCCTX *context = smb.AcquireContext();
+  if (!context)
+    return -1;
 
   struct stat tmpBuffer = {0};
-  int iResult = smbc_stat(strFileName.c_str(), &tmpBuffer);
+  int iResult;
+  {
+    CSMBContextLock lock;
+    iResult = smb_stat(context, strFileName.c_str(), &tmpBuffer);
+  }
+  smb.ReleaseContext(context);
+
   CUtil::StatToStat64(buffer, &tmpBuffer);
   return iResult;
 }
 
 int CSMBFile::Truncate(int64_t size)
 {
-  if (m_fd == -1) return 0;
+  if (!m_file) return 0;
 /* 
  * This would force us to be dependant on SMBv3.2 which is GPLv3
  * This is only used by the TagLib writers, which are not currently in use
@@ -490,7 +639,7 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
-  if (m_fd == -1)
+  if (!m_file)
     return -1;
 
   // Some external libs (libass) use test read with zero size and 
@@ -501,7 +650,7 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if (uiBufSize == 0 && lpBuf == NULL)
     return 0;
 
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
+  CSMBContextLock lock; // Init not called since it has to be "inited" by now
   smb.SetActivityTime();
   /* work around stupid bug in samba */
   /* some samba servers has a bug in it where the */
@@ -513,12 +662,12 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
   if( uiBufSize >= 64*1024-2 )
     uiBufSize = 64*1024-2;
 
-  ssize_t bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+  ssize_t bytesRead = smb_read(m_context, m_file, lpBuf, uiBufSize);
 
   if (m_allowRetry && bytesRead < 0 && errno == EINVAL )
   {
     CLog::Log(LOGERROR, "%s - Error( %" PRIdS ", %d, %s ) - Retrying", __FUNCTION__, bytesRead, errno, strerror(errno));
-    bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+    bytesRead = smb_read(m_context, m_file, lpBuf, uiBufSize);
   }
 
   if ( bytesRead < 0 )
@@ -529,11 +678,11 @@ ssize_t CSMBFile::Read(void *lpBuf, size_t uiBufSize)
 
 int64_t CSMBFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  if (m_fd == -1) return -1;
+  if (!m_file) return -1;
 
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
+  CSMBContextLock lock; // Init not called since it has to be "inited" by now
   smb.SetActivityTime();
-  int64_t pos = smbc_lseek(m_fd, iFilePosition, iWhence);
+  int64_t pos = smb_lseek(m_context, m_file, iFilePosition, iWhence);
 
   if ( pos < 0 )
   {
@@ -546,23 +695,25 @@ int64_t CSMBFile::Seek(int64_t iFilePosition, int iWhence)
 
 void CSMBFile::Close()
 {
-  if (m_fd != -1)
+  if (m_file)
   {
-    CLog::Log(LOGDEBUG,"CSMBFile::Close closing fd %d", m_fd);
-    CSingleLock lock(smb);
-    smbc_close(m_fd);
+    CLog::Log(LOGDEBUG,"CSMBFile::Close closing file %p", (void*)m_file);
+    CSMBContextLock lock;
+    smb_close(m_context, m_file);
   }
-  m_fd = -1;
+  m_file = NULL;
+
+  smb.ReleaseContext(m_context);
+  m_context = NULL;
 }
 
 ssize_t CSMBFile::Write(const void* lpBuf, size_t uiBufSize)
 {
-  if (m_fd == -1) return -1;
+  if (!m_file) return -1;
 
-  // lpBuf can be safely casted to void* since xbmc_write will only read from it.
-  CSingleLock lock(smb);
+  CSMBContextLock lock;
 
-  return  smbc_write(m_fd, (void*)lpBuf, uiBufSize);
+  return smb_write(m_context, m_file, lpBuf, uiBufSize);
 }
 
 bool CSMBFile::Delete(const CURL& url)
@@ -605,22 +756,30 @@ bool CSMBFile::OpenForWrite(const CURL& url, bool bOverWrite)
   if (!IsValidFile(url.GetFileName())) return false;
 
   std::string strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
 
-  if (bOverWrite)
-  {
-    CLog::Log(LOGWARNING, "SMBFile::OpenForWrite() called with overwriting enabled! - %s", CURL::GetRedacted(strFileName).c_str());
-    m_fd = smbc_creat(strFileName.c_str(), 0);
-  }
-  else
+  m_context = smb.AcquireContext();
+  if (!m_context)
+    return false;
+
   {
-    m_fd = smbc_open(strFileName.c_str(), O_RDWR, 0);
+    CSMBContextLock lock;
+
+    if (bOverWrite)
+    {
+      CLog::Log(LOGWARNING, "SMBFile::OpenForWrite() called with overwriting enabled! - %s", CURL::GetRedacted(strFileName).c_str());
+      m_file = smb_creat(m_context, strFileName.c_str(), 0);
+    }
+    else
+    {
+      m_file = smb_open(m_context, strFileName.c_str(), O_RDWR, 0);
+    }
   }
 
-  if (m_fd == -1)
+  if (!m_file)
   {
     // write error to logfile
     CLog::Log(LOGERROR, "SMBFile->Open: Unable to open file : '%s'\nunix_err:'%x' error : '%s'", CURL::GetRedacted(strFileName).c_str(), errno, strerror(errno));
+    Close();
     return false;
   }
 
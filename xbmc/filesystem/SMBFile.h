@@ -31,6 +31,8 @@
 #include "URL.h"
 #include "threads/CriticalSection.h"
 
+#include <vector>
+
 #define NT_STATUS_CONNECTION_REFUSED long(0xC0000000 | 0x0236)
 #define NT_STATUS_INVALID_HANDLE long(0xC0000000 | 0x0008)
 #define NT_STATUS_ACCESS_DENIED long(0xC0000000 | 0x0022)
@@ -39,6 +41,8 @@
 
 struct _SMBCCTX;
 typedef _SMBCCTX SMBCCTX;
+struct _SMBCFILE;
+typedef _SMBCFILE SMBCFILE;
 
 class CSMB : public CCriticalSection
 {
@@ -54,9 +58,23 @@ public:
   std::string URLEncode(const std::string &value);
   std::string URLEncode(const CURL &url);
 
+  /*!
+   \brief Get a session context for exclusive use by the caller.
+   Calls on different contexts don't have to be serialized if libsmbclient is thread safe,
+   so every open file uses its own context instead of the global one.
+   \return the context or NULL if it could not be created.
+   \sa ReleaseContext()
+   */
+  SMBCCTX *AcquireContext();
+  void ReleaseContext(SMBCCTX *context);
+
   DWORD ConvertUnixToNT(int error);
 private:
+  SMBCCTX *CreateContext();
+  void FreeIdleContexts();
+
   SMBCCTX *m_context;
+  std::vector<SMBCCTX*> m_idleContexts;
 #ifdef TARGET_POSIX
   int m_OpenConnections;
   unsigned int m_IdleTimeout;
@@ -72,7 +90,7 @@ class CSMBFile : public IFile
 {
 public:
   CSMBFile();
-  int OpenFile(const CURL &url, std::string& strAuth);
+  bool OpenFile(const CURL &url, std::string& strAuth);
   virtual ~CSMBFile();
   virtual void Close();
   virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
@@ -97,7 +115,8 @@ protected:
   bool IsValidFile(const std::string& strFileName);
   std::string GetAuthenticatedPath(const CURL &url);
   int64_t m_fileSize;
-  int m_fd;
+  SMBCCTX *m_context;
+  SMBCFILE *m_file;
   bool m_allowRetry;
 };
 }
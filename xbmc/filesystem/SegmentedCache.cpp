@@ -0,0 +1,373 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <string.h>
+#include "threads/SystemClock.h"
+#include "threads/SingleLock.h"
+#include "SegmentedCache.h"
+
+#define SEGMENT_BLOCK_SIZE (64 * 1024)
+
+using namespace XFILE;
+
+CSegmentedCache::CSegmentedCache(size_t size, size_t back, unsigned int maxSegments)
+ : CCacheStrategy()
+ , m_cur(0)
+ , m_used(0)
+ , m_size(size)
+ , m_size_back(back)
+ , m_maxSegments(std::max(maxSegments, 1u))
+{
+}
+
+CSegmentedCache::~CSegmentedCache()
+{
+  Close();
+}
+
+int CSegmentedCache::Open()
+{
+  CSingleLock lock(m_sync);
+  m_segments.clear();
+  m_segments.push_front(SSegment());
+  m_segments.front().base = 0;
+  m_segments.front().start = 0;
+  m_segments.front().end = 0;
+  m_segments.front().endOfInput = false;
+  m_used = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CSegmentedCache::Close()
+{
+  CSingleLock lock(m_sync);
+  m_segments.clear();
+  m_used = 0;
+}
+
+size_t CSegmentedCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return 0;
+
+  // other segments don't count, they are dropped when space is needed
+  const SSegment &active = m_segments.front();
+  size_t back  = (size_t)(m_cur - active.start);
+  size_t front = (size_t)(active.end - m_cur);
+  size_t used  = std::min(back, m_size_back) + front;
+  size_t limit = used < m_size ? m_size - used : 0;
+
+  return std::min(iRequestSize, limit);
+}
+
+/**
+ * Appends data to the active segment, limited to the size
+ * GetMaxWriteSize() allows. The memory needed is taken from
+ * the least recently used segments first, then from the back
+ * buffer of the active segment.
+ */
+int CSegmentedCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return CACHE_RC_ERROR;
+
+  len = GetMaxWriteSize(len);
+  if (len == 0)
+    return 0;
+
+  SSegment &active = m_segments.front();
+  size_t written = 0;
+  while (written < len)
+  {
+    size_t offset = (size_t)(active.end - active.base);
+    size_t index  = offset / SEGMENT_BLOCK_SIZE;
+    size_t pos    = offset % SEGMENT_BLOCK_SIZE;
+
+    if (index == active.blocks.size())
+    {
+      active.blocks.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[SEGMENT_BLOCK_SIZE]));
+      m_used += SEGMENT_BLOCK_SIZE;
+    }
+
+    size_t amount = std::min((size_t)SEGMENT_BLOCK_SIZE - pos, len - written);
+    memcpy(active.blocks[index].get() + pos, buf + written, amount);
+    written += amount;
+    active.end += amount;
+  }
+
+  Trim();
+
+  m_written.Set();
+
+  return len;
+}
+
+int CSegmentedCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return CACHE_RC_ERROR;
+
+  const SSegment &active = m_segments.front();
+  size_t front = (size_t)(active.end - m_cur);
+
+  if (front == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if (len > front)
+    len = front;
+
+  if (len == 0)
+    return 0;
+
+  size_t read = 0;
+  while (read < len)
+  {
+    size_t offset = (size_t)(m_cur + read - active.base);
+    size_t pos    = offset % SEGMENT_BLOCK_SIZE;
+    size_t amount = std::min((size_t)SEGMENT_BLOCK_SIZE - pos, len - read);
+    memcpy(buf + read, active.blocks[offset / SEGMENT_BLOCK_SIZE].get() + pos, amount);
+    read += amount;
+  }
+  m_cur += len;
+
+  m_space.Set();
+
+  return len;
+}
+
+/* Wait "millis" milliseconds for "minimum" amount of data to come in.
+ * Note that caller needs to make sure there's sufficient space in the forward
+ * buffer for "minimum" bytes else we may block the full timeout time
+ */
+int64_t CSegmentedCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return 0;
+
+  int64_t avail = m_segments.front().end - m_cur;
+
+  if(millis == 0 || IsEndOfInput())
+    return avail;
+
+  if(minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast() )
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    if (m_segments.empty())
+      return 0;
+    avail = m_segments.front().end - m_cur;
+  }
+
+  return avail;
+}
+
+int64_t CSegmentedCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return CACHE_RC_ERROR;
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  int64_t end = m_segments.front().end;
+  if (pos >= end && pos < end + 100000)
+  {
+    // make all of the active segment back buffer, to make sure there's sufficient forward space
+    m_cur = end;
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+    if (m_segments.empty())
+      return CACHE_RC_ERROR;
+  }
+
+  const SSegment &active = m_segments.front();
+  if (pos >= active.start && pos <= active.end)
+  {
+    m_cur = pos;
+    return pos;
+  }
+
+  // if another segment holds pos this requests a seek event,
+  // which will make that segment active through Reset()
+  return CACHE_RC_ERROR;
+}
+
+bool CSegmentedCache::Reset(int64_t pos, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return true;
+
+  if (!clearAnyway)
+  {
+    SegmentList::iterator it = FindSegment(pos);
+    if (it != m_segments.end())
+    {
+      Activate(it);
+      m_cur = pos;
+      return false;
+    }
+  }
+
+  // an unused active segment can simply be moved
+  SSegment &active = m_segments.front();
+  if (active.start == active.end)
+  {
+    m_used -= active.blocks.size() * SEGMENT_BLOCK_SIZE;
+    active.blocks.clear();
+  }
+  else
+  {
+    active.endOfInput = IsEndOfInput();
+    if (m_segments.size() >= m_maxSegments)
+    {
+      m_used -= m_segments.back().blocks.size() * SEGMENT_BLOCK_SIZE;
+      m_segments.pop_back();
+    }
+    m_segments.push_front(SSegment());
+  }
+
+  SSegment &segment = m_segments.front();
+  segment.base = pos;
+  segment.start = pos;
+  segment.end = pos;
+  segment.endOfInput = false;
+  ClearEndOfInput();
+  m_cur = pos;
+
+  return true;
+}
+
+int64_t CSegmentedCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  SegmentList::iterator it = FindSegment(iFilePosition);
+  if (it != m_segments.end())
+    return it->end;
+  return iFilePosition;
+}
+
+int64_t CSegmentedCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  if (m_segments.empty())
+    return 0;
+  return m_segments.front().end;
+}
+
+bool CSegmentedCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return FindSegment(iFilePosition) != m_segments.end();
+}
+
+CCacheStrategy *CSegmentedCache::CreateNew()
+{
+  return new CSegmentedCache(m_size, m_size_back, m_maxSegments);
+}
+
+size_t CSegmentedCache::GetSegmentCount()
+{
+  CSingleLock lock(m_sync);
+  size_t count = 0;
+  for (SegmentList::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (it == m_segments.begin() || it->start != it->end)
+      count++;
+  }
+  return count;
+}
+
+/* Returns the segment holding pos that has the most data following it,
+ * the more recently used one if there are several.
+ */
+CSegmentedCache::SegmentList::iterator CSegmentedCache::FindSegment(int64_t pos)
+{
+  SegmentList::iterator found = m_segments.end();
+  for (SegmentList::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (pos >= it->start && pos <= it->end && (found == m_segments.end() || it->end > found->end))
+      found = it;
+  }
+  return found;
+}
+
+void CSegmentedCache::Activate(SegmentList::iterator segment)
+{
+  if (segment == m_segments.begin())
+    return;
+
+  m_segments.front().endOfInput = IsEndOfInput();
+  if (segment->endOfInput)
+    EndOfInput();
+  else
+    ClearEndOfInput();
+
+  m_segments.splice(m_segments.begin(), m_segments, segment);
+}
+
+void CSegmentedCache::DropFirstBlock(SSegment &segment)
+{
+  segment.blocks.pop_front();
+  m_used -= SEGMENT_BLOCK_SIZE;
+  segment.base += SEGMENT_BLOCK_SIZE;
+  segment.start = std::max(segment.start, segment.base);
+  segment.end = std::max(segment.end, segment.start);
+}
+
+void CSegmentedCache::Trim()
+{
+  while (m_used > m_size)
+  {
+    // least recently used segments give up their data first
+    if (m_segments.size() > 1)
+    {
+      SSegment &segment = m_segments.back();
+      if (!segment.blocks.empty())
+        DropFirstBlock(segment);
+      if (segment.blocks.empty())
+        m_segments.pop_back();
+      continue;
+    }
+
+    // then the back buffer of the active segment, keeping m_size_back of it
+    SSegment &active = m_segments.front();
+    if (active.blocks.size() < 2 || active.base + SEGMENT_BLOCK_SIZE > m_cur - (int64_t)m_size_back)
+      break;
+    DropFirstBlock(active);
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CACHESEGMENTED_H
+#define CACHESEGMENTED_H
+
+#include <deque>
+#include <list>
+#include <memory>
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+namespace XFILE {
+
+/**
+ * Memory cache holding several independent ranges of a file. Reading and
+ * writing always happens in the active (most recently used) segment. A seek
+ * outside of it makes another segment active, either one that already holds
+ * the target position or a new one. Memory is shared between all segments,
+ * when it runs out the least recently used segments give up their data first,
+ * so the forward buffer of the active segment can always use the full size.
+ */
+class CSegmentedCache : public CCacheStrategy
+{
+public:
+    CSegmentedCache(size_t size, size_t back, unsigned int maxSegments);
+    virtual ~CSegmentedCache();
+
+    virtual int Open() ;
+    virtual void Close();
+
+    virtual size_t GetMaxWriteSize(const size_t& iRequestSize) ;
+    virtual int WriteToCache(const char *buf, size_t len) ;
+    virtual int ReadFromCache(char *buf, size_t len) ;
+    virtual int64_t WaitForData(unsigned int minimum, unsigned int iMillis) ;
+
+    virtual int64_t Seek(int64_t pos) ;
+    virtual bool Reset(int64_t pos, bool clearAnyway=true) ;
+
+    virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
+    virtual int64_t CachedDataEndPos();
+    virtual bool IsCachedPosition(int64_t iFilePosition);
+
+    virtual CCacheStrategy *CreateNew();
+
+    /*! \brief Number of segments currently holding data, the active one included */
+    size_t GetSegmentCount();
+
+protected:
+    struct SSegment
+    {
+      int64_t base;         /**< index in file of the first byte of the first block */
+      int64_t start;        /**< index in file of beginning of valid data */
+      int64_t end;          /**< index in file of end of valid data */
+      bool    endOfInput;   /**< end of input was reached while this segment was active */
+      std::deque<std::unique_ptr<uint8_t[]> > blocks; /**< the data, in blocks of SEGMENT_BLOCK_SIZE */
+    };
+    typedef std::list<SSegment> SegmentList;
+
+    SegmentList::iterator FindSegment(int64_t pos);
+    void Activate(SegmentList::iterator segment);
+    void DropFirstBlock(SSegment &segment);
+    void Trim();
+
+    SegmentList       m_segments;    /**< most recently used first, the front one is active */
+    int64_t           m_cur;         /**< current reading index in file */
+    size_t            m_used;        /**< memory allocated by all segments */
+    size_t            m_size;        /**< memory budget of all segments together */
+    size_t            m_size_back;   /**< guaranteed size of back buffer of the active segment */
+    unsigned int      m_maxSegments; /**< maximum number of segments */
+    CCriticalSection  m_sync;
+    CEvent            m_written;
+};
+
+} // namespace XFILE
+#endif
@@ -24,12 +24,19 @@
 #include "utils/auto_buffer.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <limits.h>
 #include <sys/stat.h>
 
 #if defined (TARGET_WINDOWS)
 #pragma comment(lib, "zlib.lib")
 #endif
-#define ZIP_CACHE_LIMIT 4*1024*1024
+
+// size of the deflate dictionary
+#define ZIP_WINDOW_SIZE 32768
+// minimum amount of uncompressed data between access points and their maximum number
+#define ZIP_ACCESS_SPAN (1024*1024)
+#define ZIP_MAX_ACCESS_POINTS 64
 
 using namespace XFILE;
 
@@ -38,8 +45,10 @@ CZipFile::CZipFile()
   m_szStringBuffer = NULL;
   m_szStartOfStringBuffer = NULL;
   m_iDataInStringBuffer = 0;
-  m_bCached = false;
   m_iRead = -1;
+  m_accessSpan = 0;
+  m_windowPos = 0;
+  m_windowSize = 0;
 }
 
 CZipFile::~CZipFile()
@@ -50,7 +59,6 @@ CZipFile::~CZipFile()
 
 bool CZipFile::Open(const CURL&url)
 {
-  std::string strOpts = url.GetOptions();
   CURL url2(url);
   url2.SetOptions("");
   if (!g_ZipManager.GetZipEntry(url2,mZipItem))
@@ -68,19 +76,6 @@ bool CZipFile::Open(const CURL&url)
     return false;
   }
 
-  if (mZipItem.method != 0 && mZipItem.usize > ZIP_CACHE_LIMIT && strOpts != "?cache=no")
-  {
-    if (!CFile::Exists("special://temp/" + URIUtils::GetFileName(url2)))
-    {
-      url2.SetOptions("?cache=no");
-      const CURL pathToUrl("special://temp/" + URIUtils::GetFileName(url2));
-      if (!CFile::Copy(url2, pathToUrl))
-        return false;
-    }
-    m_bCached = true;
-    return mFile.Open("special://temp/" + URIUtils::GetFileName(url2));
-  }
-
   if (!mFile.Open(url.GetHostName())) // this is the zip-file, always open binary
   {
     CLog::Log(LOGERROR,"FileZip: unable to open zip file %s!",url.GetHostName().c_str());
@@ -112,9 +107,110 @@ bool CZipFile::InitDecompress()
   m_ZStream.avail_in = 0;
   m_ZStream.total_out = 0;
 
+  // access points make seeking back in large deflated files cheap
+  m_accessPoints.clear();
+  m_accessSpan = 0;
+  m_windowPos = 0;
+  m_windowSize = 0;
+  if (mZipItem.method == 8 && mZipItem.usize > ZIP_ACCESS_SPAN)
+  {
+    m_accessSpan = std::max<int64_t>(ZIP_ACCESS_SPAN, mZipItem.usize / ZIP_MAX_ACCESS_POINTS);
+    m_window.resize(ZIP_WINDOW_SIZE);
+  }
+
+  return true;
+}
+
+/* Restarts decompression at an access point, or at the start of the file
+ * without one. Deflated data can't be decompressed from anywhere else as
+ * the dictionary and bit position aren't known.
+ */
+bool CZipFile::RestartDecompress(const SAccessPoint* point)
+{
+  inflateEnd(&m_ZStream);
+  if (inflateInit2(&m_ZStream,-MAX_WBITS) != Z_OK)
+  {
+    CLog::Log(LOGERROR,"FileZip: error initializing zlib!");
+    return false;
+  }
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_ZStream.total_out = 0;
+  m_bFlush = false;
+
+  if (!point)
+  {
+    m_iFilePos = 0;
+    m_iZipFilePos = 0;
+    m_windowPos = 0;
+    m_windowSize = 0;
+    return mFile.Seek(mZipItem.offset,SEEK_SET) == mZipItem.offset;
+  }
+
+  m_iZipFilePos = point->in - (point->bits ? 1 : 0);
+  if (mFile.Seek(mZipItem.offset+m_iZipFilePos,SEEK_SET) != mZipItem.offset+m_iZipFilePos)
+    return false;
+  if (point->bits)
+  {
+    unsigned char c;
+    if (mFile.Read(&c, 1) != 1)
+      return false;
+    m_iZipFilePos++;
+    inflatePrime(&m_ZStream, point->bits, c >> (8 - point->bits));
+  }
+  inflateSetDictionary(&m_ZStream, &point->window[0], point->window.size());
+
+  memcpy(&m_window[0], &point->window[0], point->window.size());
+  m_windowSize = point->window.size();
+  m_windowPos = m_windowSize % ZIP_WINDOW_SIZE;
+  m_iFilePos = point->out;
   return true;
 }
 
+/* Called with the data inflate() just produced. Keeps the dictionary for the
+ * next access point and creates one at the end of a deflate block once the
+ * span since the last one is exceeded.
+ */
+void CZipFile::UpdateAccessPoints(const unsigned char* data, size_t size)
+{
+  if (!m_accessSpan)
+    return;
+
+  if (size >= ZIP_WINDOW_SIZE)
+  {
+    memcpy(&m_window[0], data + size - ZIP_WINDOW_SIZE, ZIP_WINDOW_SIZE);
+    m_windowPos = 0;
+    m_windowSize = ZIP_WINDOW_SIZE;
+  }
+  else if (size > 0)
+  {
+    size_t first = std::min(size, ZIP_WINDOW_SIZE - m_windowPos);
+    memcpy(&m_window[m_windowPos], data, first);
+    memcpy(&m_window[0], data + first, size - first);
+    m_windowPos = (m_windowPos + size) % ZIP_WINDOW_SIZE;
+    m_windowSize = std::min<size_t>(m_windowSize + size, ZIP_WINDOW_SIZE);
+  }
+
+  // bit 7 of data_type: end of a block, bit 6: it was the last block
+  if (!(m_ZStream.data_type & 128) || (m_ZStream.data_type & 64))
+    return;
+
+  int64_t last = m_accessPoints.empty() ? 0 : m_accessPoints.back().out;
+  if (m_iFilePos - last < m_accessSpan)
+    return;
+
+  SAccessPoint point;
+  point.out = m_iFilePos;
+  point.in = m_iZipFilePos - m_ZStream.avail_in;
+  point.bits = m_ZStream.data_type & 7;
+  point.window.resize(m_windowSize);
+  size_t start = (m_windowPos + ZIP_WINDOW_SIZE - m_windowSize) % ZIP_WINDOW_SIZE;
+  size_t first = std::min(m_windowSize, ZIP_WINDOW_SIZE - start);
+  memcpy(&point.window[0], &m_window[start], first);
+  memcpy(&point.window[first], &m_window[0], m_windowSize - first);
+  m_accessPoints.push_back(point);
+}
+
 int64_t CZipFile::GetLength()
 {
   return mZipItem.usize;
@@ -122,16 +218,11 @@ int64_t CZipFile::GetLength()
 
 int64_t CZipFile::GetPosition()
 {
-  if (m_bCached)
-    return mFile.GetPosition();
-
   return m_iFilePos;
 }
 
 int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  if (m_bCached)
-    return mFile.Seek(iFilePosition,iWhence);
   if (mZipItem.method == 0) // this is easy
   {
     int64_t iResult;
@@ -171,71 +262,39 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
   // here goes the stupid part..
   if (mZipItem.method == 8)
   {
-    static const int blockSize = 128 * 1024;
-    XUTILS::auto_buffer buf(blockSize);
-    switch (iWhence)
+    if (iWhence == SEEK_CUR)
+      iFilePosition += m_iFilePos;
+    else if (iWhence == SEEK_END)
+      iFilePosition += mZipItem.usize;
+    else if (iWhence != SEEK_SET)
+      return -1;
+
+    if (iFilePosition == m_iFilePos)
+      return m_iFilePos; // mp3reader does this lots-of-times
+    if (iFilePosition > mZipItem.usize || iFilePosition < 0)
+      return -1;
+
+    // continue from the closest access point before the position if we have
+    // to go back or if it saves decompressing data
+    const SAccessPoint* point = NULL;
+    for (std::vector<SAccessPoint>::const_iterator it = m_accessPoints.begin(); it != m_accessPoints.end() && it->out <= iFilePosition; ++it)
+      point = &(*it);
+    if (iFilePosition < m_iFilePos || (point && point->out > m_iFilePos))
     {
-    case SEEK_SET:
-      if (iFilePosition == m_iFilePos)
-        return m_iFilePos; // mp3reader does this lots-of-times
-      if (iFilePosition > mZipItem.usize || iFilePosition < 0)
+      if (!RestartDecompress(point))
         return -1;
-      // read until position in 128k blocks.. only way to do it due to format.
-      // can't start in the middle of data since then we'd have no clue where
-      // we are in uncompressed data..
-      if (iFilePosition < m_iFilePos)
-      {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
-        while (m_iFilePos < iFilePosition)
-        {
-          unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-          if (Read(buf.get(),iToRead) != iToRead)
-            return -1;
-        }
-        return m_iFilePos;
-      }
-      else // seek forward
-        return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
-      break;
+    }
 
-    case SEEK_CUR:
-      if (iFilePosition < 0)
-        return Seek(m_iFilePos+iFilePosition,SEEK_SET); // can't rewind stream
-      // read until requested position, drop data
-      if (m_iFilePos+iFilePosition > mZipItem.usize)
+    // read until position in 128k blocks.. only way to do it due to format.
+    static const int blockSize = 128 * 1024;
+    XUTILS::auto_buffer buf(blockSize);
+    while (m_iFilePos < iFilePosition)
+    {
+      unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
+      if (Read(buf.get(),iToRead) != iToRead)
         return -1;
-      iFilePosition += m_iFilePos;
-      while (m_iFilePos < iFilePosition)
-      {
-        unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
-      break;
-
-    case SEEK_END:
-      // now this is a nasty bastard, possibly takes lotsoftime
-      // uncompress, minding m_ZStream.total_out
-
-      while( (int)m_ZStream.total_out < mZipItem.usize+iFilePosition)
-      {
-        unsigned int iToRead = (mZipItem.usize + iFilePosition - m_ZStream.total_out > blockSize) ? blockSize : (int)(mZipItem.usize + iFilePosition - m_ZStream.total_out);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
-      break;
-    default:
-      return -1;
     }
+    return m_iFilePos;
   }
   return -1;
 }
@@ -293,9 +352,6 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
-  if (m_bCached)
-    return mFile.Read(lpBuf,uiBufSize);
-
   // flush what might be left in the string buffer
   if (m_iDataInStringBuffer > 0)
   {
@@ -306,45 +362,37 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   }
   if (mZipItem.method == 8) // deflated
   {
-    uLong iDecompressed = 0;
-    uLong prevOut = m_ZStream.total_out;
-    while ((iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_bFlush)))
-    {
-      m_ZStream.next_out = (Bytef*)(lpBuf)+iDecompressed;
-      m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
-      if (m_bFlush) // need to flush buffer !
-      {
-        int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
-        m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
-        if (!m_ZStream.avail_out) // flush filled buffer, get out of here
-        {
-          iDecompressed = m_ZStream.total_out-prevOut;
-          break;
-        }
-      }
+    if (uiBufSize > UINT_MAX)
+      uiBufSize = UINT_MAX;
 
-      if (!m_ZStream.avail_in)
-      {
-        if (!FillBuffer()) // eof!
-        {
-          iDecompressed = m_ZStream.total_out-prevOut;
-          break;
-        }
-      }
-
-      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+    m_ZStream.next_out = (Bytef*)lpBuf;
+    m_ZStream.avail_out = static_cast<uInt>(uiBufSize);
+    while (m_ZStream.avail_out > 0)
+    {
+      // inflate may still hold output when it filled the buffer last time
+      if (!m_ZStream.avail_in && !m_bFlush && !FillBuffer())
+        break; // eof!
+
+      // stop at block ends to be able to create access points there
+      Bytef* out = m_ZStream.next_out;
+      int iMessage = inflate(&m_ZStream,Z_BLOCK);
+      if (iMessage == Z_BUF_ERROR && m_bFlush)
+        iMessage = Z_OK; // nothing was left to flush
       if (iMessage < 0)
       {
         Close();
         return -1; // READ ERROR
       }
 
-      m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false; // more info in input buffer
+      size_t iDecompressed = m_ZStream.next_out - out;
+      m_iFilePos += iDecompressed;
+      UpdateAccessPoints(out, iDecompressed);
 
-      iDecompressed = m_ZStream.total_out-prevOut;
+      m_bFlush = (iMessage == Z_OK && m_ZStream.avail_out == 0);
+      if (iMessage == Z_STREAM_END)
+        break;
     }
-    m_iFilePos += iDecompressed;
-    return static_cast<unsigned int>(iDecompressed);
+    return static_cast<ssize_t>(uiBufSize - m_ZStream.avail_out);
   }
   else if (mZipItem.method == 0) // uncompressed. just read from file, but mind our boundaries.
   {
@@ -367,7 +415,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
 
 void CZipFile::Close()
 {
-  if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
+  if (mZipItem.method == 8 && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
   mFile.Close();
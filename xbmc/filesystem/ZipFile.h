@@ -21,6 +21,7 @@
  */
 
 #include "IFile.h"
+#include <vector>
 #include <zlib.h>
 #include "File.h"
 #include "ZipManager.h"
@@ -51,7 +52,18 @@ namespace XFILE
     static bool DecompressGzip(const std::string& in, std::string& out);
 
   private:
+    /*! Position from where decompression of a deflated file can continue, see Seek() */
+    struct SAccessPoint
+    {
+      int64_t out;  // position in uncompressed data
+      int64_t in;   // position in compressed data
+      int bits;     // bits of the byte before in that belong to the next block
+      std::vector<unsigned char> window; // uncompressed data preceding out, up to 32k
+    };
+
     bool InitDecompress();
+    bool RestartDecompress(const SAccessPoint* point);
+    void UpdateAccessPoints(const unsigned char* data, size_t size);
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
@@ -66,7 +78,11 @@ namespace XFILE
     size_t m_iDataInStringBuffer;
     int m_iRead;
     bool m_bFlush;
-    bool m_bCached;
+    std::vector<SAccessPoint> m_accessPoints;
+    int64_t m_accessSpan; // uncompressed data between access points, 0 if none are created
+    std::vector<unsigned char> m_window; // last 32k of uncompressed data, circular
+    size_t m_windowPos;
+    size_t m_windowSize;
   };
 }
 
@@ -23,10 +23,13 @@
 #include <algorithm>
 #include <utility>
 
+#include "ArchiveIndexCache.h"
 #include "File.h"
 #include "system.h"
 #include "URL.h"
 #include "linux/PlatformDefs.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/EndianSwap.h"
 #include "utils/log.h"
@@ -43,32 +46,89 @@ CZipManager::~CZipManager()
 
 }
 
+static void StoreIndex(CArchive& ar, const std::vector<SZipEntry>& items)
+{
+  ar << (unsigned int)items.size();
+  for (std::vector<SZipEntry>::const_iterator it = items.begin(); it != items.end(); ++it)
+  {
+    ar << it->header << it->version << it->flags << it->method;
+    ar << it->mod_time << it->mod_date << it->crc32 << it->csize << it->usize;
+    ar << it->flength << it->elength << it->eclength << it->clength;
+    ar << it->lhdrOffset << it->offset << std::string(it->name);
+  }
+}
+
+static bool LoadIndex(CArchive& ar, std::vector<SZipEntry>& items)
+{
+  unsigned int count = 0;
+  ar >> count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    SZipEntry ze;
+    std::string strName;
+    ar >> ze.header >> ze.version >> ze.flags >> ze.method;
+    ar >> ze.mod_time >> ze.mod_date >> ze.crc32 >> ze.csize >> ze.usize;
+    ar >> ze.flength >> ze.elength >> ze.eclength >> ze.clength;
+    ar >> ze.lhdrOffset >> ze.offset >> strName;
+    if (ze.header != ZIP_CENTRAL_HEADER)
+      return false;
+    ZeroMemory(ze.name, 255);
+    strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
+    items.push_back(ze);
+  }
+  return true;
+}
+
 bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 {
   struct __stat64 m_StatData = {};
 
   std::string strFile = url.GetHostName();
 
-  if (CFile::Stat(strFile,&m_StatData))
+  if (CFile::Stat(strFile,&m_StatData,true))
   {
     CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", url.GetRedacted().c_str());
     return false;
   }
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
   {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
-
-    if (m_StatData.st_mtime == it2->second)
+    CSingleLock lock(m_critSection);
+    std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
+    if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
     {
-      items = it->second;
-      return true;
+      std::map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
+
+      if (m_StatData.st_mtime == it2->second)
+      {
+        items = it->second;
+        return true;
+      }
+      mZipMap.erase(it);
+      mZipDate.erase(it2);
     }
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
   }
 
+  // the archive is read without holding the lock, other archives can be listed meanwhile
+  items.clear();
+  CArchiveIndexCache& indexCache = CArchiveIndexCache::GetInstance();
+  std::string key = CArchiveIndexCache::GetKey(strFile, m_StatData.st_size, m_StatData.st_mtime);
+  if (!indexCache.Load(key, strFile, [&items](CArchive& ar) { return LoadIndex(ar, items); }))
+  {
+    items.clear();
+    if (!ReadZipList(strFile, items))
+      return false;
+    indexCache.Store(key, strFile, [&items](CArchive& ar) { StoreIndex(ar, items); });
+  }
+
+  // push date for update detection
+  CSingleLock lock(m_critSection);
+  mZipMap[strFile] = items;
+  mZipDate[strFile] = m_StatData.st_mtime;
+  return true;
+}
+
+bool CZipManager::ReadZipList(const std::string& strFile, std::vector<SZipEntry>& items)
+{
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -89,10 +149,6 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
   if (Endian_SwapLE32(hdr) == ZIP_SPLIT_ARCHIVE_HEADER)
     CLog::LogF(LOGWARNING, "ZIP split archive header found. Trying to process as a single archive..");
 
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
-
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
   // End of central directory record is 22 bytes (ECDREC_SIZE)
@@ -218,7 +274,6 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
   mFile.Close();
   return true;
 }
@@ -227,16 +282,19 @@ bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
 {
   std::string strFile = url.GetHostName();
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
   std::vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
+  bool bListed = false;
   {
-    GetZipList(url,items);
-  }
-  else
-  {
-    items = it->second;
+    CSingleLock lock(m_critSection);
+    std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
+    if (it != mZipMap.end())
+    {
+      items = it->second;
+      bListed = true;
+    }
   }
+  if (!bListed) // we need to list the zip
+    GetZipList(url,items);
 
   std::string strFileName = url.GetFileName();
   for (std::vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
@@ -315,6 +373,7 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const std::string& strPath)
 {
   CURL url(strPath);
+  CSingleLock lock(m_critSection);
   std::map<std::string, std::vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
   if (it != mZipMap.end())
   {
@@ -36,6 +36,8 @@
 #include <vector>
 #include <map>
 
+#include "threads/CriticalSection.h"
+
 class CURL;
 
 struct SZipEntry {
@@ -111,8 +113,11 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
+  static bool ReadZipList(const std::string& strFile, std::vector<SZipEntry>& items);
+
   std::map<std::string,std::vector<SZipEntry> > mZipMap;
   std::map<std::string,int64_t> mZipDate;
+  CCriticalSection m_critSection;
 };
 
 extern CZipManager g_ZipManager;
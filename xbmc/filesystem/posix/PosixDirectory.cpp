@@ -98,6 +98,7 @@ bool CPosixDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         TimeTToFileTime(buffer.st_mtime, &fileTime);
         FileTimeToLocalFileTime(&fileTime, &localTime);
         pItem->m_dateTime = localTime;
+        pItem->SetProperty("file:mtime", (int64_t)buffer.st_mtime);
 
         if (!pItem->m_bIsFolder)
           pItem->m_dwSize = buffer.st_size;
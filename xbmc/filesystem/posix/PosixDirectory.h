@@ -30,6 +30,7 @@ public:
   CPosixDirectory(void);
   virtual ~CPosixDirectory(void);
   virtual bool GetDirectory(const CURL& url, CFileItemList &items);
+  virtual bool HasFileInfo(const CURL& url) const { return (m_flags & DIR_FLAG_NO_FILE_INFO) == 0; }
   virtual bool Create(const CURL& url);
   virtual bool Exists(const CURL& url);
   virtual bool Remove(const CURL& url);
@@ -27,7 +27,7 @@
 #include "filesystem/File.h"
 
 #ifdef HAVE_CONFIG_H
-#include "config.h" // for HAVE_POSIX_FADVISE
+#include "config.h" // for HAVE_POSIX_FADVISE and HAVE_COPY_FILE_RANGE
 #endif // HAVE_CONFIG_H
 
 #include <sys/stat.h>
@@ -38,6 +38,9 @@
 #include <limits.h>
 #include <algorithm>
 #include <sys/ioctl.h>
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <sys/sendfile.h>
+#endif
 #include <errno.h>
 
 using namespace XFILE;
@@ -354,6 +357,44 @@ int CPosixFile::Stat(const CURL& url, struct __stat64* buffer)
   return stat64(filename.c_str(), buffer);
 }
 
+ssize_t CPosixFile::CopyFrom(IFile* source, size_t size)
+{
+#if defined(HAVE_COPY_FILE_RANGE) || defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  CPosixFile* file = dynamic_cast<CPosixFile*>(source);
+  if (m_fd < 0 || !m_allowWrite || !file || file->m_fd < 0)
+    return -1;
+
+  // both files are copied at their current offsets, which must be known
+  if (m_filePos < 0 || file->m_filePos < 0)
+    return -1;
+
+  if (size > SSIZE_MAX)
+    size = SSIZE_MAX;
+
+  ssize_t res = -1;
+#if defined(HAVE_COPY_FILE_RANGE)
+  // lets the filesystem share extents or copy server side, fails across
+  // filesystems on older kernels
+  res = copy_file_range(file->m_fd, NULL, m_fd, NULL, size, 0);
+#endif
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  if (res < 0)
+    res = sendfile(m_fd, file->m_fd, NULL, size);
+#endif
+  if (res < 0)
+  {
+    CLog::Log(LOGDEBUG, "CPosixFile::CopyFrom - in kernel copy failed with errno %d", errno);
+    return -1;
+  }
+
+  file->m_filePos += res;
+  m_filePos += res;
+  return res;
+#else
+  return -1;
+#endif
+}
+
 int CPosixFile::Stat(struct __stat64* buffer)
 {
   assert(buffer != NULL);
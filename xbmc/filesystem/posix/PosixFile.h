@@ -42,6 +42,7 @@ namespace XFILE
     virtual int64_t GetLength();
     virtual void Flush();
     virtual int IoControl(EIoControl request, void* param);
+    virtual ssize_t CopyFrom(IFile* source, size_t size);
     
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& url, const CURL& urlnew);
@@ -0,0 +1,49 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/BlockCache.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestBlockCache, GetKey)
+{
+  std::string key = CBlockCache::GetKey("smb://server/share/movie.mkv", 1000000, 1450000000);
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, CBlockCache::GetKey("smb://server/share/movie.mkv", 1000000, 1450000000));
+
+  // another version of the file
+  EXPECT_NE(key, CBlockCache::GetKey("smb://server/share/movie.mkv", 1000001, 1450000000));
+  EXPECT_NE(key, CBlockCache::GetKey("smb://server/share/movie.mkv", 1000000, 1450000001));
+  EXPECT_NE(key, CBlockCache::GetKey("smb://server/share/movie2.mkv", 1000000, 1450000000));
+
+  // versions can't be told apart without size and modification time
+  EXPECT_TRUE(CBlockCache::GetKey("smb://server/share/movie.mkv", 0, 1450000000).empty());
+  EXPECT_TRUE(CBlockCache::GetKey("smb://server/share/movie.mkv", 1000000, 0).empty());
+}
+
+TEST(TestBlockCache, ShouldStore)
+{
+  const int64_t fileSize = 1000 * (int64_t)CBlockCache::BLOCK_SIZE + 1;
+  EXPECT_TRUE(CBlockCache::ShouldStore(0, fileSize));
+  EXPECT_TRUE(CBlockCache::ShouldStore(1000, fileSize));
+  EXPECT_FALSE(CBlockCache::ShouldStore(500, fileSize));
+}
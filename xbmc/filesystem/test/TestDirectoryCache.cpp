@@ -0,0 +1,147 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "FileItem.h"
+#if defined(TARGET_POSIX)
+#include "linux/XTimeUtils.h"
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void FillListing(CFileItemList &items)
+{
+  CFileItemPtr file(new CFileItem("smb://server/share/movies/movie.mkv", false));
+  file->m_dwSize = 123456;
+  file->m_dateTime = CDateTime::FromUTCDateTime((time_t)1450000000);
+  file->SetProperty("file:mtime", (int64_t)1450000000);
+  items.Add(file);
+
+  CFileItemPtr folder(new CFileItem("smb://server/share/movies/extras/", true));
+  folder->m_dateTime = CDateTime::FromUTCDateTime((time_t)1450000100);
+  folder->SetProperty("file:mtime", (int64_t)1450000100);
+  items.Add(folder);
+}
+
+#if defined(TARGET_POSIX)
+// listings convert mtimes to local time with the DST offset of each file's date
+CFileItemPtr ListedFile(const std::string &path, time_t mtime)
+{
+  FILETIME fileTime, localTime;
+  TimeTToFileTime(mtime, &fileTime);
+  FileTimeToLocalFileTime(&fileTime, &localTime);
+
+  CFileItemPtr file(new CFileItem(path, false));
+  file->m_dateTime = localTime;
+  file->SetProperty("file:mtime", (int64_t)mtime);
+  return file;
+}
+#endif
+}
+
+TEST(TestDirectoryCache, Stat)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillListing(items);
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE, true);
+
+  struct __stat64 buffer;
+  bool inCache;
+  ASSERT_TRUE(cache.Stat("smb://server/share/movies/movie.mkv", &buffer, inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_EQ(123456, buffer.st_size);
+  EXPECT_EQ(1450000000, buffer.st_mtime);
+  EXPECT_FALSE(S_ISDIR(buffer.st_mode));
+
+  ASSERT_TRUE(cache.Stat("smb://server/share/movies/extras", &buffer, inCache));
+  EXPECT_EQ(1450000100, buffer.st_mtime);
+  EXPECT_TRUE(S_ISDIR(buffer.st_mode));
+
+  // the listing is complete, so a missing file doesn't exist
+  EXPECT_FALSE(cache.Stat("smb://server/share/movies/other.mkv", &buffer, inCache));
+  EXPECT_TRUE(inCache);
+}
+
+TEST(TestDirectoryCache, StatWithoutFileInfo)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillListing(items);
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE);
+
+  struct __stat64 buffer;
+  bool inCache;
+  EXPECT_FALSE(cache.Stat("smb://server/share/movies/movie.mkv", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+
+  // added files and a cleared file info make the listing incomplete
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE, true);
+  cache.AddFile("smb://server/share/movies/new.mkv");
+  EXPECT_FALSE(cache.Stat("smb://server/share/movies/movie.mkv", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE, true);
+  cache.ClearFileInfo();
+  EXPECT_FALSE(cache.Stat("smb://server/share/movies/movie.mkv", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+}
+
+#if defined(TARGET_POSIX)
+TEST(TestDirectoryCache, StatAcrossDST)
+{
+  const char *tz = getenv("TZ");
+  std::string oldTZ(tz ? tz : "");
+  setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset();
+
+  CDirectoryCache cache;
+  CFileItemList items;
+  items.Add(ListedFile("smb://server/share/movies/summer.mkv", 1435000000)); // June 2015
+  items.Add(ListedFile("smb://server/share/movies/winter.mkv", 1450000000)); // December 2015
+  items.Add(CFileItemPtr(new CFileItem("smb://server/share/movies/unknown.mkv", false)));
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE, true);
+
+  struct __stat64 buffer;
+  bool inCache;
+  ASSERT_TRUE(cache.Stat("smb://server/share/movies/summer.mkv", &buffer, inCache));
+  EXPECT_EQ(1435000000, buffer.st_mtime);
+  ASSERT_TRUE(cache.Stat("smb://server/share/movies/winter.mkv", &buffer, inCache));
+  EXPECT_EQ(1450000000, buffer.st_mtime);
+
+  // without the listed mtime the file has to be stat'ed
+  EXPECT_FALSE(cache.Stat("smb://server/share/movies/unknown.mkv", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+
+  if (tz)
+    setenv("TZ", oldTZ.c_str(), 1);
+  else
+    unsetenv("TZ");
+  tzset();
+}
+#endif
@@ -203,6 +203,36 @@ TEST(TestFile, Copy)
   EXPECT_TRUE(XFILE::CFile::Delete(path2));
 }
 
+TEST(TestFile, CopyLarge)
+{
+  XFILE::CFile *file;
+  std::string path1, path2;
+
+  // more than one chunk of an in kernel copy
+  std::string data(17 * 1024 * 1024 + 123, '\0');
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = (char)(i * 7 + i / 4096);
+
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  path1 = XBMC_TEMPFILEPATH(file);
+  ASSERT_TRUE(file->OpenForWrite(path1, true));
+  EXPECT_EQ((ssize_t)data.size(), file->Write(data.c_str(), data.size()));
+  file->Close();
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  path2 = XBMC_TEMPFILEPATH(file);
+
+  EXPECT_TRUE(XFILE::CFile::Copy(path1, path2));
+
+  XFILE::CFile copy;
+  XFILE::auto_buffer buffer;
+  ASSERT_EQ((ssize_t)data.size(), copy.LoadFile(path2, buffer));
+  EXPECT_EQ(0, memcmp(data.c_str(), buffer.get(), data.size()));
+  EXPECT_TRUE(XFILE::CFile::Delete(path1));
+  EXPECT_TRUE(XFILE::CFile::Delete(path2));
+}
+
 TEST(TestFile, SetHidden)
 {
   XFILE::CFile *file;
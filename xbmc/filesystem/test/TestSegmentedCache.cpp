@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SegmentedCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+// writes the bytes [pos, pos + size) of a file whose every byte is its position modulo 251
+void WriteRange(CSegmentedCache &cache, int64_t pos, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = (char)((pos + i) % 251);
+
+  size_t written = 0;
+  while (written < size)
+  {
+    int ret = cache.WriteToCache(data.data() + written, size - written);
+    ASSERT_GT(ret, 0);
+    written += ret;
+  }
+}
+
+void ExpectRange(CSegmentedCache &cache, int64_t pos, size_t size)
+{
+  std::vector<char> data(size);
+  size_t read = 0;
+  while (read < size)
+  {
+    int ret = cache.ReadFromCache(data.data() + read, size - read);
+    ASSERT_GT(ret, 0);
+    read += ret;
+  }
+  for (size_t i = 0; i < size; i++)
+    ASSERT_EQ((char)((pos + i) % 251), data[i]);
+}
+}
+
+TEST(TestSegmentedCache, ReadWrite)
+{
+  CSegmentedCache cache(1024 * 1024, 256 * 1024, 4);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 200000);
+  EXPECT_EQ(200000, cache.CachedDataEndPos());
+  ExpectRange(cache, 0, 150000);
+
+  EXPECT_EQ(1000, cache.Seek(1000));
+  ExpectRange(cache, 1000, 199000);
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(NULL, 1));
+
+  cache.EndOfInput();
+  char c;
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+}
+
+TEST(TestSegmentedCache, KeepsSeekTargets)
+{
+  const int64_t fileSize = 100 * 1024 * 1024;
+  CSegmentedCache cache(1024 * 1024, 256 * 1024, 4);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // head of the file
+  WriteRange(cache, 0, 100000);
+  ExpectRange(cache, 0, 50000);
+
+  // index at the end of the file
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(fileSize - 50000));
+  EXPECT_TRUE(cache.Reset(fileSize - 50000, false));
+  WriteRange(cache, fileSize - 50000, 50000);
+  cache.EndOfInput();
+  ExpectRange(cache, fileSize - 50000, 10000);
+  EXPECT_EQ(2u, cache.GetSegmentCount());
+
+  // back to the head, the data written before is still there
+  EXPECT_TRUE(cache.IsCachedPosition(50000));
+  EXPECT_EQ(100000, cache.CachedDataEndPosIfSeekTo(50000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(50000));
+  EXPECT_FALSE(cache.Reset(50000, false));
+  EXPECT_FALSE(cache.IsEndOfInput());
+  EXPECT_EQ(100000, cache.CachedDataEndPos());
+  ExpectRange(cache, 50000, 50000);
+
+  // and so is the index, including its end of input
+  EXPECT_FALSE(cache.Reset(fileSize - 20000, false));
+  EXPECT_TRUE(cache.IsEndOfInput());
+  ExpectRange(cache, fileSize - 20000, 20000);
+}
+
+TEST(TestSegmentedCache, EvictsLeastRecentlyUsed)
+{
+  const size_t size = 1024 * 1024;
+  CSegmentedCache cache(size, 0, 3);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 100000);
+  EXPECT_TRUE(cache.Reset(10000000, false));
+  WriteRange(cache, 10000000, 100000);
+  EXPECT_TRUE(cache.Reset(20000000, false));
+  WriteRange(cache, 20000000, 100000);
+  EXPECT_EQ(3u, cache.GetSegmentCount());
+
+  // a fourth segment replaces the least recently used one
+  EXPECT_TRUE(cache.Reset(30000000, false));
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(10000000));
+  EXPECT_TRUE(cache.IsCachedPosition(20000000));
+
+  // filling the whole budget in the active segment takes memory from the others
+  for (int64_t pos = 30000000; pos < 30000000 + (int64_t)size; pos += 65536)
+  {
+    WriteRange(cache, pos, 65536);
+    ExpectRange(cache, pos, 65536);
+  }
+  EXPECT_FALSE(cache.IsCachedPosition(10000000));
+  EXPECT_TRUE(cache.IsCachedPosition(30000000 + size - 1));
+}
@@ -18,8 +18,10 @@
  *
  */
 
+#include "filesystem/ArchiveIndexCache.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/ZipManager.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "FileItem.h"
@@ -127,6 +129,28 @@ TEST_F(TestZipFile, Exists)
   EXPECT_TRUE(XFILE::CFile::Exists(strpathinzip));
 }
 
+TEST_F(TestZipFile, IndexCache)
+{
+  std::string reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/reffile.txt.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "");
+  std::vector<SZipEntry> entries;
+  ASSERT_TRUE(g_ZipManager.GetZipList(zipUrl, entries));
+  ASSERT_EQ(1U, entries.size());
+
+  // the index was stored and is read back after the archive is released
+  std::string key = XFILE::CArchiveIndexCache::GetKey(reffile);
+  ASSERT_FALSE(key.empty());
+  EXPECT_TRUE(XFILE::CFile::Exists("special://temp/archivecache/" + key + ".idx"));
+
+  g_ZipManager.release(zipUrl.Get());
+  std::vector<SZipEntry> cached;
+  ASSERT_TRUE(g_ZipManager.GetZipList(zipUrl, cached));
+  ASSERT_EQ(entries.size(), cached.size());
+  EXPECT_STREQ(entries[0].name, cached[0].name);
+  EXPECT_EQ(entries[0].offset, cached[0].offset);
+  EXPECT_EQ(entries[0].usize, cached[0].usize);
+}
+
 TEST_F(TestZipFile, Stat)
 {
   struct __stat64 buffer;
@@ -524,6 +524,7 @@
 #define PVR_RADIO_NEXT_RECORDING_CHANNEL  (PVR_STRINGS_START + 56)
 #define PVR_RADIO_NEXT_RECORDING_CHAN_ICO (PVR_STRINGS_START + 57)
 #define PVR_RADIO_NEXT_RECORDING_DATETIME (PVR_STRINGS_START + 58)
+#define PVR_EPG_MEMORY                    (PVR_STRINGS_START + 59)
 #define PVR_STRINGS_END             PVR_HAS_NONRECORDING_RADIO_TIMER
 
 #define ADSP_CONDITIONS_START       1300
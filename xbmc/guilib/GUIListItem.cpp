@@ -20,17 +20,117 @@
 
 #include "GUIListItem.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <utility>
 
 #include "GUIListItemLayout.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+namespace
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+/* Names registered as keys. Names are never removed, key n is the n-th
+ * registered name and the spelling it was first registered with is kept. */
+class CKeyTable
+{
+public:
+  explicit CKeyTable(bool ignoreCase) : m_ignoreCase(ignoreCase) {}
+
+  CGUIListItem::Key Get(const std::string &name)
+  {
+    std::string lookup(name);
+    if (m_ignoreCase)
+      StringUtils::ToLower(lookup);
+
+    CSingleLock lock(m_critSection);
+    auto it = m_keys.find(lookup);
+    if (it != m_keys.end())
+      return it->second;
+
+    m_names.push_back(name);
+    CGUIListItem::Key key = m_names.size();
+    m_keys.insert(std::make_pair(std::move(lookup), key));
+    return key;
+  }
+
+  CGUIListItem::Key Find(const std::string &name) const
+  {
+    std::string lookup(name);
+    if (m_ignoreCase)
+      StringUtils::ToLower(lookup);
+
+    CSingleLock lock(m_critSection);
+    auto it = m_keys.find(lookup);
+    return it != m_keys.end() ? it->second : 0;
+  }
+
+  std::string GetName(CGUIListItem::Key key) const
+  {
+    CSingleLock lock(m_critSection);
+    if (key == 0 || key > m_names.size())
+      return "";
+    return m_names[key - 1];
+  }
+
+private:
+  bool m_ignoreCase;
+  CCriticalSection m_critSection;
+  std::unordered_map<std::string, CGUIListItem::Key> m_keys;
+  std::vector<std::string> m_names;
+};
+
+CKeyTable &PropertyKeys()
+{
+  static CKeyTable keys(true);
+  return keys;
+}
+
+CKeyTable &ArtKeys()
+{
+  static CKeyTable keys(false);
+  return keys;
+}
+
+// position of a key in a list of key/value pairs ordered by key
+template<typename List>
+auto LowerBound(List &list, CGUIListItem::Key key) -> decltype(list.begin())
+{
+  return std::lower_bound(list.begin(), list.end(), key,
+                          [](const typename List::value_type &entry, CGUIListItem::Key key) { return entry.first < key; });
+}
+
+template<typename List>
+auto Find(List &list, CGUIListItem::Key key) -> decltype(list.begin())
+{
+  auto it = LowerBound(list, key);
+  return it != list.end() && it->first == key ? it : list.end();
+}
+}
+
+CGUIListItem::Key CGUIListItem::GetPropertyKey(const std::string &strKey)
+{
+  return PropertyKeys().Get(strKey);
+}
+
+CGUIListItem::Key CGUIListItem::GetArtKey(const std::string &type)
+{
+  return ArtKeys().Get(type);
+}
+
+// lookups by name don't register names, an unknown name can't be set on any item
+CGUIListItem::Key CGUIListItem::FindPropertyKey(const std::string &strKey)
+{
+  return PropertyKeys().Find(strKey);
+}
+
+CGUIListItem::Key CGUIListItem::FindArtKey(const std::string &type)
+{
+  return ArtKeys().Find(type);
 }
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -113,23 +213,43 @@ const std::wstring& CGUIListItem::GetSortLabel() const
 
 void CGUIListItem::SetArt(const std::string &type, const std::string &url)
 {
-  ArtMap::iterator i = m_art.find(type);
-  if (i == m_art.end() || i->second != url)
+  SetArt(GetArtKey(type), url);
+}
+
+void CGUIListItem::SetArt(Key type, const std::string &url)
+{
+  ArtList::iterator i = LowerBound(m_art, type);
+  if (i == m_art.end() || i->first != type)
+  {
+    m_art.insert(i, std::make_pair(type, url));
+    SetInvalid();
+  }
+  else if (i->second != url)
   {
-    m_art[type] = url;
+    i->second = url;
     SetInvalid();
   }
 }
 
 void CGUIListItem::SetArt(const ArtMap &art)
 {
-  m_art = art;
+  m_art.clear();
+  m_art.reserve(art.size());
+  for (ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
+    m_art.push_back(std::make_pair(GetArtKey(i->first), i->second));
+  std::sort(m_art.begin(), m_art.end(),
+            [](const ArtList::value_type &left, const ArtList::value_type &right) { return left.first < right.first; });
   SetInvalid();
 }
 
 void CGUIListItem::SetArtFallback(const std::string &from, const std::string &to)
 {
-  m_artFallbacks[from] = to;
+  Key fromKey = GetArtKey(from);
+  ArtFallbackList::iterator i = LowerBound(m_artFallbacks, fromKey);
+  if (i == m_artFallbacks.end() || i->first != fromKey)
+    m_artFallbacks.insert(i, std::make_pair(fromKey, GetArtKey(to)));
+  else
+    i->second = GetArtKey(to);
 }
 
 void CGUIListItem::ClearArt()
@@ -146,22 +266,32 @@ void CGUIListItem::AppendArt(const ArtMap &art, const std::string &prefix)
 
 std::string CGUIListItem::GetArt(const std::string &type) const
 {
-  ArtMap::const_iterator i = m_art.find(type);
+  return GetArt(FindArtKey(type));
+}
+
+const std::string &CGUIListItem::GetArt(Key type) const
+{
+  static const std::string empty;
+
+  ArtList::const_iterator i = Find(m_art, type);
   if (i != m_art.end())
     return i->second;
-  i = m_artFallbacks.find(type);
-  if (i != m_artFallbacks.end())
+  ArtFallbackList::const_iterator j = Find(m_artFallbacks, type);
+  if (j != m_artFallbacks.end())
   {
-    ArtMap::const_iterator j = m_art.find(i->second);
-    if (j != m_art.end())
-      return j->second;
+    i = Find(m_art, j->second);
+    if (i != m_art.end())
+      return i->second;
   }
-  return "";
+  return empty;
 }
 
-const CGUIListItem::ArtMap &CGUIListItem::GetArt() const
+CGUIListItem::ArtMap CGUIListItem::GetArt() const
 {
-  return m_art;
+  ArtMap art;
+  for (ArtList::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    art.insert(std::make_pair(ArtKeys().GetName(i->first), i->second));
+  return art;
 }
 
 bool CGUIListItem::HasArt(const std::string &type) const
@@ -169,6 +299,16 @@ bool CGUIListItem::HasArt(const std::string &type) const
   return !GetArt(type).empty();
 }
 
+bool CGUIListItem::HasArt(Key type) const
+{
+  return !GetArt(type).empty();
+}
+
+bool CGUIListItem::HasArt() const
+{
+  return !m_art.empty();
+}
+
 void CGUIListItem::SetIconImage(const std::string& strIcon)
 {
   if (m_strIcon == strIcon)
@@ -243,7 +383,7 @@ CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strIcon = item.m_strIcon;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   SetInvalid();
@@ -261,23 +401,23 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+    ar << (int)m_properties.size();
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
     {
-      ar << it->first;
+      ar << PropertyKeys().GetName(it->first);
       ar << it->second;
     }
     ar << (int)m_art.size();
-    for (ArtMap::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    for (ArtList::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
     {
-      ar << i->first;
+      ar << ArtKeys().GetName(i->first);
       ar << i->second;
     }
     ar << (int)m_artFallbacks.size();
-    for (ArtMap::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); ++i)
+    for (ArtFallbackList::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); ++i)
     {
-      ar << i->first;
-      ar << i->second;
+      ar << ArtKeys().GetName(i->first);
+      ar << ArtKeys().GetName(i->second);
     }
   }
   else
@@ -309,7 +449,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_art.insert(make_pair(key, value));
+      SetArt(GetArtKey(key), value);
     }
     ar >> mapSize;
     for (int i = 0; i < mapSize; i++)
@@ -317,7 +457,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_artFallbacks.insert(make_pair(key, value));
+      SetArtFallback(key, value);
     }
     SetInvalid();
   }
@@ -331,12 +471,12 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+  for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][PropertyKeys().GetName(it->first)] = it->second;
   }
-  for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); ++it)
-    value["art"][it->first] = it->second;
+  for (ArtList::const_iterator it = m_art.begin(); it != m_art.end(); ++it)
+    value["art"][ArtKeys().GetName(it->first)] = it->second;
 }
 
 void CGUIListItem::FreeIcons()
@@ -393,10 +533,15 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  SetProperty(GetPropertyKey(strKey), value);
+}
+
+void CGUIListItem::SetProperty(Key key, const CVariant &value)
+{
+  PropertyList::iterator iter = LowerBound(m_properties, key);
+  if (iter == m_properties.end() || iter->first != key)
   {
-    m_mapProperties.insert(make_pair(strKey, value));
+    m_properties.insert(iter, std::make_pair(key, value));
     SetInvalid();
   }
   else if (iter->second != value)
@@ -408,10 +553,15 @@ void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 
 const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  return GetProperty(FindPropertyKey(strKey));
+}
+
+const CVariant &CGUIListItem::GetProperty(Key key) const
+{
+  PropertyList::const_iterator iter = Find(m_properties, key);
   static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
-  
-  if (iter == m_mapProperties.end())
+
+  if (iter == m_properties.end())
     return nullVariant;
 
   return iter->second;
@@ -419,28 +569,29 @@ const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
+  return HasProperty(FindPropertyKey(strKey));
+}
 
-  return true;
+bool CGUIListItem::HasProperty(Key key) const
+{
+  return Find(m_properties, key) != m_properties.end();
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
+  PropertyList::iterator iter = Find(m_properties, FindPropertyKey(strKey));
+  if (iter != m_properties.end())
   {
-    m_mapProperties.erase(iter);
+    m_properties.erase(iter);
     SetInvalid();
   }
 }
 
 void CGUIListItem::ClearProperties()
 {
-  if (!m_mapProperties.empty())
+  if (!m_properties.empty())
   {
-    m_mapProperties.clear();
+    m_properties.clear();
     SetInvalid();
   }
 }
@@ -461,6 +612,29 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
+  for (PropertyList::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
     SetProperty(i->first, i->second);
 }
+
+size_t CGUIListItem::GetMemoryUsage() const
+{
+  size_t size = sizeof(*this);
+  size += m_strLabel.capacity() + m_strLabel2.capacity() + m_strIcon.capacity();
+  size += m_sortLabel.capacity() * sizeof(wchar_t);
+
+  size += m_properties.capacity() * sizeof(PropertyList::value_type);
+  for (PropertyList::const_iterator i = m_properties.begin(); i != m_properties.end(); ++i)
+  {
+    if (i->second.isString())
+      size += sizeof(std::string) + i->second.size();
+    else if (i->second.isWideString())
+      size += sizeof(std::wstring) + i->second.size() * sizeof(wchar_t);
+  }
+
+  size += m_art.capacity() * sizeof(ArtList::value_type);
+  for (ArtList::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    size += i->second.capacity();
+  size += m_artFallbacks.capacity() * sizeof(ArtFallbackList::value_type);
+
+  return size;
+}
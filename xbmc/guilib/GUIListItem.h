@@ -30,11 +30,14 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/Variant.h"
 
 //  Forward
 class CGUIListItemLayout;
 class CArchive;
-class CVariant;
 
 /*!
  \ingroup controls
@@ -45,6 +48,21 @@ class CGUIListItem
 public:
   typedef std::map<std::string, std::string> ArtMap;
 
+  /*! \brief Interned name of a property or an art type.
+   Skins look up the same properties and art types on every visible item each
+   frame, so their names are resolved to keys once and items store their
+   properties and art by key. Property names are case insensitive. 0 is never
+   a valid key.
+   \sa GetPropertyKey, GetArtKey
+   */
+  typedef unsigned int Key;
+
+  /*! \brief Get the key of a property name, registering the name if needed. */
+  static Key GetPropertyKey(const std::string &strKey);
+
+  /*! \brief Get the key of an art type, registering the type if needed. */
+  static Key GetArtKey(const std::string &type);
+
   ///
   /// @ingroup controls python_xbmcgui_listitem
   /// @defgroup kodi_guilib_listitem_iconoverlay Overlay icon types
@@ -117,12 +135,18 @@ public:
    */
   std::string GetArt(const std::string &type) const;
 
+  /*! \brief Get a particular art type for an item by key
+   \param type key of the art type to fetch, see GetArtKey.
+   \return the art URL, if available, else empty.
+   */
+  const std::string &GetArt(Key type) const;
+
   /*! \brief get artwork for an item
    Retrieves artwork in a type:url map
    \return a type:url map for artwork
    \sa SetArt
    */
-  const ArtMap &GetArt() const;
+  ArtMap GetArt() const;
 
   /*! \brief Check whether an item has a particular piece of art
    Equivalent to !GetArt(type).empty()
@@ -130,6 +154,13 @@ public:
    \return true if the item has that art set, false otherwise.
    */
   bool HasArt(const std::string &type) const;
+  bool HasArt(Key type) const;
+
+  /*! \brief Check whether an item has any art
+   Equivalent to !GetArt().empty() without building the map
+   \return true if the item has any art set, false otherwise.
+   */
+  bool HasArt() const;
 
   void SetSortLabel(const std::string &label);
   void SetSortLabel(const std::wstring &label);
@@ -172,11 +203,21 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const std::string &strKey) const;
-  bool       HasProperties() const { return !m_mapProperties.empty(); };
+  bool       HasProperty(Key key) const;
+  bool       HasProperties() const { return !m_properties.empty(); };
   void       ClearProperty(const std::string &strKey);
 
   const CVariant &GetProperty(const std::string &strKey) const;
 
+  /*! \brief Get a property by key
+   \param key key of the property, see GetPropertyKey.
+   \return the value of the property or a null variant if it isn't set.
+   */
+  const CVariant &GetProperty(Key key) const;
+
+  /*! \brief Get the approximate amount of memory used by the item's labels, properties and art, in bytes. */
+  virtual size_t GetMemoryUsage() const;
+
 protected:
   std::string m_strLabel2;     // text of column2
   std::string m_strIcon;      // filename of icon
@@ -186,19 +227,23 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const std::string &s1, const std::string &s2) const;
-  };
-
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  // properties, art and fallbacks ordered by key
+  typedef std::vector<std::pair<Key, CVariant> > PropertyList;
+  PropertyList m_properties;
 private:
+  typedef std::vector<std::pair<Key, std::string> > ArtList;
+  typedef std::vector<std::pair<Key, Key> > ArtFallbackList;
+
+  static Key FindPropertyKey(const std::string &strKey);
+  static Key FindArtKey(const std::string &type);
+  void SetArt(Key type, const std::string &url);
+  void SetProperty(Key key, const CVariant &value);
+
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
 
-  ArtMap m_art;
-  ArtMap m_artFallbacks;
+  ArtList m_art;
+  ArtFallbackList m_artFallbacks;
 };
 #endif
 
@@ -31,6 +31,8 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "platform/win32/PlatformDefs.h"
+#else
+#include <sys/mman.h>
 #endif
 
 static bool ReadString(FILE* file, char* str, size_t max_length)
@@ -68,7 +70,9 @@ static bool ReadUInt64(FILE* file, uint64_t& value)
 CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path(),
-    m_file(nullptr)
+    m_file(nullptr),
+    m_map(nullptr),
+    m_mapSize(0)
 { }
 
 CXBTFReader::~CXBTFReader()
@@ -176,6 +180,21 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+#ifndef TARGET_WINDOWS
+  // frames are loaded from a mapping of the file, without a seek and read per frame
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0 &&
+      static_cast<uint64_t>(fileStat.st_size) <= SIZE_MAX)
+  {
+    void* map = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileno(m_file), 0);
+    if (map != MAP_FAILED)
+    {
+      m_map = static_cast<const uint8_t*>(map);
+      m_mapSize = static_cast<uint64_t>(fileStat.st_size);
+    }
+  }
+#endif
+
   return true;
 }
 
@@ -186,6 +205,13 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+#ifndef TARGET_WINDOWS
+  if (m_map != nullptr)
+    munmap(const_cast<uint8_t*>(m_map), static_cast<size_t>(m_mapSize));
+#endif
+  m_map = nullptr;
+  m_mapSize = 0;
+
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -208,11 +234,26 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
   return fileStat.st_mtime;
 }
 
+const uint8_t* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (m_map == nullptr || frame.GetOffset() > m_mapSize || frame.GetPackedSize() > m_mapSize - frame.GetOffset())
+    return nullptr;
+
+  return m_map + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
   if (m_file == nullptr)
     return false;
 
+  const uint8_t* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD) || defined(TARGET_ANDROID)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #else
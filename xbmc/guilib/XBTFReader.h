@@ -41,9 +41,17 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Get the (packed) data of a frame without copying it.
+   \return The data, valid until Close(), or nullptr if the file isn't memory mapped.
+   */
+  const uint8_t* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
   std::string m_path;
   FILE* m_file;
+  const uint8_t* m_map;
+  uint64_t m_mapSize;
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -50,6 +50,7 @@ using namespace XFILE;
 
 bool CFileItemHandler::GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
 {
+  const CFileItem *constItem = item.get(); // read the info tags without copying shared ones
   if (result.isMember(field) && !result[field].empty())
     return true;
 
@@ -106,8 +107,8 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
 
     if (field == "art")
     {
-      if (thumbLoader != NULL && item->GetArt().size() <= 0 && !fetchedArt &&
-        ((item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && item->GetMusicInfoTag()->GetDatabaseId() > -1)))
+      if (thumbLoader != NULL && !item->HasArt() && !fetchedArt &&
+        ((item->HasVideoInfoTag() && constItem->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && constItem->GetMusicInfoTag()->GetDatabaseId() > -1)))
       {
         thumbLoader->FillLibraryArt(*item);
         fetchedArt = true;
@@ -128,7 +129,7 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
     if (field == "thumbnail")
     {
       if (thumbLoader != NULL && !item->HasArt("thumb") && !fetchedArt &&
-        ((item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && item->GetMusicInfoTag()->GetDatabaseId() > -1)))
+        ((item->HasVideoInfoTag() && constItem->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && constItem->GetMusicInfoTag()->GetDatabaseId() > -1)))
       {
         thumbLoader->FillLibraryArt(*item);
         fetchedArt = true;
@@ -147,7 +148,7 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
     if (field == "fanart")
     {
       if (thumbLoader != NULL && !item->HasArt("fanart") && !fetchedArt &&
-        ((item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && item->GetMusicInfoTag()->GetDatabaseId() > -1)))
+        ((item->HasVideoInfoTag() && constItem->GetVideoInfoTag()->m_iDbId > -1) || (item->HasMusicInfoTag() && constItem->GetMusicInfoTag()->GetDatabaseId() > -1)))
       {
         thumbLoader->FillLibraryArt(*item);
         fetchedArt = true;
@@ -163,7 +164,7 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
     
     if (item->HasVideoInfoTag() && item->GetVideoContentType() == VIDEODB_CONTENT_TVSHOWS)
     {
-      if (item->GetVideoInfoTag()->m_iSeason < 0 && field == "season")
+      if (constItem->GetVideoInfoTag()->m_iSeason < 0 && field == "season")
       {
         result[field] = (int)item->GetProperty("totalseasons").asInteger();
         return true;
@@ -264,6 +265,7 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
+  const CFileItem *constItem = item.get(); // read the info tags without copying shared ones
   CVariant object;
   std::set<std::string> fields(validFields.begin(), validFields.end());
 
@@ -274,10 +276,10 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
     {
       if (allowFile)
       {
-        if (item->HasVideoInfoTag() && !item->GetVideoInfoTag()->GetPath().empty())
-          object["file"] = item->GetVideoInfoTag()->GetPath().c_str();
-        if (item->HasMusicInfoTag() && !item->GetMusicInfoTag()->GetURL().empty())
-          object["file"] = item->GetMusicInfoTag()->GetURL().c_str();
+        if (item->HasVideoInfoTag() && !constItem->GetVideoInfoTag()->GetPath().empty())
+          object["file"] = constItem->GetVideoInfoTag()->GetPath().c_str();
+        if (item->HasMusicInfoTag() && !constItem->GetMusicInfoTag()->GetURL().empty())
+          object["file"] = constItem->GetMusicInfoTag()->GetURL().c_str();
         if (item->HasPVRRecordingInfoTag() && !item->GetPVRRecordingInfoTag()->GetPath().empty())
           object["file"] = item->GetPVRRecordingInfoTag()->GetPath().c_str();
         if (item->HasPVRTimerInfoTag() && !item->GetPVRTimerInfoTag()->m_strFileNameAndPath.empty())
@@ -299,10 +301,10 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
          object[ID] = item->GetPVRRecordingInfoTag()->m_iRecordingId;
       else if (item->HasPVRTimerInfoTag() && item->GetPVRTimerInfoTag()->m_iTimerId > 0)
          object[ID] = item->GetPVRTimerInfoTag()->m_iTimerId;
-      else if (item->HasMusicInfoTag() && item->GetMusicInfoTag()->GetDatabaseId() > 0)
-        object[ID] = (int)item->GetMusicInfoTag()->GetDatabaseId();
-      else if (item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iDbId > 0)
-        object[ID] = item->GetVideoInfoTag()->m_iDbId;
+      else if (item->HasMusicInfoTag() && constItem->GetMusicInfoTag()->GetDatabaseId() > 0)
+        object[ID] = (int)constItem->GetMusicInfoTag()->GetDatabaseId();
+      else if (item->HasVideoInfoTag() && constItem->GetVideoInfoTag()->m_iDbId > 0)
+        object[ID] = constItem->GetVideoInfoTag()->m_iDbId;
 
       if (stricmp(ID, "id") == 0)
       {
@@ -310,15 +312,15 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
           object["type"] = "channel";
         else if (item->HasMusicInfoTag())
         {
-          std::string type = item->GetMusicInfoTag()->GetType();
+          std::string type = constItem->GetMusicInfoTag()->GetType();
           if (type == MediaTypeAlbum || type == MediaTypeSong || type == MediaTypeArtist)
             object["type"] = type;
           else if (!item->m_bIsFolder)
             object["type"] = MediaTypeSong;
         }
-        else if (item->HasVideoInfoTag() && !item->GetVideoInfoTag()->m_type.empty())
+        else if (item->HasVideoInfoTag() && !constItem->GetVideoInfoTag()->m_type.empty())
         {
-          std::string type = item->GetVideoInfoTag()->m_type;
+          std::string type = constItem->GetVideoInfoTag()->m_type;
           if (type == MediaTypeMovie || type == MediaTypeTvShow || type == MediaTypeEpisode || type == MediaTypeMusicVideo)
             object["type"] = type;
         }
@@ -362,11 +364,11 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
     if (item->HasPVRTimerInfoTag())
       FillDetails(item->GetPVRTimerInfoTag().get(), item, fields, object, thumbLoader);
     if (item->HasVideoInfoTag())
-      FillDetails(item->GetVideoInfoTag(), item, fields, object, thumbLoader);
+      FillDetails(constItem->GetVideoInfoTag(), item, fields, object, thumbLoader);
     if (item->HasMusicInfoTag())
-      FillDetails(item->GetMusicInfoTag(), item, fields, object, thumbLoader);
+      FillDetails(constItem->GetMusicInfoTag(), item, fields, object, thumbLoader);
     if (item->HasPictureInfoTag())
-      FillDetails(item->GetPictureInfoTag(), item, fields, object, thumbLoader);
+      FillDetails(constItem->GetPictureInfoTag(), item, fields, object, thumbLoader);
     
     FillDetails(item.get(), item, fields, object, thumbLoader);
 
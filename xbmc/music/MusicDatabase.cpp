@@ -29,6 +29,7 @@
 #include "Artist.h"
 #include "CueInfoLoader.h"
 #include "dbwrappers/dataset.h"
+#include "dbwrappers/DatabaseWriter.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "dialogs/GUIDialogOK.h"
 #include "dialogs/GUIDialogProgress.h"
@@ -119,6 +120,26 @@ bool CMusicDatabase::Open()
   return CDatabase::Open(g_advancedSettings.m_databaseMusic);
 }
 
+static CDatabaseWriter &GetWriter()
+{
+  static CDatabaseWriter writer([]() -> CDatabase*
+  {
+    std::unique_ptr<CMusicDatabase> db(new CMusicDatabase);
+    return db->Open() ? db.release() : NULL;
+  });
+  return writer;
+}
+
+void CMusicDatabase::QueueWrite(const std::function<void(CMusicDatabase&)> &write)
+{
+  GetWriter().Queue([write](CDatabase &db) { write(static_cast<CMusicDatabase&>(db)); });
+}
+
+bool CMusicDatabase::FlushWrites()
+{
+  return GetWriter().Flush();
+}
+
 void CMusicDatabase::CreateTables()
 {
   CLog::Log(LOGINFO, "create artist table");
@@ -191,6 +212,12 @@ void CMusicDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create cue table");
   m_pDS->exec("CREATE TABLE cue (idPath integer, strFileName text, strCuesheet text)");
+
+  CLog::Log(LOGINFO, "create nav summary tables");
+  m_pDS->exec("CREATE TABLE artistnav (idArtist integer primary key, iAlbums integer, iSongs integer, dateAdded text, "
+              " iArt integer, strArtThumb text, strArtFanart text)");
+  m_pDS->exec("CREATE TABLE albumnav (idAlbum integer primary key, fTimesPlayed FLOAT, dateAdded text, lastplayed varchar(20) default NULL)");
+  m_pDS->exec("CREATE TABLE navdirty (idNavDirty integer primary key, media_type text, media_id integer)");
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -256,11 +283,56 @@ void CMusicDatabase::CreateAnalytics()
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('album', old.idAlbum);"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeletePath AFTER delete ON path FOR EACH ROW BEGIN"
               "  DELETE FROM cue WHERE cue.idPath = old.idPath;"
               " END");
 
+  // the nav summaries of the albums and artists affected by a change are
+  // rebuilt from these by UpdateNavSummaries()
+  m_pDS->exec("CREATE TRIGGER tgrInsertSong AFTER insert ON song FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('album', new.idAlbum);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateSong AFTER update ON song FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('album', old.idAlbum);"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('album', new.idAlbum);"
+              "  INSERT INTO navdirty (media_type, media_id) SELECT 'artist', idArtist FROM song_artist WHERE song_artist.idSong = new.idSong;"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertSongArtist AFTER insert ON song_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', new.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateSongArtist AFTER update ON song_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', old.idArtist);"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', new.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteSongArtist AFTER delete ON song_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', old.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertAlbumArtist AFTER insert ON album_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', new.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateAlbumArtist AFTER update ON album_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', old.idArtist);"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', new.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteAlbumArtist AFTER delete ON album_artist FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES ('artist', old.idArtist);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertArt AFTER insert ON art FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES (new.media_type, new.media_id);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrUpdateArt AFTER update ON art FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES (new.media_type, new.media_id);"
+              " END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteArt AFTER delete ON art FOR EACH ROW BEGIN"
+              "  INSERT INTO navdirty (media_type, media_id) VALUES (old.media_type, old.media_id);"
+              " END");
+
+  CreateSearchIndex("songsearch", "song", "idSong", { "strTitle" });
+  CreateSearchIndex("albumsearch", "album", "idAlbum", { "strAlbum" });
+  CreateSearchIndex("artistsearch", "artist", "idArtist", { "strArtist" });
+
   // we create views last to ensure all indexes are rolled in
   CreateViews();
 }
@@ -316,24 +388,32 @@ void CMusicDatabase::CreateViews()
               "        album.iUserrating, "
               "        album.iVotes, "
               "        bCompilation, "
-              "        (SELECT AVG(song.iTimesPlayed) FROM song WHERE song.idAlbum = album.idAlbum) AS iTimesPlayed, "
+              "        albumnav.fTimesPlayed AS iTimesPlayed, "
               "        strReleaseType, "
-              "        (SELECT MAX(song.dateAdded) FROM song WHERE song.idAlbum = album.idAlbum) AS dateAdded, "
-              "        (SELECT MAX(song.lastplayed) FROM song WHERE song.idAlbum = album.idAlbum) AS lastplayed "
+              "        albumnav.dateAdded AS dateAdded, "
+              "        albumnav.lastplayed AS lastplayed "
               "FROM album"
+              "  LEFT JOIN albumnav ON"
+              "    albumnav.idAlbum = album.idAlbum"
               );
 
   CLog::Log(LOGINFO, "create artist view");
   m_pDS->exec("CREATE VIEW artistview AS SELECT"
-              "  idArtist, strArtist, "
+              "  artist.idArtist AS idArtist, strArtist, "
               "  strMusicBrainzArtistID, "
               "  strBorn, strFormed, strGenres,"
               "  strMoods, strStyles, strInstruments, "
               "  strBiography, strDied, strDisbanded, "
               "  strYearsActive, strImage, strFanart, "
-              "  (SELECT MAX(song.dateAdded) FROM song_artist INNER JOIN song ON song.idSong = song_artist.idSong "
-              "  WHERE song_artist.idArtist = artist.idArtist) AS dateAdded "
-              "FROM artist");
+              "  artistnav.dateAdded AS dateAdded, "
+              "  artistnav.iAlbums AS iAlbums, "
+              "  artistnav.iSongs AS iSongs, "
+              "  artistnav.iArt AS iArt, "
+              "  artistnav.strArtThumb AS strArtThumb, "
+              "  artistnav.strArtFanart AS strArtFanart "
+              "FROM artist"
+              "  LEFT JOIN artistnav ON"
+              "    artistnav.idArtist = artist.idArtist");
 
   CLog::Log(LOGINFO, "create albumartist view");
   m_pDS->exec("CREATE VIEW albumartistview AS SELECT"
@@ -2238,13 +2318,11 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
-                                , search.c_str(), search.c_str(), strVariousArtists.c_str() );
+      strSQL=PrepareSQL("(strArtist like '%s%%' or strArtist like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from artist "
-                                "where strArtist like '%s%%' and strArtist <> '%s' "
-                                , search.c_str(), strVariousArtists.c_str() );
+      strSQL=PrepareSQL("strArtist like '%s%%'", search.c_str());
+    strSQL = PrepareSQL("select * from artist where strArtist <> '%s' and ", strVariousArtists.c_str()) +
+             GetSearchWhere("artistsearch", "artist.idArtist", "", search, search.size() < MIN_FULL_SEARCH_LENGTH, strSQL);
 
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0)
@@ -2785,9 +2863,12 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
+      strSQL=PrepareSQL("(strTitle like '%s%%' or strTitle like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+      strSQL=PrepareSQL("strTitle like '%s%%'", search.c_str());
+    strSQL = "select * from songview where " +
+             GetSearchWhere("songsearch", "songview.idSong", "", search, search.size() < MIN_FULL_SEARCH_LENGTH, strSQL) +
+             " limit 1000";
 
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -2821,9 +2902,11 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
+      strSQL=PrepareSQL("(strAlbum like '%s%%' or strAlbum like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+      strSQL=PrepareSQL("strAlbum like '%s%%'", search.c_str());
+    strSQL = "select * from albumview where " +
+             GetSearchWhere("albumsearch", "albumview.idAlbum", "", search, search.size() < MIN_FULL_SEARCH_LENGTH, strSQL);
 
     if (!m_pDS->query(strSQL)) return false;
 
@@ -3911,6 +3994,15 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
         pItem->GetMusicInfoTag()->SetDatabaseId(artist.idArtist, MediaTypeArtist);
         pItem->SetIconImage("DefaultArtist.png");
 
+        // the thumb loader doesn't need to look up the art if the summary holds all of it
+        std::map<std::string, std::string> art;
+        if (!record->at(artist_strArtThumb).get_asString().empty())
+          art["thumb"] = record->at(artist_strArtThumb).get_asString();
+        if (!record->at(artist_strArtFanart).get_asString().empty())
+          art["fanart"] = record->at(artist_strArtFanart).get_asString();
+        if (!art.empty() && art.size() == (size_t)record->at(artist_iArt).get_asInt())
+          pItem->SetArt(art);
+
         SetPropertiesFromArtist(*pItem, artist);
         items.Add(pItem);
       }
@@ -4963,11 +5055,22 @@ void CMusicDatabase::UpdateTables(int version)
     CMediaSettings::GetInstance().SetMusicNeedsUpdate(60);
     CSettings::GetInstance().Save();
   }
+  if (version < 61)
+  {
+    m_pDS->exec("CREATE TABLE artistnav (idArtist integer primary key, iAlbums integer, iSongs integer, dateAdded text, "
+                " iArt integer, strArtThumb text, strArtFanart text)");
+    m_pDS->exec("CREATE TABLE albumnav (idAlbum integer primary key, fTimesPlayed FLOAT, dateAdded text, lastplayed varchar(20) default NULL)");
+    m_pDS->exec("CREATE TABLE navdirty (idNavDirty integer primary key, media_type text, media_id integer)");
+
+    // the indices are only created after the update, so the summaries are built on first use
+    m_pDS->exec(PrepareSQL("INSERT INTO navdirty (media_type, media_id) SELECT '%s', idArtist FROM artist", MediaTypeArtist));
+    m_pDS->exec(PrepareSQL("INSERT INTO navdirty (media_type, media_id) SELECT '%s', idAlbum FROM album", MediaTypeAlbum));
+  }
 }
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 60;
+  return 62;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, std::vector<std::pair<int,int> > &songIDs)
@@ -5609,14 +5712,86 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 
 bool CMusicDatabase::CommitTransaction()
 {
+  // the summaries are committed with the changes they reflect
+  if (InTransaction())
+    UpdateNavSummaries();
+
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
+  {
+    if (InTransaction()) // only a savepoint of an outer transaction
+      return true;
+
+    // number of items in the db has likely changed, so reset the infomanager cache
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
     return true;
   }
   return false;
 }
 
+void CMusicDatabase::OnAutoCommit(const std::string &strQuery)
+{
+  UpdateNavSummaries();
+}
+
+void CMusicDatabase::UpdateNavSummaries()
+{
+  if (NULL == m_pDB.get()) return;
+
+  // a dataset of its own, the caller may be reading from m_pDS or m_pDS2
+  std::unique_ptr<dbiplus::Dataset> ds(m_pDB->CreateDataset());
+
+  // nothing changed since the last update
+  if (GetSingleValue("SELECT MAX(idNavDirty) FROM navdirty", ds).empty())
+    return;
+
+  bool transaction = !m_pDB->in_transaction();
+  if (transaction)
+    BeginTransaction();
+
+  try
+  {
+    // changes recorded after this are left for the next update
+    int idLast = (int)strtol(GetSingleValue("SELECT MAX(idNavDirty) FROM navdirty", ds).c_str(), NULL, 10);
+    if (idLast > 0)
+    {
+      unsigned int time = XbmcThreads::SystemClockMillis();
+
+      std::string artists = PrepareSQL("SELECT media_id FROM navdirty WHERE media_type = '%s' AND idNavDirty <= %i", MediaTypeArtist, idLast);
+      ds->exec("DELETE FROM artistnav WHERE idArtist IN (" + artists + ")");
+      ds->exec(PrepareSQL("INSERT INTO artistnav (idArtist, iAlbums, iSongs, dateAdded, iArt, strArtThumb, strArtFanart) "
+                             "SELECT artist.idArtist, "
+                             "  (SELECT COUNT(1) FROM album_artist WHERE album_artist.idArtist = artist.idArtist), "
+                             "  (SELECT COUNT(1) FROM song_artist WHERE song_artist.idArtist = artist.idArtist AND song_artist.idRole = %i), "
+                             "  (SELECT MAX(song.dateAdded) FROM song_artist JOIN song ON song.idSong = song_artist.idSong "
+                             "   WHERE song_artist.idArtist = artist.idArtist), "
+                             "  (SELECT COUNT(1) FROM art WHERE art.media_id = artist.idArtist AND art.media_type = '%s'), "
+                             "  (SELECT MAX(url) FROM art WHERE art.media_id = artist.idArtist AND art.media_type = '%s' AND art.type = 'thumb'), "
+                             "  (SELECT MAX(url) FROM art WHERE art.media_id = artist.idArtist AND art.media_type = '%s' AND art.type = 'fanart') "
+                             "FROM artist WHERE artist.idArtist IN (",
+                             ROLE_ARTIST, MediaTypeArtist, MediaTypeArtist, MediaTypeArtist) + artists + ")");
+
+      std::string albums = PrepareSQL("SELECT media_id FROM navdirty WHERE media_type = '%s' AND idNavDirty <= %i", MediaTypeAlbum, idLast);
+      ds->exec("DELETE FROM albumnav WHERE idAlbum IN (" + albums + ")");
+      ds->exec("INSERT INTO albumnav (idAlbum, fTimesPlayed, dateAdded, lastplayed) "
+                  "SELECT song.idAlbum, AVG(song.iTimesPlayed), MAX(song.dateAdded), MAX(song.lastplayed) "
+                  "FROM song WHERE song.idAlbum IN (" + albums + ") GROUP BY song.idAlbum");
+
+      ds->exec(PrepareSQL("DELETE FROM navdirty WHERE idNavDirty <= %i", idLast));
+      CLog::Log(LOGDEBUG, "%s - took %u ms", __FUNCTION__, XbmcThreads::SystemClockMillis() - time);
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    if (transaction)
+      RollbackTransaction();
+    return;
+  }
+
+  if (transaction)
+    CDatabase::CommitTransaction();
+}
+
 bool CMusicDatabase::SetScraperForPath(const std::string& strPath, const ADDON::ScraperPtr& scraper)
 {
   try
@@ -6416,8 +6591,15 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
         filter.AppendWhere(PrepareSQL("artistview.idArtist IN (SELECT song_artist.idArtist FROM song_artist "
           "WHERE song_artist.idSong = %i %s)", idSong, strRoleSQL.c_str()));
       }
+      else if (idRole == ROLE_ARTIST && idGenre <= 0)
+      { // The common nodes, answered from the counts of the nav summary
+        if (albumArtistsOnly)
+          filter.AppendWhere("artistview.iAlbums > 0");
+        else
+          filter.AppendWhere("artistview.iSongs > 0 OR artistview.iAlbums > 0");
+      }
       else
-      { // Artists can be only album artists, so for all artists (with linked albums or songs) 
+      { // Artists can be only album artists, so for all artists (with linked albums or songs)
         // we need to check both album_artist and song_artist tables.
         // Role is determined from song_artist table, so even if looking for album artists only
         // we can check those that have a specific role e.g. which album artist is a composer
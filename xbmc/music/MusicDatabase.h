@@ -22,6 +22,7 @@
 \brief
 */
 #pragma once
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -100,6 +101,27 @@ public:
 
   virtual bool Open();
   virtual bool CommitTransaction();
+
+  /*! \brief Queue a write to the music database, it runs on the shared writer connection.
+   Writes queued close together are committed in one transaction.
+   \sa FlushWrites, CDatabaseWriter
+   */
+  static void QueueWrite(const std::function<void(CMusicDatabase&)> &write);
+
+  /*! \brief Wait until all queued writes to the music database are committed.
+   \return false if they weren't committed in time.
+   \sa QueueWrite
+   */
+  static bool FlushWrites();
+
+  /*! \brief Rebuild the nav summaries of the artists and albums changed since the last update.
+   The artistnav and albumnav tables hold the counts, dates and art the artist and album
+   views would otherwise aggregate from the songs on every browse. Triggers record what a
+   change affects, the summaries are brought up to date by the writers: in CommitTransaction()
+   and after every write committed outside of a transaction, see OnAutoCommit().
+   Reading the views never writes. Runs in the current transaction if there is one.
+   */
+  void UpdateNavSummaries();
   void EmptyCache();
   void Clean();
   int  Cleanup(bool bShowProgress=true);
@@ -513,6 +535,10 @@ protected:
 
   const char *GetBaseDBName() const { return "MyMusic"; };
 
+  /*! \brief Brings the nav summaries up to date after writes outside of a transaction
+   \sa UpdateNavSummaries
+   */
+  virtual void OnAutoCommit(const std::string &strQuery);
 
 private:
   /*! \brief (Re)Create the generic database views for songs and albums
@@ -643,6 +669,11 @@ private:
     artist_strImage,
     artist_strFanart,
     artist_dtDateAdded,
+    artist_iAlbums,
+    artist_iSongs,
+    artist_iArt,
+    artist_strArtThumb,
+    artist_strArtFanart,
     artist_enumCount // end of the enum, do not add past here
   } ArtistFields;
 
@@ -65,19 +65,20 @@ bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
 
 bool CMusicThumbLoader::LoadItemCached(CFileItem* pItem)
 {
+  const CFileItem &constItem = *pItem; // read the info tags without copying shared ones
   if (pItem->m_bIsShareOrDrive)
     return false;
 
-  if (pItem->HasMusicInfoTag() && pItem->GetArt().empty())
+  if (pItem->HasMusicInfoTag() && !pItem->HasArt())
   {
     if (FillLibraryArt(*pItem))
       return true;
       
-    if (pItem->GetMusicInfoTag()->GetType() == MediaTypeArtist)
+    if (constItem.GetMusicInfoTag()->GetType() == MediaTypeArtist)
       return false; // No fallback
   }
 
-  if (pItem->HasVideoInfoTag() && pItem->GetArt().empty())
+  if (pItem->HasVideoInfoTag() && !pItem->HasArt())
   { // music video
     CVideoThumbLoader loader;
     if (loader.LoadItemCached(pItem))
@@ -98,9 +99,9 @@ bool CMusicThumbLoader::LoadItemCached(CFileItem* pItem)
     {
       pItem->SetArt("fanart", art);
     }
-    else if (pItem->HasMusicInfoTag() && !pItem->GetMusicInfoTag()->GetArtist().empty())
+    else if (pItem->HasMusicInfoTag() && !constItem.GetMusicInfoTag()->GetArtist().empty())
     {
-      std::string artist = pItem->GetMusicInfoTag()->GetArtist()[0];
+      std::string artist = constItem.GetMusicInfoTag()->GetArtist()[0];
       m_musicDatabase->Open();
       int idArtist = m_musicDatabase->GetArtistByName(artist);
       if (idArtist >= 0)
@@ -111,12 +112,12 @@ bool CMusicThumbLoader::LoadItemCached(CFileItem* pItem)
           pItem->SetArt("artist.fanart", fanart);
           pItem->SetArtFallback("fanart", "artist.fanart");
         }
-        else if (!pItem->GetMusicInfoTag()->GetAlbumArtist().empty() &&
-                 pItem->GetMusicInfoTag()->GetAlbumArtist()[0] != artist)
+        else if (!constItem.GetMusicInfoTag()->GetAlbumArtist().empty() &&
+                 constItem.GetMusicInfoTag()->GetAlbumArtist()[0] != artist)
         {
           // If no artist fanart and the album artist is different to the artist,
           // try to get fanart from the album artist
-          artist = pItem->GetMusicInfoTag()->GetAlbumArtist()[0];
+          artist = constItem.GetMusicInfoTag()->GetAlbumArtist()[0];
           idArtist = m_musicDatabase->GetArtistByName(artist);
           if (idArtist >= 0)
           {
@@ -138,10 +139,11 @@ bool CMusicThumbLoader::LoadItemCached(CFileItem* pItem)
 
 bool CMusicThumbLoader::LoadItemLookup(CFileItem* pItem)
 {
+  const CFileItem &constItem = *pItem; // read the info tags without copying shared ones
   if (pItem->m_bIsShareOrDrive)
     return false;
 
-  if (pItem->HasMusicInfoTag() && pItem->GetMusicInfoTag()->GetType() == MediaTypeArtist) // No fallback for artist
+  if (pItem->HasMusicInfoTag() && constItem.GetMusicInfoTag()->GetType() == MediaTypeArtist) // No fallback for artist
     return false;
 
   if (pItem->HasVideoInfoTag())
@@ -154,7 +156,7 @@ bool CMusicThumbLoader::LoadItemLookup(CFileItem* pItem)
   if (!pItem->HasArt("thumb"))
   {
     // Look for embedded art
-    if (pItem->HasMusicInfoTag() && !pItem->GetMusicInfoTag()->GetCoverArtInfo().empty())
+    if (pItem->HasMusicInfoTag() && !constItem.GetMusicInfoTag()->GetCoverArtInfo().empty())
     {
       // The item has got embedded art but user thumbs overrule, so check for those first
       if (!FillThumb(*pItem, false)) // Check for user thumbs but ignore folder thumbs
@@ -192,7 +194,11 @@ bool CMusicThumbLoader::FillThumb(CFileItem &item, bool folderThumbs /* = true *
 
 bool CMusicThumbLoader::FillLibraryArt(CFileItem &item)
 {
-  CMusicInfoTag &tag = *item.GetMusicInfoTag();
+  const CFileItem &constItem = item; // read the info tag without copying a shared one
+  if (!constItem.HasMusicInfoTag())
+    return item.HasArt();
+
+  const CMusicInfoTag &tag = *constItem.GetMusicInfoTag();
   if (tag.GetDatabaseId() > -1 && !tag.GetType().empty())
   {
     m_musicDatabase->Open();
@@ -235,7 +241,7 @@ bool CMusicThumbLoader::FillLibraryArt(CFileItem &item)
     }
     m_musicDatabase->Close();
   }
-  return !item.GetArt().empty();
+  return item.HasArt();
 }
 
 bool CMusicThumbLoader::GetEmbeddedThumb(const std::string &path, EmbeddedArt &art)
@@ -31,10 +31,14 @@
 #include <utility>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -67,6 +71,14 @@
 
 #define HEADER_NEWLINE        "\r\n"
 
+// minimum size of the blocks MHD reads from files through ContentReaderCallback
+#define FILE_DOWNLOAD_BLOCK_SIZE (64 * 1024)
+
+// MHD sends responses created from a file descriptor with sendfile() where possible
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094400)
+#define HAS_FILE_DESCRIPTOR_RESPONSE
+#endif
+
 typedef struct {
   std::shared_ptr<XFILE::CFile> file;
   CHttpRanges ranges;
@@ -116,6 +128,30 @@ static MHD_Response* create_response(size_t size, void* data, int free, int copy
 #endif
 }
 
+#ifdef HAS_FILE_DESCRIPTOR_RESPONSE
+static int OpenLocalFile(const std::string &path, uint64_t length)
+{
+  // only plain files, not files inside archives, stacks etc.
+  std::string localPath = CSpecialProtocol::TranslatePath(path);
+  if (!CURL(localPath).GetProtocol().empty())
+    return -1;
+
+  int fd = open(localPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  // make sure the length of the response matches what's on disk
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || static_cast<uint64_t>(st.st_size) != length)
+  {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+#endif
+
 int CWebServer::AskForAuthentication(struct MHD_Connection *connection) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -850,18 +886,40 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
-    // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
-    if (response == nullptr)
+    response = nullptr;
+#ifdef HAS_FILE_DESCRIPTOR_RESPONSE
+    // the whole file or a single range of a local file doesn't need to pass through our buffers
+    if (context->rangeCountTotal == 1 && totalLength > 0)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
+      int fd = OpenLocalFile(filePath, fileLength);
+      if (fd >= 0)
+      {
+        // mhd closes the descriptor together with the response
+        response = MHD_create_response_from_fd_at_offset64(totalLength, fd, context->writePosition);
+        if (response == nullptr)
+          close(fd);
+      }
     }
+#endif
 
-    context.release(); // ownership was passed to mhd
+    if (response == nullptr)
+    {
+      // read in multiples of the chunk size of the file, network protocols don't like small reads
+      size_t blockSize = XFILE::CFile::GetChunkSize(file->GetChunkSize(), FILE_DOWNLOAD_BLOCK_SIZE);
+
+      // create the response object
+      response = MHD_create_response_from_callback(totalLength, blockSize,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
+
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
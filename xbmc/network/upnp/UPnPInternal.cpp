@@ -604,7 +604,8 @@ BuildObject(CFileItem&                    item,
             object->m_ExtraInfo.album_arts.Add(art);
         }
 
-        for (CGUIListItem::ArtMap::const_iterator itArtwork = item.GetArt().begin(); itArtwork != item.GetArt().end(); ++itArtwork) {
+        const CGUIListItem::ArtMap artwork = item.GetArt();
+        for (CGUIListItem::ArtMap::const_iterator itArtwork = artwork.begin(); itArtwork != artwork.end(); ++itArtwork) {
             if (!itArtwork->first.empty() && !itArtwork->second.empty()) {
                 std::string wrappedUrl = CTextureUtils::GetWrappedImageURL(itArtwork->second);
                 object->m_XbmcInfo.artwork.Add(itArtwork->first.c_str(),
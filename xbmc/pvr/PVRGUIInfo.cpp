@@ -20,6 +20,7 @@
 
 #include "Application.h"
 #include "GUIInfoManager.h"
+#include "epg/EpgContainer.h"
 #include "epg/EpgInfoTag.h"
 #include "guiinfo/GUIInfoLabels.h"
 #include "guilib/LocalizeStrings.h"
@@ -72,6 +73,7 @@ void CPVRGUIInfo::ResetProperties(void)
   m_iBackendDiskUsed            = 0;
   m_ToggleShowInfo.SetInfinite();
   m_iDuration                   = 0;
+  m_iEpgMemoryUsage             = 0;
   m_bIsPlayingTV                = false;
   m_bIsPlayingRadio             = false;
   m_bIsPlayingRecording         = false;
@@ -362,6 +364,9 @@ bool CPVRGUIInfo::TranslateCharInfo(DWORD dwInfo, std::string &strValue) const
   case PVR_RADIO_NEXT_RECORDING_DATETIME:
     m_radioTimersInfo.CharInfoNextTimerDateTime(strValue);
     break;
+  case PVR_EPG_MEMORY:
+    CharInfoEpgMemory(strValue);
+    break;
   case PVR_PLAYING_DURATION:
     CharInfoPlayingDuration(strValue);
     break;
@@ -676,6 +681,12 @@ void CPVRGUIInfo::CharInfoBackendDeletedRecordings(std::string &strValue) const
   strValue = m_strBackendDeletedRecordings;
 }
 
+void CPVRGUIInfo::CharInfoEpgMemory(std::string &strValue) const
+{
+  m_updateBackendCacheRequested = true;
+  strValue = StringUtils::SizeToString(m_iEpgMemoryUsage);
+}
+
 void CPVRGUIInfo::CharInfoPlayingClientName(std::string &strValue) const
 {
   if (m_strPlayingClientName.empty())
@@ -726,12 +737,15 @@ void CPVRGUIInfo::UpdateBackendCache(void)
   if (m_iCurrentActiveClient == 0 && m_updateBackendCacheRequested)
   {
     std::vector<SBackend> backendProperties;
+    size_t iEpgMemoryUsage;
     {
       CSingleExit exit(m_critSection);
       backendProperties = g_PVRClients->GetBackendProperties();
+      iEpgMemoryUsage = g_EpgContainer.GetMemoryUsage();
     }
 
     m_backendProperties = backendProperties;
+    m_iEpgMemoryUsage = iEpgMemoryUsage;
     m_updateBackendCacheRequested = false;
   }
 
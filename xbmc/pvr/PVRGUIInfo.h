@@ -216,6 +216,7 @@ namespace PVR
     void CharInfoBackendTimers(std::string &strValue) const;
     void CharInfoBackendRecordings(std::string &strValue) const;
     void CharInfoBackendDeletedRecordings(std::string &strValue) const;
+    void CharInfoEpgMemory(std::string &strValue) const;
     void CharInfoPlayingClientName(std::string &strValue) const;
     void CharInfoEncryption(std::string &strValue) const;
     void CharInfoService(std::string &strValue) const;
@@ -244,6 +245,7 @@ namespace PVR
     std::string                     m_strBackendChannels;
     long long                       m_iBackendDiskTotal;
     long long                       m_iBackendDiskUsed;
+    size_t                          m_iEpgMemoryUsage;
     unsigned int                    m_iDuration;
     bool                            m_bIsPlayingTV;
     bool                            m_bIsPlayingRadio;
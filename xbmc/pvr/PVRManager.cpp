@@ -654,6 +654,7 @@ bool CPVRManager::Load(bool bShowProgress)
     return false;
 
   CLog::Log(LOGDEBUG, "PVRManager - %s - active clients found. continue to start", __FUNCTION__);
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
 
   /* load all channels and groups */
   if (bShowProgress)
@@ -661,19 +662,37 @@ bool CPVRManager::Load(bool bShowProgress)
   if (!m_channelGroups->Load() || !IsInitialising())
     return false;
 
+  CLog::Log(LOGNOTICE, "PVRManager - %s - channel list loaded in %u ms", __FUNCTION__, XbmcThreads::SystemClockMillis() - iStart);
+
+  /* the channel list can be shown while timers and recordings are still loading */
   SetChanged();
   NotifyObservers(ObservableMessageChannelGroupsLoaded);
 
-  /* get timers from the backends */
-  if (bShowProgress)
-    ShowProgressDialog(g_localizeStrings.Get(19237), 50); // Loading timers from clients
-  m_timers->Load();
+  /* get timers and recordings from the backends. both only depend on the channels,
+     so timers are loaded by a dedicated worker while this thread loads the recordings */
+  std::shared_ptr<CEvent> timersLoaded(new CEvent(true));
+  CPVRTimersPtr timers(m_timers);
+  if (!CJobManager::GetInstance().Submit([timers, timersLoaded]() {
+    timers->Load();
+    timersLoaded->Set();
+  }, CJob::PRIORITY_DEDICATED))
+  {
+    /* the job manager is stopping, load them here */
+    timers->Load();
+    timersLoaded->Set();
+  }
 
-  /* get recordings from the backend */
   if (bShowProgress)
-    ShowProgressDialog(g_localizeStrings.Get(19238), 75); // Loading recordings from clients
+    ShowProgressDialog(g_localizeStrings.Get(19238), 50); // Loading recordings from clients
   m_recordings->Load();
 
+  /* wait until the timers are loaded too */
+  if (bShowProgress && !timersLoaded->WaitMSec(0))
+    ShowProgressDialog(g_localizeStrings.Get(19237), 75); // Loading timers from clients
+  timersLoaded->Wait();
+
+  CLog::Log(LOGDEBUG, "PVRManager - %s - channels, timers and recordings loaded in %u ms", __FUNCTION__, XbmcThreads::SystemClockMillis() - iStart);
+
   if (!IsInitialising())
     return false;
 
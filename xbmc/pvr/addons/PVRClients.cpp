@@ -21,6 +21,8 @@
 #include "PVRClients.h"
 
 #include <cassert>
+#include <iterator>
+#include <memory>
 #include <utility>
 #include <functional>
 
@@ -41,6 +43,9 @@
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/timers/PVRTimers.h"
 #include "settings/Settings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/Variant.h"
 
 using namespace ADDON;
@@ -360,6 +365,60 @@ int CPVRClients::GetCreatedClients(PVR_CLIENTMAP &clients) const
   return iReturn;
 }
 
+PVR_ERROR CPVRClients::ForCreatedClients(const char *strFunctionName, const PVRClientFunction &function, std::vector<int> &failedClients) const
+{
+  struct CallState
+  {
+    CCriticalSection critSection;
+    CEvent done{true};
+    size_t iPending = 0;
+    PVR_ERROR error = PVR_ERROR_NO_ERROR;
+    std::vector<int> failedClients;
+  };
+
+  PVR_CLIENTMAP clients;
+  GetCreatedClients(clients);
+  if (clients.empty())
+    return PVR_ERROR_NO_ERROR;
+
+  std::shared_ptr<CallState> state(new CallState);
+  state->iPending = clients.size();
+
+  auto call = [state, strFunctionName, function](int iClientId, const PVR_CLIENT &client)
+  {
+    PVR_ERROR currentError = function(client);
+
+    CSingleLock lock(state->critSection);
+    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
+        currentError != PVR_ERROR_NO_ERROR)
+    {
+      CLog::Log(LOGERROR, "PVR - %s - client '%d' returned an error: %s", strFunctionName, iClientId, CPVRClient::ToString(currentError));
+      state->error = currentError;
+      state->failedClients.push_back(iClientId);
+    }
+
+    if (--state->iPending == 0)
+      state->done.Set();
+  };
+
+  /* the first client is handled by the calling thread, the others by dedicated workers */
+  for (PVR_CLIENTMAP_CITR it = std::next(clients.begin()); it != clients.end(); ++it)
+  {
+    const int iClientId = it->first;
+    const PVR_CLIENT client = it->second;
+    /* once the job manager is stopping, the client is handled here */
+    if (!CJobManager::GetInstance().Submit([call, iClientId, client]() { call(iClientId, client); }, CJob::PRIORITY_DEDICATED))
+      call(iClientId, client);
+  }
+  call(clients.begin()->first, clients.begin()->second);
+
+  state->done.Wait();
+
+  CSingleLock lock(state->critSection);
+  failedClients.insert(failedClients.end(), state->failedClients.begin(), state->failedClients.end());
+  return state->error;
+}
+
 int CPVRClients::GetPlayingClientID(void) const
 {
   CSingleLock lock(m_critSection);
@@ -472,24 +531,10 @@ bool CPVRClients::HasTimerSupport(int iClientId)
 
 bool CPVRClients::GetTimers(CPVRTimers *timers, std::vector<int> &failedClients)
 {
-  bool bSuccess(true);
-  PVR_CLIENTMAP clients;
-  GetCreatedClients(clients);
-
   /* get the timer list from each client */
-  for (const auto &client : clients)
-  {
-    PVR_ERROR currentError = client.second->GetTimers(timers);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
-    {
-      CLog::Log(LOGERROR, "PVR - %s - cannot get timers from client '%d': %s",__FUNCTION__, client.first, CPVRClient::ToString(currentError));
-      bSuccess = false;
-      failedClients.push_back(client.first);
-    }
-  }
-
-  return bSuccess;
+  return ForCreatedClients(__FUNCTION__, [timers](const PVR_CLIENT &client) {
+    return client->GetTimers(timers);
+  }, failedClients) == PVR_ERROR_NO_ERROR;
 }
 
 PVR_ERROR CPVRClients::AddTimer(const CPVRTimerInfoTag &timer)
@@ -588,22 +633,10 @@ PVR_ERROR CPVRClients::GetTimerTypes(CPVRTimerTypes& results, int iClientId) con
 
 PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted)
 {
-  PVR_ERROR error(PVR_ERROR_NO_ERROR);
-  PVR_CLIENTMAP clients;
-  GetCreatedClients(clients);
-
-  for (const auto &client : clients)
-  {
-    PVR_ERROR currentError = client.second->GetRecordings(recordings, deleted);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
-    {
-      CLog::Log(LOGERROR, "PVR - %s - cannot get recordings from client '%d': %s",__FUNCTION__, client.first, CPVRClient::ToString(currentError));
-      error = currentError;
-    }
-  }
-
-  return error;
+  std::vector<int> failedClients;
+  return ForCreatedClients(__FUNCTION__, [recordings, deleted](const PVR_CLIENT &client) {
+    return client->GetRecordings(recordings, deleted);
+  }, failedClients);
 }
 
 PVR_ERROR CPVRClients::RenameRecording(const CPVRRecording &recording)
@@ -29,6 +29,7 @@
 #include "addons/PVRClient.h"
 
 #include <deque>
+#include <functional>
 #include <vector>
 
 namespace EPG
@@ -699,6 +700,18 @@ namespace PVR
      */
     int GetCreatedClients(PVR_CLIENTMAP &clients) const;
 
+    typedef std::function<PVR_ERROR(const PVR_CLIENT &client)> PVRClientFunction;
+
+    /*!
+     * @brief Call a function for all created clients. When more than one client is created, the
+     *        clients are called in parallel, so a slow backend doesn't delay the others.
+     * @param strFunctionName The name of the calling function, used for logging.
+     * @param function The function to call for each client. It must be safe to call it from multiple threads.
+     * @param failedClients Will contain the ids of the clients for which the function failed.
+     * @return PVR_ERROR_NO_ERROR on success for all clients, the last error otherwise.
+     */
+    PVR_ERROR ForCreatedClients(const char *strFunctionName, const PVRClientFunction &function, std::vector<int> &failedClients) const;
+
     /*!
      * @brief Check whether a client is registered.
      * @param client The client to check.
@@ -59,10 +59,40 @@ CPVRRecordings::~CPVRRecordings()
 
 void CPVRRecordings::UpdateFromClients(void)
 {
-  CSingleLock lock(m_critSection);
-  Clear();
+  {
+    CSingleLock lock(m_critSection);
+    m_updatedRecordings.clear();
+  }
+
+  /* clients are queried in parallel and add their recordings to m_updatedRecordings through
+     UpdateFromClient(), so the lock must not be held here */
   g_PVRClients->GetRecordings(this, false);
   g_PVRClients->GetRecordings(this, true);
+
+  /* replace the recordings in one go, so the list is never seen empty or half filled */
+  PVR_RECORDINGMAP oldRecordings;
+  {
+    CSingleLock lock(m_critSection);
+    oldRecordings.swap(m_recordings);
+    Clear();
+    m_recordings.swap(m_updatedRecordings);
+
+    for (const auto &recording : m_recordings)
+    {
+      if (recording.second->IsRadio())
+      {
+        ++m_iRadioRecordings;
+        if (recording.second->IsDeleted())
+          m_bDeletedRadioRecordings = true;
+      }
+      else
+      {
+        ++m_iTVRecordings;
+        if (recording.second->IsDeleted())
+          m_bDeletedTVRecordings = true;
+      }
+    }
+  }
 }
 
 std::string CPVRRecordings::TrimSlashes(const std::string &strOrig) const
@@ -430,6 +460,26 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
 {
   CSingleLock lock(m_critSection);
 
+  /* while updating, the recordings are collected aside and counted once they are all there */
+  if (m_bIsUpdating)
+  {
+    const CPVRRecordingUid uid(tag->m_iClientId, tag->m_strRecordingId);
+    PVR_RECORDINGMAP_ITR it = m_updatedRecordings.find(uid);
+    if (it != m_updatedRecordings.end())
+    {
+      it->second->Update(*tag);
+    }
+    else
+    {
+      CPVRRecordingPtr newTag = CPVRRecordingPtr(new CPVRRecording);
+      newTag->Update(*tag);
+      SetEpgTagRecording(newTag);
+      newTag->m_iRecordingId = ++m_iLastId;
+      m_updatedRecordings.insert(std::make_pair(uid, newTag));
+    }
+    return;
+  }
+
   if (tag->IsDeleted())
   {
     if (tag->IsRadio())
@@ -447,16 +497,7 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
   {
     newTag = CPVRRecordingPtr(new CPVRRecording);
     newTag->Update(*tag);
-    if (newTag->BroadcastUid() != EPG_TAG_INVALID_UID)
-    {
-      const CPVRChannelPtr channel(newTag->Channel());
-      if (channel)
-      {
-        const EPG::CEpgInfoTagPtr epgTag = EPG::CEpgContainer::GetInstance().GetTagById(channel, newTag->BroadcastUid());
-        if (epgTag)
-          epgTag->SetRecording(newTag);
-      }
-    }
+    SetEpgTagRecording(newTag);
     newTag->m_iRecordingId = ++m_iLastId;
     m_recordings.insert(std::make_pair(CPVRRecordingUid(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
     if (newTag->IsRadio())
@@ -466,6 +507,20 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
   }
 }
 
+void CPVRRecordings::SetEpgTagRecording(const CPVRRecordingPtr &recording)
+{
+  if (recording->BroadcastUid() != EPG_TAG_INVALID_UID)
+  {
+    const CPVRChannelPtr channel(recording->Channel());
+    if (channel)
+    {
+      const EPG::CEpgInfoTagPtr epgTag = EPG::CEpgContainer::GetInstance().GetTagById(channel, recording->BroadcastUid());
+      if (epgTag)
+        epgTag->SetRecording(recording);
+    }
+  }
+}
+
 CPVRRecordingPtr CPVRRecordings::GetRecordingForEpgTag(const EPG::CEpgInfoTagPtr &epgTag) const
 {
   CSingleLock lock(m_critSection);
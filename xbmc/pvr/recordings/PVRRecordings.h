@@ -47,6 +47,7 @@ namespace PVR
     CCriticalSection             m_critSection;
     bool                         m_bIsUpdating;
     PVR_RECORDINGMAP             m_recordings;
+    PVR_RECORDINGMAP             m_updatedRecordings; /*!< recordings collected from the clients while updating */
     unsigned int                 m_iLastId;
     CVideoDatabase               m_database;
     bool                         m_bDeletedTVRecordings;
@@ -55,6 +56,7 @@ namespace PVR
     unsigned int                 m_iRadioRecordings;
 
     virtual void UpdateFromClients(void);
+    void SetEpgTagRecording(const CPVRRecordingPtr &recording);
     virtual std::string TrimSlashes(const std::string &strOrig) const;
     virtual bool IsDirectoryMember(const std::string &strDirectory, const std::string &strEntryDirectory, bool bGrouped) const;
     virtual void GetSubDirectories(const CPVRRecordingsPath &recParentPath, CFileItemList *results);
@@ -321,6 +321,8 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlKeepAliveTime = 30;       //seconds an idle curl session (and its connections) is kept
+  m_nfsReadWindow = 4;            //number of nfs read requests kept in flight while caching
 
 #if defined(TARGET_DARWIN_IOS)
   m_startFullScreen = true;
@@ -360,6 +362,11 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // number of separately filled ranges a memory cache may keep, e.g. an index
+  // at the end of the file, the playback position and recent seek targets
+  m_cacheSegments = 4;
+  // disk space in MB for blocks of remote files kept between sessions, 0 disables it
+  m_blockCacheSize = 0;
 
   m_addonPackageFolderSize = 200;
 
@@ -379,7 +386,10 @@ void CAdvancedSettings::Initialize()
   m_airPlayPort = 36667;
 
   m_databaseMusic.Reset();
+  m_databaseMusic.journalmode = "wal";
   m_databaseVideo.Reset();
+  m_databaseVideo.journalmode = "wal";
+  m_databaseVideo.querycachesize = 8192;
 
   m_pictureExtensions = ".png|.jpg|.jpeg|.bmp|.gif|.ico|.tif|.tiff|.tga|.pcx|.cbz|.cbr|.rss|.webp|.jp2|.apng";
   m_musicExtensions = ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.gdm|.imf|.m15|.sfx|.uni|.ac3|.dts|.aif|.aiff|.wpl|.ape|.mac|.mpc|.mp+|.mpp|.shn|.wv|.dsp|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.sap|.cmc|.cmr|.dmc|.mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.wtv|.mka|.tak|.opus|.dff|.dsf";
@@ -791,6 +801,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetUInt(pElement, "curlkeepalivetime", m_curlKeepAliveTime, 1, 3600);
+    XMLUtils::GetInt(pElement, "nfsreadwindow", m_nfsReadWindow, 1, 32);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
@@ -799,6 +811,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "segments", m_cacheSegments, 1, 16);
+    XMLUtils::GetUInt(pElement, "blockcachesize", m_blockCacheSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -1090,6 +1104,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseVideo.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseVideo.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseVideo.compression);
+    XMLUtils::GetString(pDatabase, "journalmode", m_databaseVideo.journalmode);
+    XMLUtils::GetString(pDatabase, "synchronous", m_databaseVideo.synchronous);
+    XMLUtils::GetUInt(pDatabase, "querycachesize", m_databaseVideo.querycachesize);
+    XMLUtils::GetUInt(pDatabase, "querycachetime", m_databaseVideo.querycachetime);
   }
 
   pDatabase = pRootElement->FirstChildElement("musicdatabase");
@@ -1107,6 +1125,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseMusic.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseMusic.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseMusic.compression);
+    XMLUtils::GetString(pDatabase, "journalmode", m_databaseMusic.journalmode);
+    XMLUtils::GetString(pDatabase, "synchronous", m_databaseMusic.synchronous);
   }
 
   pDatabase = pRootElement->FirstChildElement("tvdatabase");
@@ -61,6 +61,10 @@ public:
     capath.clear();
     ciphers.clear();
     compression = false;
+    journalmode = "delete";
+    synchronous = "normal";
+    querycachesize = 0;
+    querycachetime = 60;
   };
   std::string type;
   std::string host;
@@ -74,6 +78,10 @@ public:
   std::string capath;
   std::string ciphers;
   bool compression;
+  std::string journalmode; ///< sqlite journal mode, the library databases use WAL so readers continue while a writer commits
+  std::string synchronous; ///< sqlite synchronous level, how often commits are synced to disk
+  unsigned int querycachesize; ///< size of the query result cache in KB, 0 disables it
+  unsigned int querycachetime; ///< seconds results from a shared (mysql) database are cached, other clients may write to it
 };
 
 struct TVShowRegexp
@@ -298,6 +306,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    unsigned int m_curlKeepAliveTime;
+    int m_nfsReadWindow;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -345,6 +355,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cacheSegments;
+    unsigned int m_blockCacheSize;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -21,6 +21,7 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "video/VideoInfoTag.h"
 
 #include "gtest/gtest.h"
 
@@ -136,3 +137,87 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, PropertiesAndArt)
+{
+  CFileItem item("label");
+  item.SetProperty("TestFileItem.Property", "value");
+  EXPECT_TRUE(item.HasProperty("testfileitem.property"));
+  EXPECT_STREQ("value", item.GetProperty(CGUIListItem::GetPropertyKey("TESTFILEITEM.PROPERTY")).asString().c_str());
+  EXPECT_TRUE(item.GetProperty("TestFileItem.Unknown").isNull());
+
+  EXPECT_FALSE(item.HasArt());
+  item.SetArt("testfileitem.thumb", "thumb.jpg");
+  EXPECT_TRUE(item.HasArt());
+  item.SetArtFallback("testfileitem.poster", "testfileitem.thumb");
+  EXPECT_EQ("thumb.jpg", item.GetArt(CGUIListItem::GetArtKey("testfileitem.poster")));
+  EXPECT_EQ("", item.GetArt("TestFileItem.Thumb"));
+
+  CGUIListItem::ArtMap art = item.GetArt();
+  ASSERT_EQ(1U, art.size());
+  EXPECT_EQ("thumb.jpg", art["testfileitem.thumb"]);
+  item.ClearArt();
+  EXPECT_FALSE(item.HasArt());
+
+  item.ClearProperty("TESTFILEITEM.property");
+  EXPECT_FALSE(item.HasProperty("TestFileItem.Property"));
+}
+
+// Reports the memory used by a typical library listing item
+TEST(TestFileItem, MemoryUsage)
+{
+  const int count = 10000;
+  std::vector<CFileItemPtr> items;
+  items.reserve(count);
+
+  size_t total = 0;
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem("Movie title"));
+    item->SetPath("smb://server/share/movies/Movie title (2016)/Movie title.mkv");
+    item->SetLabel2("2016");
+    item->SetProperty("original_listitem_url", item->GetPath());
+    item->SetProperty("IsPlayable", "true");
+    item->SetProperty("TotalTime", 5400);
+    item->SetProperty("ResumeTime", 0);
+    item->SetArt("thumb", "image://smb%3a%2f%2fserver%2fshare%2fmovies%2fMovie%20title%2fposter.jpg/");
+    item->SetArt("poster", "image://smb%3a%2f%2fserver%2fshare%2fmovies%2fMovie%20title%2fposter.jpg/");
+    item->SetArt("fanart", "image://smb%3a%2f%2fserver%2fshare%2fmovies%2fMovie%20title%2ffanart.jpg/");
+    item->SetArtFallback("tvshow.poster", "poster");
+    item->SetMimeType("video/x-matroska");
+    item->GetVideoInfoTag()->m_strTitle = "Movie title";
+    total += item->GetMemoryUsage();
+    items.push_back(item);
+  }
+
+  size_t perItem = total / count;
+  RecordProperty("BytesPerItem", (int)perItem);
+  EXPECT_GE(perItem, sizeof(CFileItem));
+
+  // copies share the info tags, which are split between original and copy
+  size_t copied = 0;
+  for (int i = 0; i < count; i++)
+  {
+    CFileItem copy(*items[i]);
+    copied += copy.GetMemoryUsage();
+  }
+  RecordProperty("BytesPerCopiedItem", (int)(copied / count));
+  EXPECT_LT(copied, total);
+}
+
+TEST(TestFileItem, CopySharesInfoTags)
+{
+  CFileItem item("label");
+  item.GetVideoInfoTag()->m_strTitle = "title";
+
+  CFileItem copy(item);
+  const CFileItem &constItem = item;
+  const CFileItem &constCopy = copy;
+  EXPECT_EQ(constItem.GetVideoInfoTag(), constCopy.GetVideoInfoTag());
+  EXPECT_FALSE(constCopy.HasMusicInfoTag());
+
+  copy.GetVideoInfoTag()->m_strTitle = "changed";
+  EXPECT_NE(constItem.GetVideoInfoTag(), constCopy.GetVideoInfoTag());
+  EXPECT_EQ("title", constItem.GetVideoInfoTag()->m_strTitle);
+  EXPECT_EQ("changed", constCopy.GetVideoInfoTag()->m_strTitle);
+}
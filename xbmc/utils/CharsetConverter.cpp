@@ -21,7 +21,10 @@
 #include "CharsetConverter.h"
 
 #include <cerrno>
+#include <cstring>
 #include <algorithm>
+#include <map>
+#include <stdint.h>
 
 #include <iconv.h>
 #include <fribidi/fribidi.h>
@@ -97,6 +100,9 @@ enum SpecialCharset
   SubtitleCharset /* subtitles.charset */,
 };
 
+/* maximum number of unused iconv handles kept per conversion type */
+#define MAX_IDLE_CONVERTERS 8
+
 class CConverterType : public CCriticalSection
 {
 public:
@@ -107,7 +113,19 @@ public:
   CConverterType(const CConverterType& other);
   ~CConverterType();
 
-  iconv_t GetConverter(CSingleLock& converterLock);
+  /*!
+   * @brief Get an iconv handle for exclusive use by the calling thread.
+   *        An unused handle is reused if available, otherwise a new one is opened.
+   * @param generation Set to the generation the handle belongs to, must be passed to Release().
+   * @return The handle or NO_ICONV on error.
+   */
+  iconv_t Acquire(unsigned int& generation);
+
+  /*!
+   * @brief Give back a handle obtained by Acquire(). Handles opened before the last
+   *        Reset() or ReinitTo() are closed instead of being reused.
+   */
+  void Release(iconv_t converter, unsigned int generation);
 
   void Reset(void);
   void ReinitTo(const std::string& sourceCharset, const std::string& targetCharset, unsigned int targetSingleCharMaxLen = 1);
@@ -117,13 +135,15 @@ public:
 
 private:
   static std::string ResolveSpecialCharset(enum SpecialCharset charset);
-
-  enum SpecialCharset m_sourceSpecialCharset;
-  std::string         m_sourceCharset;
-  enum SpecialCharset m_targetSpecialCharset;
-  std::string         m_targetCharset;
-  iconv_t             m_iconv;
-  unsigned int        m_targetSingleCharMaxLen;
+  void CloseIdleConverters(void);
+
+  enum SpecialCharset  m_sourceSpecialCharset;
+  std::string          m_sourceCharset;
+  enum SpecialCharset  m_targetSpecialCharset;
+  std::string          m_targetCharset;
+  std::vector<iconv_t> m_idleConverters;
+  unsigned int         m_generation;
+  unsigned int         m_targetSingleCharMaxLen;
 };
 
 CConverterType::CConverterType(const std::string& sourceCharset, const std::string& targetCharset, unsigned int targetSingleCharMaxLen /*= 1*/) : CCriticalSection(),
@@ -131,7 +151,7 @@ CConverterType::CConverterType(const std::string& sourceCharset, const std::stri
   m_sourceCharset(sourceCharset),
   m_targetSpecialCharset(NotSpecialCharset),
   m_targetCharset(targetCharset),
-  m_iconv(NO_ICONV),
+  m_generation(0),
   m_targetSingleCharMaxLen(targetSingleCharMaxLen)
 {
 }
@@ -141,7 +161,7 @@ CConverterType::CConverterType(enum SpecialCharset sourceSpecialCharset, const s
   m_sourceCharset(),
   m_targetSpecialCharset(NotSpecialCharset),
   m_targetCharset(targetCharset),
-  m_iconv(NO_ICONV),
+  m_generation(0),
   m_targetSingleCharMaxLen(targetSingleCharMaxLen)
 {
 }
@@ -151,7 +171,7 @@ CConverterType::CConverterType(const std::string& sourceCharset, enum SpecialCha
   m_sourceCharset(sourceCharset),
   m_targetSpecialCharset(targetSpecialCharset),
   m_targetCharset(),
-  m_iconv(NO_ICONV),
+  m_generation(0),
   m_targetSingleCharMaxLen(targetSingleCharMaxLen)
 {
 }
@@ -161,7 +181,7 @@ CConverterType::CConverterType(enum SpecialCharset sourceSpecialCharset, enum Sp
   m_sourceCharset(),
   m_targetSpecialCharset(targetSpecialCharset),
   m_targetCharset(),
-  m_iconv(NO_ICONV),
+  m_generation(0),
   m_targetSingleCharMaxLen(targetSingleCharMaxLen)
 {
 }
@@ -171,7 +191,7 @@ CConverterType::CConverterType(const CConverterType& other) : CCriticalSection()
   m_sourceCharset(other.m_sourceCharset),
   m_targetSpecialCharset(other.m_targetSpecialCharset),
   m_targetCharset(other.m_targetCharset),
-  m_iconv(NO_ICONV),
+  m_generation(0),
   m_targetSingleCharMaxLen(other.m_targetSingleCharMaxLen)
 {
 }
@@ -179,42 +199,60 @@ CConverterType::CConverterType(const CConverterType& other) : CCriticalSection()
 CConverterType::~CConverterType()
 {
   CSingleLock lock(*this);
-  if (m_iconv != NO_ICONV)
-    iconv_close(m_iconv);
+  CloseIdleConverters();
   lock.Leave(); // ensure unlocking before final destruction
 }
 
-iconv_t CConverterType::GetConverter(CSingleLock& converterLock)
+iconv_t CConverterType::Acquire(unsigned int& generation)
 {
-  // ensure that this unique instance is locked externally
-  if (&converterLock.get_underlying() != this)
-    return NO_ICONV;
+  CSingleLock lock(*this);
+  generation = m_generation;
 
-  if (m_iconv == NO_ICONV)
+  if (!m_idleConverters.empty())
   {
-    if (m_sourceSpecialCharset)
-      m_sourceCharset = ResolveSpecialCharset(m_sourceSpecialCharset);
-    if (m_targetSpecialCharset)
-      m_targetCharset = ResolveSpecialCharset(m_targetSpecialCharset);
-
-    m_iconv = iconv_open(m_targetCharset.c_str(), m_sourceCharset.c_str());
-    
-    if (m_iconv == NO_ICONV)
-      CLog::Log(LOGERROR, "%s: iconv_open() for \"%s\" -> \"%s\" failed, errno = %d (%s)",
-                __FUNCTION__, m_sourceCharset.c_str(), m_targetCharset.c_str(), errno, strerror(errno));
+    iconv_t converter = m_idleConverters.back();
+    m_idleConverters.pop_back();
+    return converter;
   }
 
-  return m_iconv;
+  if (m_sourceSpecialCharset)
+    m_sourceCharset = ResolveSpecialCharset(m_sourceSpecialCharset);
+  if (m_targetSpecialCharset)
+    m_targetCharset = ResolveSpecialCharset(m_targetSpecialCharset);
+
+  iconv_t converter = iconv_open(m_targetCharset.c_str(), m_sourceCharset.c_str());
+
+  if (converter == NO_ICONV)
+    CLog::Log(LOGERROR, "%s: iconv_open() for \"%s\" -> \"%s\" failed, errno = %d (%s)",
+              __FUNCTION__, m_sourceCharset.c_str(), m_targetCharset.c_str(), errno, strerror(errno));
+
+  return converter;
+}
+
+void CConverterType::Release(iconv_t converter, unsigned int generation)
+{
+  if (converter == NO_ICONV)
+    return;
+
+  CSingleLock lock(*this);
+  if (generation == m_generation && m_idleConverters.size() < MAX_IDLE_CONVERTERS)
+    m_idleConverters.push_back(converter);
+  else
+    iconv_close(converter);
+}
+
+void CConverterType::CloseIdleConverters(void)
+{
+  for (std::vector<iconv_t>::iterator it = m_idleConverters.begin(); it != m_idleConverters.end(); ++it)
+    iconv_close(*it);
+  m_idleConverters.clear();
 }
 
 void CConverterType::Reset(void)
 {
   CSingleLock lock(*this);
-  if (m_iconv != NO_ICONV)
-  {
-    iconv_close(m_iconv);
-    m_iconv = NO_ICONV;
-  }
+  CloseIdleConverters();
+  m_generation++;
 
   if (m_sourceSpecialCharset)
     m_sourceCharset.clear();
@@ -228,11 +266,8 @@ void CConverterType::ReinitTo(const std::string& sourceCharset, const std::strin
   CSingleLock lock(*this);
   if (sourceCharset != m_sourceCharset || targetCharset != m_targetCharset)
   {
-    if (m_iconv != NO_ICONV)
-    {
-      iconv_close(m_iconv);
-      m_iconv = NO_ICONV;
-    }
+    CloseIdleConverters();
+    m_generation++;
 
     m_sourceSpecialCharset = NotSpecialCharset;
     m_sourceCharset = sourceCharset;
@@ -280,6 +315,42 @@ enum StdConversionType /* Keep it in sync with CCharsetConverter::CInnerConverte
   NumberOfStdConversionTypes /* Dummy sentinel entry */
 };
 
+/* Unicode encodings that are converted natively, without iconv and without locking */
+enum UnicodeEncoding
+{
+  NotUnicode = 0,
+  EncodingUtf8,
+  EncodingUtf16LE,
+  EncodingUtf16BE,
+  EncodingUtf32 /* host byte order */
+};
+
+#ifdef WORDS_BIGENDIAN
+  #define ENCODING_UTF16 EncodingUtf16BE
+#else
+  #define ENCODING_UTF16 EncodingUtf16LE
+#endif
+
+#if defined(WCHAR_IS_UCS_4)
+  #define ENCODING_WCHAR EncodingUtf32
+#elif defined(WCHAR_IS_UTF16)
+  #define ENCODING_WCHAR ENCODING_UTF16
+#else
+  #define ENCODING_WCHAR NotUnicode
+#endif
+
+#if defined(TARGET_DARWIN)
+  #define ENCODING_UTF8_SOURCE NotUnicode /* UTF-8-MAC needs normalization, leave it to iconv */
+#else
+  #define ENCODING_UTF8_SOURCE EncodingUtf8
+#endif
+
+struct SNativeConversion
+{
+  UnicodeEncoding source;
+  UnicodeEncoding target;
+};
+
 /* We don't want to pollute header file with many additional includes and definitions, so put 
    here all staff that require usage of types defined in this file or in additional headers */
 class CCharsetConverter::CInnerConverter
@@ -295,7 +366,13 @@ public:
   template<class INPUT,class OUTPUT>
   static bool convert(iconv_t type, int multiplier, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
 
+  template<class INPUT,class OUTPUT>
+  static bool unicodeConvert(UnicodeEncoding sourceEncoding, UnicodeEncoding targetEncoding, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
+
+  static CConverterType& getCustomConverter(const std::string& sourceCharset, const std::string& targetCharset);
+
   static CConverterType m_stdConversion[NumberOfStdConversionTypes];
+  static const SNativeConversion m_nativeConversion[NumberOfStdConversionTypes];
   static CCriticalSection m_critSectionFriBiDi;
 };
 
@@ -323,8 +400,197 @@ CConverterType CCharsetConverter::CInnerConverter::m_stdConversion[NumberOfStdCo
   /* Ucs2CharsetToUtf8 */   CConverterType("UCS-2LE",       "UTF-8", CCharsetConverter::m_Utf8CharMaxSize)
 };
 
+const SNativeConversion CCharsetConverter::CInnerConverter::m_nativeConversion[NumberOfStdConversionTypes] = /* keep it in sync with enum StdConversionType */
+{
+  /* Utf8ToUtf32 */         { ENCODING_UTF8_SOURCE, EncodingUtf32 },
+  /* Utf32ToUtf8 */         { EncodingUtf32,        EncodingUtf8 },
+  /* Utf32ToW */            { EncodingUtf32,        ENCODING_WCHAR },
+  /* WToUtf32 */            { ENCODING_WCHAR,       EncodingUtf32 },
+  /* SubtitleCharsetToUtf8*/{ NotUnicode,           NotUnicode },
+  /* Utf8ToUserCharset */   { NotUnicode,           NotUnicode },
+  /* UserCharsetToUtf8 */   { NotUnicode,           NotUnicode },
+  /* Utf32ToUserCharset */  { NotUnicode,           NotUnicode },
+  /* WtoUtf8 */             { ENCODING_WCHAR,       EncodingUtf8 },
+  /* Utf16LEtoW */          { EncodingUtf16LE,      ENCODING_WCHAR },
+  /* Utf16BEtoUtf8 */       { EncodingUtf16BE,      EncodingUtf8 },
+  /* Utf16LEtoUtf8 */       { EncodingUtf16LE,      EncodingUtf8 },
+  /* Utf8toW */             { ENCODING_UTF8_SOURCE, ENCODING_WCHAR },
+  /* Utf8ToSystem */        { NotUnicode,           NotUnicode },
+  /* SystemToUtf8 */        { NotUnicode,           NotUnicode },
+  /* Ucs2CharsetToUtf8 */   { NotUnicode,           NotUnicode }
+};
+
 CCriticalSection CCharsetConverter::CInnerConverter::m_critSectionFriBiDi;
 
+static inline size_t unicodeUnitSize(UnicodeEncoding encoding)
+{
+  switch (encoding)
+  {
+  case EncodingUtf8:
+    return 1;
+  case EncodingUtf16LE:
+  case EncodingUtf16BE:
+    return 2;
+  case EncodingUtf32:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+static inline bool unicodeNeedsSwap(UnicodeEncoding encoding)
+{
+  return (encoding == EncodingUtf16LE || encoding == EncodingUtf16BE) && encoding != ENCODING_UTF16;
+}
+
+static inline uint32_t swapUtf16Unit(uint32_t unit, bool swap)
+{
+  return swap ? (((unit & 0xFF) << 8) | ((unit >> 8) & 0xFF)) : unit;
+}
+
+/* Decode one code point starting at 'pos'. On an invalid sequence one code unit is skipped and false is returned. */
+template<class CHAR>
+static inline bool unicodeDecode(UnicodeEncoding encoding, const CHAR* src, size_t length, size_t& pos, uint32_t& codePoint)
+{
+  if (encoding == EncodingUtf8)
+  {
+    const unsigned char* str = (const unsigned char*)src;
+    const uint32_t lead = str[pos];
+    if (lead < 0x80)
+    {
+      codePoint = lead;
+      pos++;
+      return true;
+    }
+
+    size_t trailing;
+    uint32_t minSecond = 0x80, maxSecond = 0xBF;
+    if (lead < 0xC2)
+      trailing = 0; // continuation byte or overlong two-byte sequence
+    else if (lead < 0xE0)
+      trailing = 1;
+    else if (lead < 0xF0)
+    {
+      trailing = 2;
+      if (lead == 0xE0)
+        minSecond = 0xA0; // overlong
+      else if (lead == 0xED)
+        maxSecond = 0x9F; // surrogates
+    }
+    else if (lead < 0xF5)
+    {
+      trailing = 3;
+      if (lead == 0xF0)
+        minSecond = 0x90; // overlong
+      else if (lead == 0xF4)
+        maxSecond = 0x8F; // above U+10FFFF
+    }
+    else
+      trailing = 0;
+
+    if (trailing == 0 || pos + trailing >= length)
+    {
+      pos++;
+      return false;
+    }
+
+    if (str[pos + 1] < minSecond || str[pos + 1] > maxSecond)
+    {
+      pos++;
+      return false;
+    }
+
+    uint32_t value = lead & (0x3F >> trailing);
+    for (size_t i = 1; i <= trailing; i++)
+    {
+      const uint32_t next = str[pos + i];
+      if ((next & 0xC0) != 0x80)
+      {
+        pos++;
+        return false;
+      }
+      value = (value << 6) | (next & 0x3F);
+    }
+
+    codePoint = value;
+    pos += trailing + 1;
+    return true;
+  }
+  else if (encoding == EncodingUtf32)
+  {
+    const uint32_t value = (uint32_t)src[pos++];
+    if (value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF))
+      return false;
+
+    codePoint = value;
+    return true;
+  }
+  else
+  {
+    const bool swap = unicodeNeedsSwap(encoding);
+    const uint32_t unit = swapUtf16Unit((uint16_t)src[pos++], swap);
+    if (unit < 0xD800 || unit > 0xDFFF)
+    {
+      codePoint = unit;
+      return true;
+    }
+    if (unit > 0xDBFF || pos >= length)
+      return false;
+
+    const uint32_t low = swapUtf16Unit((uint16_t)src[pos], swap);
+    if (low < 0xDC00 || low > 0xDFFF)
+      return false;
+
+    codePoint = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    pos++;
+    return true;
+  }
+}
+
+template<class OUTPUT>
+static inline void unicodeEncode(UnicodeEncoding encoding, uint32_t codePoint, OUTPUT& strDest)
+{
+  typedef typename OUTPUT::value_type CHAR;
+
+  if (encoding == EncodingUtf8)
+  {
+    if (codePoint < 0x80)
+      strDest.push_back((CHAR)codePoint);
+    else if (codePoint < 0x800)
+    {
+      strDest.push_back((CHAR)(0xC0 | (codePoint >> 6)));
+      strDest.push_back((CHAR)(0x80 | (codePoint & 0x3F)));
+    }
+    else if (codePoint < 0x10000)
+    {
+      strDest.push_back((CHAR)(0xE0 | (codePoint >> 12)));
+      strDest.push_back((CHAR)(0x80 | ((codePoint >> 6) & 0x3F)));
+      strDest.push_back((CHAR)(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+      strDest.push_back((CHAR)(0xF0 | (codePoint >> 18)));
+      strDest.push_back((CHAR)(0x80 | ((codePoint >> 12) & 0x3F)));
+      strDest.push_back((CHAR)(0x80 | ((codePoint >> 6) & 0x3F)));
+      strDest.push_back((CHAR)(0x80 | (codePoint & 0x3F)));
+    }
+  }
+  else if (encoding == EncodingUtf32)
+    strDest.push_back((CHAR)codePoint);
+  else
+  {
+    const bool swap = unicodeNeedsSwap(encoding);
+    if (codePoint < 0x10000)
+      strDest.push_back((CHAR)swapUtf16Unit(codePoint, swap));
+    else
+    {
+      codePoint -= 0x10000;
+      strDest.push_back((CHAR)swapUtf16Unit(0xD800 | (codePoint >> 10), swap));
+      strDest.push_back((CHAR)swapUtf16Unit(0xDC00 | (codePoint & 0x3FF), swap));
+    }
+  }
+}
+
 template<class INPUT,class OUTPUT>
 bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar /*= false*/)
 {
@@ -335,10 +601,20 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   if (convertType < 0 || convertType >= NumberOfStdConversionTypes)
     return false;
 
+  const SNativeConversion& native = m_nativeConversion[convertType];
+  if (native.source != NotUnicode && native.target != NotUnicode &&
+      sizeof(typename INPUT::value_type) == unicodeUnitSize(native.source) &&
+      sizeof(typename OUTPUT::value_type) == unicodeUnitSize(native.target))
+    return unicodeConvert(native.source, native.target, strSource, strDest, failOnInvalidChar);
+
   CConverterType& convType = m_stdConversion[convertType];
-  CSingleLock converterLock(convType);
+  unsigned int generation;
+  iconv_t converter = convType.Acquire(generation);
+
+  const bool result = convert(converter, convType.GetTargetSingleCharMaxLen(), strSource, strDest, failOnInvalidChar);
+  convType.Release(converter, generation);
 
-  return convert(convType.GetConverter(converterLock), convType.GetTargetSingleCharMaxLen(), strSource, strDest, failOnInvalidChar);
+  return result;
 }
 
 template<class INPUT,class OUTPUT>
@@ -348,20 +624,35 @@ bool CCharsetConverter::CInnerConverter::customConvert(const std::string& source
   if (strSource.empty())
     return true;
 
-  iconv_t conv = iconv_open(targetCharset.c_str(), sourceCharset.c_str());
-  if (conv == NO_ICONV)
-  {
-    CLog::Log(LOGERROR, "%s: iconv_open() for \"%s\" -> \"%s\" failed, errno = %d (%s)",
-              __FUNCTION__, sourceCharset.c_str(), targetCharset.c_str(), errno, strerror(errno));
+  CConverterType& convType = getCustomConverter(sourceCharset, targetCharset);
+  unsigned int generation;
+  iconv_t converter = convType.Acquire(generation);
+  if (converter == NO_ICONV)
     return false;
-  }
-  const int dstMultp = (targetCharset.compare(0, 5, "UTF-8") == 0) ? CCharsetConverter::m_Utf8CharMaxSize : 1;
-  const bool result = convert(conv, dstMultp, strSource, strDest, failOnInvalidChar);
-  iconv_close(conv);
+
+  const bool result = convert(converter, convType.GetTargetSingleCharMaxLen(), strSource, strDest, failOnInvalidChar);
+  convType.Release(converter, generation);
 
   return result;
 }
 
+CConverterType& CCharsetConverter::CInnerConverter::getCustomConverter(const std::string& sourceCharset, const std::string& targetCharset)
+{
+  static CCriticalSection critSection;
+  static std::map<std::pair<std::string, std::string>, CConverterType> converters;
+
+  CSingleLock lock(critSection);
+  const std::pair<std::string, std::string> key(sourceCharset, targetCharset);
+  std::map<std::pair<std::string, std::string>, CConverterType>::iterator it = converters.find(key);
+  if (it == converters.end())
+  {
+    const unsigned int multiplier = (targetCharset.compare(0, 5, "UTF-8") == 0) ? CCharsetConverter::m_Utf8CharMaxSize : 1;
+    it = converters.insert(std::make_pair(key, CConverterType(sourceCharset, targetCharset, multiplier))).first;
+  }
+
+  return it->second;
+}
+
 /* iconv may declare inbuf to be char** rather than const char** depending on platform and version,
     so provide a wrapper that handles both */
 struct charPtrPtrAdapter
@@ -481,6 +772,47 @@ bool CCharsetConverter::CInnerConverter::convert(iconv_t type, int multiplier, c
   return true;
 }
 
+template<class INPUT,class OUTPUT>
+bool CCharsetConverter::CInnerConverter::unicodeConvert(UnicodeEncoding sourceEncoding, UnicodeEncoding targetEncoding, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar /*= false*/)
+{
+  const typename INPUT::value_type* src = strSource.c_str();
+  const size_t length = strSource.length();
+  size_t pos = 0;
+
+  strDest.reserve(length);
+
+  while (pos < length)
+  {
+    /* plain ASCII is the common case for UTF-8 input, check eight bytes at once */
+    if (sourceEncoding == EncodingUtf8 && !unicodeNeedsSwap(targetEncoding))
+    {
+      uint64_t block;
+      while (pos + sizeof(block) <= length)
+      {
+        memcpy(&block, src + pos, sizeof(block));
+        if (block & UINT64_C(0x8080808080808080))
+          break;
+        for (size_t i = 0; i < sizeof(block); i++)
+          strDest.push_back((typename OUTPUT::value_type)src[pos + i]);
+        pos += sizeof(block);
+      }
+      if (pos >= length)
+        break;
+    }
+
+    uint32_t codePoint;
+    if (unicodeDecode(sourceEncoding, src, length, pos, codePoint))
+      unicodeEncode(targetEncoding, codePoint, strDest);
+    else if (failOnInvalidChar)
+    {
+      strDest.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(const std::u32string& stringSrc, std::u32string& stringDst, FriBidiCharType base /*= FRIBIDI_TYPE_LTR*/, const bool failOnBadString /*= false*/)
 {
   stringDst.clear();
@@ -0,0 +1,61 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+/*!
+ * @brief Owning pointer to a value that is shared between copies until one
+ *        of them modifies it.
+ *
+ * Copying the pointer only copies a reference. GetMutable() creates the value
+ * if there is none and gives the caller its own copy first if the value is
+ * shared, so pointers returned by it must not be kept across copies of the
+ * owner.
+ */
+template<typename T>
+class CCopyOnWritePtr
+{
+public:
+  const T *Get() const { return m_value.get(); }
+
+  T *GetMutable()
+  {
+    if (!m_value)
+      m_value = std::make_shared<T>();
+    else if (m_value.use_count() > 1)
+      m_value = std::make_shared<T>(*m_value);
+    return m_value.get();
+  }
+
+  void Reset() { m_value.reset(); }
+
+  /*!
+   * @return The number of owners sharing the value, 0 if there is none.
+   */
+  long UseCount() const { return m_value.use_count(); }
+
+  explicit operator bool() const { return m_value != nullptr; }
+  const T *operator->() const { return m_value.get(); }
+  const T &operator*() const { return *m_value; }
+
+private:
+  std::shared_ptr<T> m_value;
+};
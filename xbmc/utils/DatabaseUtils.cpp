@@ -390,6 +390,7 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
   for (unsigned int index = 0; index < resultSet.records.size(); index++)
   {
     DatabaseResult result;
+    result.reserve(fields.size() + 1);
     result[FieldRow] = index + offset;
 
     unsigned int lookupIndex = 0;
@@ -416,7 +417,7 @@ bool DatabaseUtils::GetDatabaseResults(const MediaType &mediaType, const FieldLi
         }
       }
 
-      result.insert(value);
+      result.insert(std::move(value));
     }
 
     result[FieldMediaType] = mediaType;
@@ -19,15 +19,16 @@
  *
  */
 
-#include <map>
+#include <algorithm>
 #include <memory>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "media/MediaType.h"
-
-class CVariant;
+#include "utils/Variant.h"
 
 namespace dbiplus
 {
@@ -148,7 +149,95 @@ typedef enum {
   DatabaseQueryPartOrderBy,
 } DatabaseQueryPart;
 
-typedef std::map<Field, CVariant> DatabaseResult;
+/*!
+ \brief Values of a database result or sort item by field.
+
+ Offers the parts of the std::map interface used on results but keeps the
+ values in a single vector ordered by field. Results and sort items only carry
+ the handful of fields that were selected or are needed for sorting, so this
+ saves an allocation per field and keeps the lookups done while comparing items
+ within a few cache lines. Inserting invalidates iterators and references.
+ */
+class CFieldValueMap
+{
+public:
+  typedef std::pair<Field, CVariant> value_type;
+  typedef std::vector<value_type>::iterator iterator;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  iterator begin() { return m_values.begin(); }
+  const_iterator begin() const { return m_values.begin(); }
+  iterator end() { return m_values.end(); }
+  const_iterator end() const { return m_values.end(); }
+
+  size_t size() const { return m_values.size(); }
+  bool empty() const { return m_values.empty(); }
+  void clear() { m_values.clear(); }
+  /*! \brief Reserve slots for the given number of fields. */
+  void reserve(size_t count) { m_values.reserve(count); }
+
+  iterator find(Field field)
+  {
+    iterator it = LowerBound(field);
+    return it != m_values.end() && it->first == field ? it : m_values.end();
+  }
+  const_iterator find(Field field) const
+  {
+    return const_cast<CFieldValueMap*>(this)->find(field);
+  }
+  size_t count(Field field) const { return find(field) != end() ? 1 : 0; }
+
+  CVariant& at(Field field)
+  {
+    iterator it = find(field);
+    if (it == m_values.end())
+      throw std::out_of_range("CFieldValueMap::at");
+    return it->second;
+  }
+  const CVariant& at(Field field) const
+  {
+    return const_cast<CFieldValueMap*>(this)->at(field);
+  }
+
+  CVariant& operator[](Field field)
+  {
+    iterator it = LowerBound(field);
+    if (it == m_values.end() || it->first != field)
+      it = m_values.insert(it, value_type(field, CVariant()));
+    return it->second;
+  }
+
+  std::pair<iterator, bool> insert(value_type value)
+  {
+    iterator it = LowerBound(value.first);
+    if (it != m_values.end() && it->first == value.first)
+      return std::make_pair(it, false);
+    return std::make_pair(m_values.insert(it, std::move(value)), true);
+  }
+
+  size_t erase(Field field)
+  {
+    iterator it = find(field);
+    if (it == m_values.end())
+      return 0;
+    m_values.erase(it);
+    return 1;
+  }
+
+private:
+  iterator LowerBound(Field field)
+  {
+    // most items are filled in field order, check the end first
+    if (m_values.empty() || m_values.back().first < field)
+      return m_values.end();
+    return std::lower_bound(m_values.begin(), m_values.end(), field,
+                            [](const value_type &value, Field field) { return value.first < field; });
+  }
+
+  std::vector<value_type> m_values;
+};
+
+typedef CFieldValueMap DatabaseResult;
 typedef std::vector<DatabaseResult> DatabaseResults;
 
 class DatabaseUtils
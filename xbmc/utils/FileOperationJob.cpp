@@ -20,6 +20,9 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "FileOperationJob.h"
 #include "URL.h"
 #include "Util.h"
@@ -29,10 +32,16 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/FileDirectoryFactory.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+// files transferred at once from or to network locations
+#define MAX_PARALLEL_TRANSFERS 3
+
 using namespace XFILE;
 
 CFileOperationJob::CFileOperationJob()
@@ -42,6 +51,9 @@ CFileOperationJob::CFileOperationJob()
     m_avgSpeed(),
     m_currentOperation(),
     m_currentFile(),
+    m_totalTime(0.0),
+    m_doneTime(0.0),
+    m_transferred(0.0),
     m_displayProgress(false),
     m_heading(0),
     m_line(0)
@@ -57,6 +69,9 @@ CFileOperationJob::CFileOperationJob(FileAction action, CFileItemList & items,
     m_avgSpeed(),
     m_currentOperation(),
     m_currentFile(),
+    m_totalTime(0.0),
+    m_doneTime(0.0),
+    m_transferred(0.0),
     m_displayProgress(displayProgress),
     m_heading(heading),
     m_line(line)
@@ -88,19 +103,126 @@ bool CFileOperationJob::DoWork()
 
   bool success = DoProcess(m_action, m_items, m_strDestFile, ops, totalTime);
 
-  unsigned int size = ops.size();
+  m_totalTime = totalTime;
+  m_doneTime = 0.0;
+  m_transferred = 0.0;
+  m_timer.StartZero();
 
-  double opWeight = 100.0 / totalTime;
-  double current = 0.0;
-
-  for (unsigned int i = 0; i < size && success; i++)
-    success &= ops[i].ExecuteOperation(this, current, opWeight);
+  for (size_t i = 0; i < ops.size() && success; )
+  {
+    /* consecutive network transfers run in parallel, everything else in order
+     * as e.g. files can only be copied once their folder has been created.
+     * Modal progress dialogs can only be updated from this thread. */
+    size_t end = i;
+    while (!IsModal() && end < ops.size() && ops[end].IsParallelTransfer())
+      end++;
+
+    if (end - i > 1)
+    {
+      success = ExecuteParallel(ops, i, end);
+      i = end;
+    }
+    else
+      success = ops[i++].ExecuteOperation(this);
+  }
 
   MarkFinished();
 
   return success;
 }
 
+bool CFileOperationJob::ExecuteParallel(FileOperationList &fileOperations, size_t begin, size_t end)
+{
+  struct TransferState
+  {
+    CCriticalSection critSection;
+    CEvent done{true};
+    size_t next;
+    size_t end;
+    size_t active = 0;
+    bool success = true;
+  };
+
+  std::shared_ptr<TransferState> state(new TransferState);
+  state->next = begin;
+  state->end = end;
+
+  auto transfer = [this, &fileOperations, state]()
+  {
+    CSingleLock lock(state->critSection);
+    while (state->next < state->end)
+    {
+      CFileOperation &operation = fileOperations[state->next++];
+      state->active++;
+      lock.Leave();
+
+      bool success = operation.ExecuteOperation(this);
+
+      lock.Enter();
+      // don't start any further transfers after a failure or cancel
+      if (!success)
+      {
+        state->success = false;
+        state->next = state->end;
+      }
+      if (--state->active == 0 && state->next == state->end)
+        state->done.Set();
+    }
+  };
+
+  /* the calling thread takes part, workers that start after all transfers
+   * have been taken return right away and aren't waited for */
+  size_t workers = std::min<size_t>(end - begin, MAX_PARALLEL_TRANSFERS) - 1;
+  for (size_t i = 0; i < workers; i++)
+    CJobManager::GetInstance().Submit(transfer, CJob::PRIORITY_DEDICATED);
+  transfer();
+
+  {
+    CSingleLock lock(state->critSection);
+    if (state->active == 0)
+      return state->success;
+  }
+  state->done.Wait();
+
+  CSingleLock lock(state->critSection);
+  return state->success;
+}
+
+void CFileOperationJob::SetCurrentFile(const std::string &strFile, FileAction action)
+{
+  CSingleLock lock(m_critSection);
+  m_currentFile = strFile;
+  m_currentOperation = GetActionString(action);
+}
+
+bool CFileOperationJob::UpdateProgress(const std::string &strFile, double progress, bool transfer)
+{
+  CSingleLock lock(m_critSection);
+  m_doneTime += progress;
+
+  if (transfer)
+  {
+    // average over all transfers since the job started, not just this one
+    m_transferred += progress;
+    float elapsed = m_timer.GetElapsedSeconds();
+    if (elapsed > 0.0f)
+    {
+      double avgSpeed = m_transferred / elapsed;
+      if (avgSpeed > 1000000.0)
+        m_avgSpeed = StringUtils::Format("%.1f MB/s", avgSpeed / 1000000.0);
+      else
+        m_avgSpeed = StringUtils::Format("%.1f KB/s", avgSpeed / 1000.0);
+    }
+
+    SetText(StringUtils::Format("%s (%s)", strFile.c_str(), m_avgSpeed.c_str()));
+  }
+  else
+    SetText(strFile);
+
+  unsigned int current = m_totalTime > 0.0 ? (unsigned int)(m_doneTime * 100.0 / m_totalTime) : 0;
+  return !ShouldCancel(std::min(current, 100u), 100);
+}
+
 bool CFileOperationJob::DoProcessFile(FileAction action, const std::string& strFileA, const std::string& strFileB, FileOperationList &fileOperations, double &totalTime)
 {
   int64_t time = 1;
@@ -215,16 +337,10 @@ CFileOperationJob::CFileOperation::CFileOperation(FileAction action, const std::
   : m_action(action),
     m_strFileA(strFileA),
     m_strFileB(strFileB),
-    m_time(time)
+    m_time(time),
+    m_progress(0.0)
 { }
 
-struct DataHolder
-{
-  CFileOperationJob *base;
-  double current;
-  double opWeight;
-};
-
 std::string CFileOperationJob::GetActionString(FileAction action)
 {
   std::string result;
@@ -255,32 +371,33 @@ std::string CFileOperationJob::GetActionString(FileAction action)
   return result;
 }
 
-bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base, double &current, double opWeight)
+bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base)
 {
   bool bResult = true;
+  bool bCopied = false;
 
-  base->m_currentFile = CURL(m_strFileA).GetFileNameWithoutPath();
-  base->m_currentOperation = GetActionString(m_action);
+  std::string strFile = CURL(m_strFileA).GetFileNameWithoutPath();
+  base->SetCurrentFile(strFile, m_action);
 
-  if (base->ShouldCancel((unsigned int)current, 100))
+  m_progress = 0.0;
+  if (!base->UpdateProgress(strFile, 0.0, false))
     return false;
 
-  base->SetText(base->GetCurrentFile());
-
-  DataHolder data = {base, current, opWeight};
-
   switch (m_action)
   {
     case ActionCopy:
     case ActionReplace:
-      bResult = CFile::Copy(m_strFileA, m_strFileB, this, &data);
+      bResult = bCopied = CFile::Copy(m_strFileA, m_strFileB, this, base);
       break;
 
     case ActionMove:
       if (CanBeRenamed(m_strFileA, m_strFileB))
         bResult = CFile::Rename(m_strFileA, m_strFileB);
-      else if (CFile::Copy(m_strFileA, m_strFileB, this, &data))
+      else if (CFile::Copy(m_strFileA, m_strFileB, this, base))
+      {
+        bCopied = true;
         bResult = CFile::Delete(m_strFileA);
+      }
       else
         bResult = false;
       break;
@@ -303,11 +420,22 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
       break;
   }
 
-  current += (double)m_time * opWeight;
+  // account for what the copy callbacks haven't reported, only the bytes
+  // of a finished copy count towards the average speed
+  base->UpdateProgress(strFile, (double)m_time - m_progress, bCopied);
+  m_progress = (double)m_time;
 
   return bResult;
 }
 
+bool CFileOperationJob::CFileOperation::IsParallelTransfer() const
+{
+  if (m_action != ActionCopy && m_action != ActionReplace && m_action != ActionMove)
+    return false;
+
+  return !URIUtils::IsHD(m_strFileA) || !URIUtils::IsHD(m_strFileB);
+}
+
 inline bool CFileOperationJob::CanBeRenamed(const std::string &strFileA, const std::string &strFileB)
 {
 #ifndef TARGET_POSIX
@@ -322,20 +450,12 @@ inline bool CFileOperationJob::CanBeRenamed(const std::string &strFileA, const s
 
 bool CFileOperationJob::CFileOperation::OnFileCallback(void* pContext, int ipercent, float avgSpeed)
 {
-  DataHolder *data = (DataHolder *)pContext;
-  double current = data->current + ((double)ipercent * data->opWeight * (double)m_time)/ 100.0;
+  CFileOperationJob *base = (CFileOperationJob *)pContext;
+  double progress = ((double)ipercent * (double)m_time) / 100.0;
+  double delta = progress - m_progress;
+  m_progress = progress;
 
-  if (avgSpeed > 1000000.0f)
-    data->base->m_avgSpeed = StringUtils::Format("%.1f MB/s", avgSpeed / 1000000.0f);
-  else
-    data->base->m_avgSpeed = StringUtils::Format("%.1f KB/s", avgSpeed / 1000.0f);
-
-  std::string line;
-  line = StringUtils::Format("%s (%s)",
-                              data->base->GetCurrentFile().c_str(),
-                              data->base->GetAverageSpeed().c_str());
-  data->base->SetText(line);
-  return !data->base->ShouldCancel((unsigned)current, 100);
+  return base->UpdateProgress(CURL(m_strFileA).GetFileNameWithoutPath(), delta, true);
 }
 
 bool CFileOperationJob::operator==(const CJob* job) const
@@ -24,7 +24,9 @@
 
 #include "FileItem.h"
 #include "filesystem/File.h"
+#include "threads/CriticalSection.h"
 #include "utils/ProgressJob.h"
+#include "utils/Stopwatch.h"
 
 class CFileOperationJob : public CProgressJob
 {
@@ -70,12 +72,19 @@ private:
 
     virtual bool OnFileCallback(void* pContext, int ipercent, float avgSpeed);
 
-    bool ExecuteOperation(CFileOperationJob *base, double &current, double opWeight);
+    bool ExecuteOperation(CFileOperationJob *base);
+
+    /*! \brief Whether the operation transfers a file from or to a network location.
+     Those run in parallel with the neighbouring transfers, as a single transfer
+     rarely saturates a network share, while parallel local copies just make disks seek.
+     */
+    bool IsParallelTransfer() const;
 
   private:
     FileAction m_action;
     std::string m_strFileA, m_strFileB;
     int64_t m_time;
+    double m_progress; ///< part of m_time done, while the operation runs
   };
   friend class CFileOperation;
 
@@ -83,6 +92,14 @@ private:
   bool DoProcess(FileAction action, CFileItemList & items, const std::string& strDestFile, FileOperationList &fileOperations, double &totalTime);
   bool DoProcessFolder(FileAction action, const std::string& strPath, const std::string& strDestFile, FileOperationList &fileOperations, double &totalTime);
   bool DoProcessFile(FileAction action, const std::string& strFileA, const std::string& strFileB, FileOperationList &fileOperations, double &totalTime);
+  bool ExecuteParallel(FileOperationList &fileOperations, size_t begin, size_t end);
+
+  void SetCurrentFile(const std::string &strFile, FileAction action);
+  /*! \brief Add progress of an operation, in the units of its weight, and report it.
+   \param transfer whether the progress is copied bytes counting towards the average speed
+   \return false if the job has been cancelled
+   */
+  bool UpdateProgress(const std::string &strFile, double progress, bool transfer);
 
   static inline bool CanBeRenamed(const std::string &strFileA, const std::string &strFileB);
 
@@ -90,6 +107,12 @@ private:
   CFileItemList m_items;
   std::string m_strDestFile;
   std::string m_avgSpeed, m_currentOperation, m_currentFile;
+
+  CCriticalSection m_critSection; ///< progress of the operations running in parallel
+  double m_totalTime;             ///< weight of all operations
+  double m_doneTime;              ///< weight of finished operations and progress of running ones
+  double m_transferred;           ///< bytes copied by all operations
+  CStopWatch m_timer;
   bool m_displayProgress;
   int m_heading;
   int m_line;
@@ -0,0 +1,186 @@
+#pragma once
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+namespace INTERN
+{
+  inline size_t HashValue(const std::string &value)
+  {
+    return std::hash<std::string>()(value);
+  }
+
+  inline size_t HashValue(const std::vector<std::string> &value)
+  {
+    size_t hash = value.size();
+    for (const auto &entry : value)
+      hash ^= HashValue(entry) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+
+  inline size_t MemoryUsage(const std::string &value)
+  {
+    return sizeof(value) + value.capacity();
+  }
+
+  inline size_t MemoryUsage(const std::vector<std::string> &value)
+  {
+    size_t size = sizeof(value) + (value.capacity() - value.size()) * sizeof(std::string);
+    for (const auto &entry : value)
+      size += MemoryUsage(entry);
+    return size;
+  }
+}
+
+/*!
+ * @brief Pool of immutable, shared values. Equal values that are interned
+ *        through the same pool share one instance.
+ */
+template<typename T>
+class CInternPool
+{
+public:
+  typedef std::shared_ptr<const T> ValuePtr;
+
+  static CInternPool<T> &GetInstance()
+  {
+    static CInternPool<T> instance;
+    return instance;
+  }
+
+  /*!
+   * @brief Get the shared instance of a value, adding it to the pool if needed.
+   * @param value The value to intern.
+   * @return The shared instance.
+   */
+  ValuePtr Intern(const T &value)
+  {
+    // non-owning pointer, only used for the lookup
+    const ValuePtr key(ValuePtr(), &value);
+
+    CSingleLock lock(m_critSection);
+    auto it = m_values.find(key);
+    if (it != m_values.end())
+      return *it;
+
+    ValuePtr interned = std::make_shared<const T>(value);
+    m_values.insert(interned);
+    return interned;
+  }
+
+  /*!
+   * @brief Remove all values from the pool that are no longer referenced elsewhere.
+   */
+  void Cleanup()
+  {
+    CSingleLock lock(m_critSection);
+    for (auto it = m_values.begin(); it != m_values.end();)
+    {
+      if (it->use_count() == 1)
+        it = m_values.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  /*!
+   * @return The number of distinct values in the pool.
+   */
+  size_t Size() const
+  {
+    CSingleLock lock(m_critSection);
+    return m_values.size();
+  }
+
+  /*!
+   * @return The approximate amount of memory used by the pooled values, in bytes.
+   */
+  size_t GetMemoryUsage() const
+  {
+    CSingleLock lock(m_critSection);
+    size_t size = 0;
+    for (const auto &value : m_values)
+      size += INTERN::MemoryUsage(*value);
+    return size;
+  }
+
+private:
+  CInternPool() {}
+  CInternPool(const CInternPool&) = delete;
+  CInternPool &operator=(const CInternPool&) = delete;
+
+  struct Hash
+  {
+    size_t operator()(const ValuePtr &value) const { return INTERN::HashValue(*value); }
+  };
+
+  struct Equal
+  {
+    bool operator()(const ValuePtr &left, const ValuePtr &right) const { return *left == *right; }
+  };
+
+  CCriticalSection m_critSection;
+  std::unordered_set<ValuePtr, Hash, Equal> m_values;
+};
+
+/*!
+ * @brief Immutable value stored in the CInternPool of its type. Behaves like
+ *        a const T, copying it only copies a reference to the shared value.
+ */
+template<typename T>
+class CInterned
+{
+public:
+  CInterned() {}
+  CInterned(const T &value) { *this = value; }
+
+  CInterned &operator=(const T &value)
+  {
+    if (value == T())
+      m_value.reset();
+    else
+      m_value = CInternPool<T>::GetInstance().Intern(value);
+    return *this;
+  }
+
+  const T &Get() const
+  {
+    static const T empty;
+    return m_value ? *m_value : empty;
+  }
+
+  operator const T &() const { return Get(); }
+
+  bool empty() const { return !m_value; }
+
+  bool operator==(const CInterned &right) const { return m_value == right.m_value; }
+  bool operator!=(const CInterned &right) const { return m_value != right.m_value; }
+
+private:
+  typename CInternPool<T>::ValuePtr m_value;
+};
@@ -22,6 +22,7 @@
 #include <queue>
 #include <vector>
 #include <string>
+#include <type_traits>
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
@@ -218,7 +219,7 @@ class CJobManager
       return true;
     }
   private:
-    F m_f;
+    typename std::decay<F>::type m_f; // a copy, jobs may run after the caller's function is gone
   };
 
 public:
@@ -240,11 +241,16 @@ public:
 
   /*!
    \brief Add a function f to this job manager for asynchronously execution.
+   \return the id of the job, 0 if it wasn't added because the job manager is stopping.
    */
   template<typename F>
-  void Submit(F&& f, CJob::PRIORITY priority = CJob::PRIORITY_LOW)
+  unsigned int Submit(F&& f, CJob::PRIORITY priority = CJob::PRIORITY_LOW)
   {
-    AddJob(new CLambdaJob<F>(std::forward<F>(f)), nullptr, priority);
+    CJob *job = new CLambdaJob<F>(std::forward<F>(f));
+    unsigned int jobID = AddJob(job, nullptr, priority);
+    if (jobID == 0)
+      delete job;
+    return jobID;
   }
 
   /*!
@@ -81,7 +81,8 @@ bool CSaveFileStateJob::DoWork()
             CLog::Log(LOGDEBUG, "%s - Marking video item %s as watched", __FUNCTION__, redactPath.c_str());
 
             // consider this item as played
-            videodatabase.IncrementPlayCount(m_item);
+            CFileItem item(m_item);
+            CVideoDatabase::QueueWrite([item](CVideoDatabase &db) { db.IncrementPlayCount(item); });
             m_item.GetVideoInfoTag()->m_playCount++;
 
             // PVR: Set recording's play count on the backend (if supported)
@@ -100,14 +101,21 @@ bool CSaveFileStateJob::DoWork()
             }
           }
           else
-            videodatabase.UpdateLastPlayed(m_item);
+          {
+            CFileItem item(m_item);
+            CVideoDatabase::QueueWrite([item](CVideoDatabase &db) { db.UpdateLastPlayed(item); });
+          }
 
           if (!m_item.HasVideoInfoTag() || m_item.GetVideoInfoTag()->m_resumePoint.timeInSeconds != m_bookmark.timeInSeconds)
           {
-            if (m_bookmark.timeInSeconds <= 0.0f)
-              videodatabase.ClearBookMarksOfFile(progressTrackingFile, CBookmark::RESUME);
-            else
-              videodatabase.AddBookMarkToFile(progressTrackingFile, m_bookmark, CBookmark::RESUME);
+            CBookmark bookmark = m_bookmark;
+            CVideoDatabase::QueueWrite([progressTrackingFile, bookmark](CVideoDatabase &db)
+            {
+              if (bookmark.timeInSeconds <= 0.0f)
+                db.ClearBookMarksOfFile(progressTrackingFile, CBookmark::RESUME);
+              else
+                db.AddBookMarkToFile(progressTrackingFile, bookmark, CBookmark::RESUME);
+            });
             if (m_item.HasVideoInfoTag())
               m_item.GetVideoInfoTag()->m_resumePoint = m_bookmark;
 
@@ -135,7 +143,8 @@ bool CSaveFileStateJob::DoWork()
 
         if (m_videoSettings != CMediaSettings::GetInstance().GetDefaultVideoSettings())
         {
-          videodatabase.SetVideoSettings(progressTrackingFile, m_videoSettings);
+          CVideoSettings settings = m_videoSettings;
+          CVideoDatabase::QueueWrite([progressTrackingFile, settings](CVideoDatabase &db) { db.SetVideoSettings(progressTrackingFile, settings); });
         }
 
         if (m_item.HasVideoInfoTag() && m_item.GetVideoInfoTag()->HasStreamDetails())
@@ -145,11 +154,15 @@ bool CSaveFileStateJob::DoWork()
           // Check whether the item's db streamdetails need updating
           if (!videodatabase.GetStreamDetails(dbItem) || dbItem.GetVideoInfoTag()->m_streamDetails != m_item.GetVideoInfoTag()->m_streamDetails)
           {
-            videodatabase.SetStreamDetailsForFile(m_item.GetVideoInfoTag()->m_streamDetails, progressTrackingFile);
+            CStreamDetails details = m_item.GetVideoInfoTag()->m_streamDetails;
+            CVideoDatabase::QueueWrite([progressTrackingFile, details](CVideoDatabase &db) { db.SetStreamDetailsForFile(details, progressTrackingFile); });
             updateListing = true;
           }
         }
 
+        // the listing and the stack item below are read back from the database
+        CVideoDatabase::FlushWrites();
+
         // in order to properly update the the list, we need to update the stack item which is held in g_application.m_stackFileItemToUpdate
         if (m_item.HasProperty("stackFileItemToUpdate"))
         {
@@ -187,7 +200,9 @@ bool CSaveFileStateJob::DoWork()
           // consider this item as played
           CLog::Log(LOGDEBUG, "%s - Marking audio item %s as listened", __FUNCTION__, redactPath.c_str());
 
-          musicdatabase.IncrementPlayCount(m_item);
+          CFileItem item(m_item);
+          CMusicDatabase::QueueWrite([item](CMusicDatabase &db) { db.IncrementPlayCount(item); });
+          CMusicDatabase::FlushWrites();
           musicdatabase.Close();
 
           // UPnP announce resume point changes to clients
@@ -23,11 +23,17 @@
 #include "URL.h"
 #include "Util.h"
 #include "XBDateTime.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include <algorithm>
+#include <locale>
+#include <memory>
+#include <unordered_map>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &seperator = " / ")
 {
@@ -416,130 +422,309 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+namespace
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+/*! \brief Precomputed sort data of an item.
+
+ The label is stored as a collation key: every character is replaced by its
+ rank in the collation order of the system locale, with digits marked so that
+ numbers compare by value. Comparing keys gives the same order as
+ StringUtils::AlphaNumericCompare() on the labels, without any locale calls.
+ */
+struct SSortKey
+{
+  size_t index;               ///< position of the item in the list to sort
+  SortSpecial special;
+  int folder;                 ///< 1 for folders, 0 for files, -1 if unknown
+  std::vector<uint32_t> key;
+  std::wstring label;         ///< stored in FieldSort of the sorted items
+};
+
+// low bits of a key element, 0 for non digits or 1 + the value of a digit
+#define SORT_KEY_DIGIT_BITS 4
+
+inline bool IsDigitKey(uint32_t key)
+{
+  return (key & ((1 << SORT_KEY_DIGIT_BITS) - 1)) != 0;
+}
+
+inline int64_t DigitKeyValue(uint32_t key)
+{
+  return (key & ((1 << SORT_KEY_DIGIT_BITS) - 1)) - 1;
+}
+
+inline wchar_t FoldCase(wchar_t c)
+{
+  if (c >= L'A' && c <= L'Z')
+    c += L'a' - L'A';
+  return c;
+}
+
+/* Turns the labels into collation keys. The characters of all labels are
+ * ranked once, so the locale is only consulted per distinct character. */
+void BuildCollationKeys(std::vector<SSortKey> &keys)
+{
+  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+
+  std::unordered_map<wchar_t, uint32_t> ranks;
+  for (const auto &key : keys)
   {
-    result = false;
-    return true;
+    for (size_t i = 0; i < key.label.size() && key.label[i] != 0; i++)
+      ranks[FoldCase(key.label[i])] = 0;
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+  std::vector<wchar_t> chars;
+  chars.reserve(ranks.size());
+  for (const auto &i : ranks)
+    chars.push_back(i.first);
+  std::sort(chars.begin(), chars.end(), [&coll](wchar_t left, wchar_t right)
+  {
+    return coll.compare(&left, &left + 1, &right, &right + 1) < 0;
+  });
+
+  // characters that collate equally get the same rank
+  uint32_t rank = 0;
+  for (size_t i = 0; i < chars.size(); i++)
   {
-    result = true;
-    return true;
+    if (i > 0 && coll.compare(&chars[i - 1], &chars[i - 1] + 1, &chars[i], &chars[i] + 1) != 0)
+      rank++;
+    ranks[chars[i]] = rank;
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  for (auto &key : keys)
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    key.key.reserve(key.label.size());
+    for (size_t i = 0; i < key.label.size() && key.label[i] != 0; i++)
     {
-      result = true;
-      return true;
+      wchar_t c = key.label[i];
+      uint32_t digit = c >= L'0' && c <= L'9' ? 1 + (c - L'0') : 0;
+      key.key.push_back((ranks[FoldCase(c)] << SORT_KEY_DIGIT_BITS) | digit);
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+}
+
+// same result as StringUtils::AlphaNumericCompare() on the labels of the keys
+int CompareCollationKeys(const std::vector<uint32_t> &left, const std::vector<uint32_t> &right)
+{
+  size_t l = 0, r = 0;
+  while (l < left.size() && r < right.size())
   {
-    result = false;
-    return true;
+    if (IsDigitKey(left[l]) && IsDigitKey(right[r]))
+    {
+      // compare only up to 15 digits
+      int64_t lnum = 0;
+      size_t ld = l;
+      while (ld < left.size() && IsDigitKey(left[ld]) && ld < l + 15)
+        lnum = lnum * 10 + DigitKeyValue(left[ld++]);
+      int64_t rnum = 0;
+      size_t rd = r;
+      while (rd < right.size() && IsDigitKey(right[rd]) && rd < r + 15)
+        rnum = rnum * 10 + DigitKeyValue(right[rd++]);
+
+      if (lnum != rnum)
+        return lnum < rnum ? -1 : 1;
+      l = ld;
+      r = rd;
+      continue;
+    }
+
+    uint32_t lrank = left[l] >> SORT_KEY_DIGIT_BITS;
+    uint32_t rrank = right[r] >> SORT_KEY_DIGIT_BITS;
+    if (lrank != rrank)
+      return lrank < rrank ? -1 : 1;
+    l++;
+    r++;
   }
 
-  if (handleFolder)
+  if (r < right.size())
+    return -1;
+  if (l < left.size())
+    return 1;
+  return 0;
+}
+
+/*! \brief Orders keys like a stable sort of their items would.
+ Items on top or bottom come first or last, folders before files unless folders
+ are ignored, and equal items keep their order in the list.
+ */
+class CSortKeyLess
+{
+public:
+  CSortKeyLess(SortOrder sortOrder, SortAttribute attributes)
+    : m_descending(sortOrder == SortOrderDescending),
+      m_handleFolder(!(attributes & SortAttributeIgnoreFolders))
+  { }
+
+  bool operator()(const SSortKey &left, const SSortKey &right) const
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    if (left.special != right.special)
+      return left.special == SortSpecialOnTop || right.special == SortSpecialOnBottom;
+
+    // both have either sort on top or sort on bottom -> leave as-is
+    if (left.special == SortSpecialNone)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      if (m_handleFolder && left.folder >= 0 && right.folder >= 0 && left.folder != right.folder)
+        return left.folder > right.folder;
+
+      int result = CompareCollationKeys(left.key, right.key);
+      if (result != 0)
+        return m_descending ? result > 0 : result < 0;
     }
+
+    return left.index < right.index;
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+private:
+  bool m_descending;
+  bool m_handleFolder;
+};
 
-  return false;
-}
+// items from which sorting in parallel pays off
+#define SORT_PARALLEL_MIN_ITEMS 20000
+#define SORT_PARALLEL_PARTS     4
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+/* Sorts the keys, of which only the first count are needed in order. Large
+ * lists are sorted in parts on job workers and then merged. */
+void SortKeys(std::vector<SSortKey> &keys, size_t count, const CSortKeyLess &less)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  if (count < keys.size())
+  {
+    std::partial_sort(keys.begin(), keys.begin() + count, keys.end(), less);
+    keys.erase(keys.begin() + count, keys.end());
+    return;
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  if (keys.size() < SORT_PARALLEL_MIN_ITEMS)
+  {
+    // the index makes the order total, so this is as good as a stable sort
+    std::sort(keys.begin(), keys.end(), less);
+    return;
+  }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  struct SortState
+  {
+    CCriticalSection critSection;
+    CEvent done{true};
+    size_t next = 0;
+    size_t active = 0;
+  };
+
+  std::vector<size_t> bounds;
+  for (size_t part = 0; part <= SORT_PARALLEL_PARTS; part++)
+    bounds.push_back(keys.size() * part / SORT_PARALLEL_PARTS);
+
+  std::shared_ptr<SortState> state(new SortState);
+  auto sortParts = [state, &keys, &bounds, less]()
+  {
+    CSingleLock lock(state->critSection);
+    while (state->next < SORT_PARALLEL_PARTS)
+    {
+      size_t part = state->next++;
+      state->active++;
+      lock.Leave();
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+      std::sort(keys.begin() + bounds[part], keys.begin() + bounds[part + 1], less);
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+      lock.Enter();
+      if (--state->active == 0 && state->next == SORT_PARALLEL_PARTS)
+        state->done.Set();
+    }
+  };
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  /* the calling thread takes part, workers that start after all parts have
+   * been taken return right away and aren't waited for */
+  for (size_t i = 1; i < SORT_PARALLEL_PARTS; i++)
+    CJobManager::GetInstance().Submit(sortParts, CJob::PRIORITY_HIGH);
+  sortParts();
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  bool wait;
+  {
+    CSingleLock lock(state->critSection);
+    wait = state->active > 0;
+  }
+  if (wait)
+    state->done.Wait();
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  for (size_t width = 1; width < SORT_PARALLEL_PARTS; width *= 2)
+  {
+    for (size_t part = 0; part + width < SORT_PARALLEL_PARTS; part += 2 * width)
+    {
+      size_t end = std::min<size_t>(part + 2 * width, SORT_PARALLEL_PARTS);
+      std::inplace_merge(keys.begin() + bounds[part], keys.begin() + bounds[part + width], keys.begin() + bounds[end], less);
+    }
+  }
 }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
+inline SortItem& GetSortItem(SortItem &item) { return item; }
+inline SortItem& GetSortItem(SortItemPtr &item) { return *item; }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
+/* Sorts items with the labels from preparator and keeps the items within the
+ * limits. Only the kept items get their label stored under FieldSort. */
+template<typename Items>
+void SortAndLimit(SortUtils::SortPreparator preparator, const Fields &sortingFields, SortOrder sortOrder, SortAttribute attributes, Items &items, int limitEnd, int limitStart)
 {
-  return SorterDescending(*left, *right);
-}
+  size_t first = 0;
+  size_t last = items.size();
+  if (limitStart > 0 && (size_t)limitStart < items.size())
+  {
+    first = limitStart;
+    limitEnd -= limitStart;
+  }
+  if (limitEnd > 0 && (size_t)limitEnd < items.size() - first)
+    last = first + limitEnd;
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
+  if (preparator == NULL)
+  {
+    items.erase(items.begin() + last, items.end());
+    items.erase(items.begin(), items.begin() + first);
+    return;
+  }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersDescending(*left, *right);
+  std::vector<SSortKey> keys(items.size());
+  for (size_t i = 0; i < items.size(); i++)
+  {
+    SortItem &item = GetSortItem(items[i]);
+
+    // add all fields to the item that are required for sorting if they are currently missing
+    for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+    {
+      if (item.find(*field) == item.end())
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+    }
+
+    SSortKey &key = keys[i];
+    key.index = i;
+
+    // a label stored by an earlier sort is kept
+    SortItem::const_iterator it = item.find(FieldSort);
+    if (it != item.end())
+      key.label = it->second.asWideString();
+    else
+      g_charsetConverter.utf8ToW(preparator(attributes, item), key.label, false);
+
+    key.special = SortSpecialNone;
+    if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+      key.special = (SortSpecial)it->second.asInteger();
+
+    key.folder = -1;
+    if ((it = item.find(FieldFolder)) != item.end())
+      key.folder = it->second.asBoolean() ? 1 : 0;
+  }
+
+  BuildCollationKeys(keys);
+  SortKeys(keys, last, CSortKeyLess(sortOrder, attributes));
+
+  Items sorted;
+  sorted.reserve(last - first);
+  for (size_t i = first; i < last; i++)
+  {
+    SortItem &item = GetSortItem(items[keys[i].index]);
+    if (item.find(FieldSort) == item.end())
+      item.insert(std::pair<Field, CVariant>(FieldSort, CVariant(std::move(keys[i].label))));
+    sorted.push_back(std::move(items[keys[i].index]));
+  }
+  items.swap(sorted);
+}
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -691,80 +876,14 @@ std::map<SortBy, Fields> SortUtils::m_sortingFields = fillSortingFields();
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, DatabaseResults& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
-  if (sortBy != SortByNone)
-  {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
-  }
-
-  if (limitStart > 0 && (size_t)limitStart < items.size())
-  {
-    items.erase(items.begin(), items.begin() + limitStart);
-    limitEnd -= limitStart;
-  }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortAndLimit(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart);
 }
 
 void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, SortItems& items, int limitEnd /* = -1 */, int limitStart /* = 0 */)
 {
-  if (sortBy != SortByNone)
-  {
-    // get the matching SortPreparator
-    SortPreparator preparator = getPreparator(sortBy);
-    if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
-  }
-
-  if (limitStart > 0 && (size_t)limitStart < items.size())
-  {
-    items.erase(items.begin(), items.begin() + limitStart);
-    limitEnd -= limitStart;
-  }
-  if (limitEnd > 0 && (size_t)limitEnd < items.size())
-    items.erase(items.begin() + limitEnd, items.end());
+  SortPreparator preparator = sortBy != SortByNone ? getPreparator(sortBy) : NULL;
+  SortAndLimit(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, limitEnd, limitStart);
 }
 
 void SortUtils::Sort(const SortDescription &sortDescription, DatabaseResults& items)
@@ -807,22 +926,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
@@ -19,10 +19,15 @@
  */
 
 #include "settings/Settings.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Utf8Utils.h"
 #include "system.h"
 
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 static const uint16_t refutf16LE1[] = { 0xff54, 0xff45, 0xff53, 0xff54,
@@ -292,6 +297,79 @@ TEST_F(TestCharsetConverter, wToUTF8)
 //  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 //}
 
+TEST_F(TestCharsetConverter, utf8ToUtf32)
+{
+  std::u32string varstr32;
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32("test \xEF\xBD\x94\xF0\x9F\x90\xAD", varstr32));
+  EXPECT_TRUE(varstr32 == std::u32string(U"test \xFF54\x1F42D"));
+
+  /* invalid sequences are skipped or fail the conversion */
+  EXPECT_FALSE(g_charsetConverter.utf8ToUtf32("te\xFFst", varstr32, true));
+  EXPECT_TRUE(varstr32.empty());
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32("te\xFFst\xC0\xAF\xED\xA0\x80", varstr32, false));
+  EXPECT_TRUE(varstr32 == std::u32string(U"test"));
+}
+
+TEST_F(TestCharsetConverter, utf32ToUtf8)
+{
+  refstra1 = "test utf32ToUtf8 \xEF\xBD\x94\xF0\x9F\x90\xAD";
+  varstra1.clear();
+  EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(g_charsetConverter.utf8ToUtf32(refstra1), varstra1));
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
+class CharsetConverterRunner : public IRunnable
+{
+public:
+  CharsetConverterRunner(const std::string& source, const std::u32string& expected, int iterations) :
+    m_source(source), m_expected(expected), m_iterations(iterations), m_failed(0) {}
+
+  virtual void Run() override
+  {
+    std::u32string converted;
+    for (int i = 0; i < m_iterations; i++)
+    {
+      if (!g_charsetConverter.utf8ToUtf32(m_source, converted) || converted != m_expected)
+        m_failed++;
+    }
+  }
+
+  std::string m_source;
+  std::u32string m_expected;
+  int m_iterations;
+  int m_failed;
+};
+
+TEST_F(TestCharsetConverter, utf8ToUtf32_Threaded)
+{
+  const int threads = 4;
+  const int iterations = 100000;
+  std::vector<std::unique_ptr<CharsetConverterRunner> > runners;
+  std::vector<std::unique_ptr<CThread> > workers;
+
+  // the threads have to get what a single conversion gets
+  const std::string source = "The quick brown fox jumps over the lazy dog \xE2\x82\xAC";
+  std::u32string expected;
+  ASSERT_TRUE(g_charsetConverter.utf8ToUtf32(source, expected));
+  ASSERT_EQ(45U, expected.length());
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (int i = 0; i < threads; i++)
+  {
+    runners.emplace_back(new CharsetConverterRunner(source, expected, iterations));
+    workers.emplace_back(new CThread(runners.back().get(), "CharsetConverterRunner"));
+    workers.back()->Create();
+  }
+  for (auto& worker : workers)
+    worker->StopThread(true);
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  for (auto& runner : runners)
+    EXPECT_EQ(0, runner->m_failed);
+  RecordProperty("conversions", threads * iterations);
+  RecordProperty("elapsed_ms", elapsed);
+}
+
 TEST_F(TestCharsetConverter, utf8logicalToVisualBiDi)
 {
   refstra1 = "ｔｅｓｔ＿ｕｔｆ８ｌｏｇｉｃａｌＴｏＶｉｓｕａｌＢｉＤｉ";
@@ -0,0 +1,54 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/CopyOnWritePtr.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(TestCopyOnWritePtr, GetMutable)
+{
+  CCopyOnWritePtr<std::string> first;
+  EXPECT_FALSE(static_cast<bool>(first));
+  EXPECT_EQ(nullptr, first.Get());
+
+  *first.GetMutable() = "value";
+  EXPECT_TRUE(static_cast<bool>(first));
+  EXPECT_EQ(1, first.UseCount());
+
+  CCopyOnWritePtr<std::string> second(first);
+  EXPECT_EQ(first.Get(), second.Get());
+  EXPECT_EQ(2, first.UseCount());
+
+  second.GetMutable()->append(" changed");
+  EXPECT_NE(first.Get(), second.Get());
+  EXPECT_EQ("value", *first);
+  EXPECT_EQ("value changed", *second);
+  EXPECT_EQ(1, first.UseCount());
+
+  // the only owner modifies in place
+  const std::string *value = first.Get();
+  EXPECT_EQ(value, first.GetMutable());
+
+  first.Reset();
+  EXPECT_FALSE(static_cast<bool>(first));
+  EXPECT_EQ(0, first.UseCount());
+}
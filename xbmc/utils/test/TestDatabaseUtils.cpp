@@ -1361,6 +1361,34 @@ TEST(TestDatabaseUtils, BuildLimitClause)
   EXPECT_STREQ(" LIMIT 100", a.c_str());
 }
 
+TEST(TestDatabaseUtils, DatabaseResult)
+{
+  DatabaseResult result;
+  result[FieldTitle] = "title";
+  result[FieldId] = 1;
+  EXPECT_TRUE(result.insert(std::make_pair(FieldYear, CVariant(2000))).second);
+  EXPECT_FALSE(result.insert(std::make_pair(FieldId, CVariant(2))).second);
+  result[FieldRow] = 3;
+
+  EXPECT_EQ(4U, result.size());
+  EXPECT_EQ(1, result.at(FieldId).asInteger());
+  EXPECT_EQ(2000, result.at(FieldYear).asInteger());
+  EXPECT_STREQ("title", result.at(FieldTitle).asString().c_str());
+  EXPECT_TRUE(result.find(FieldArtist) == result.end());
+  EXPECT_THROW(result.at(FieldArtist), std::out_of_range);
+
+  // iterates in field order like a std::map
+  Field previous = FieldUnknown;
+  for (DatabaseResult::const_iterator it = result.begin(); it != result.end(); ++it)
+  {
+    EXPECT_LT(previous, it->first);
+    previous = it->first;
+  }
+
+  EXPECT_EQ(1U, result.erase(FieldId));
+  EXPECT_EQ(0U, result.count(FieldId));
+}
+
 // class DatabaseUtils
 // {
 // public:
@@ -0,0 +1,72 @@
+/*
+ *      Copyright (C) 2016 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/InternPool.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestInternPool, Intern)
+{
+  CInternPool<std::string> &pool = CInternPool<std::string>::GetInstance();
+
+  std::string first("TestInternPool");
+  std::string second("TestInternPool");
+  EXPECT_EQ(pool.Intern(first), pool.Intern(second));
+  EXPECT_NE(pool.Intern(first), pool.Intern("TestInternPool2"));
+}
+
+TEST(TestInternPool, Cleanup)
+{
+  CInternPool<std::string> &pool = CInternPool<std::string>::GetInstance();
+  pool.Cleanup();
+  size_t size = pool.Size();
+
+  {
+    CInterned<std::string> value("TestInternPoolCleanup");
+    EXPECT_EQ(size + 1, pool.Size());
+    pool.Cleanup();
+    EXPECT_EQ(size + 1, pool.Size());
+  }
+
+  pool.Cleanup();
+  EXPECT_EQ(size, pool.Size());
+}
+
+TEST(TestInternPool, Interned)
+{
+  CInterned<std::string> a("value");
+  CInterned<std::string> b(std::string("value"));
+  CInterned<std::string> empty;
+
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a != empty);
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ("value", a.Get());
+  EXPECT_EQ("", empty.Get());
+
+  b = "";
+  EXPECT_TRUE(b.empty());
+  EXPECT_TRUE(b == empty);
+
+  CInterned<std::vector<std::string> > genres(std::vector<std::string>{ "Drama", "Comedy" });
+  CInterned<std::vector<std::string> > genres2(std::vector<std::string>{ "Drama", "Comedy" });
+  EXPECT_TRUE(genres == genres2);
+  EXPECT_EQ(2u, genres.Get().size());
+}
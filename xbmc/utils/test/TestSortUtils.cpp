@@ -19,6 +19,7 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
@@ -115,6 +116,54 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", (*items.at(6))[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_Limits)
+{
+  DatabaseResults items;
+  for (int i = 100; i > 0; i--)
+  {
+    DatabaseResult item;
+    item[FieldLabel] = StringUtils::Format("Item %i", (i * 37) % 100 + 1);
+    items.push_back(item);
+  }
+
+  // numbers within the labels sort by value
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items, 30, 10);
+
+  ASSERT_EQ((size_t)20, items.size());
+  for (size_t i = 0; i < items.size(); i++)
+  {
+    std::string label = StringUtils::Format("Item %i", (int)i + 11);
+    EXPECT_STREQ(label.c_str(), items[i][FieldLabel].asString().c_str());
+    EXPECT_EQ(std::wstring(label.begin(), label.end()), items[i][FieldSort].asWideString());
+  }
+}
+
+TEST(TestSortUtils, Sort_Large)
+{
+  // large enough to be sorted in parallel
+  SortItems items;
+  for (int i = 0; i < 50000; i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = StringUtils::Format("Item %i", (i * 7919) % 25000);
+    (*item)[FieldId] = i;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  ASSERT_EQ((size_t)50000, items.size());
+  for (size_t i = 1; i < items.size(); i++)
+  {
+    int previous = atoi((*items[i - 1])[FieldLabel].asString().c_str() + 5);
+    int current = atoi((*items[i])[FieldLabel].asString().c_str() + 5);
+    ASSERT_GE(previous, current);
+    // equal labels keep their order
+    if (previous == current)
+      ASSERT_LT((*items[i - 1])[FieldId].asInteger(), (*items[i])[FieldId].asInteger());
+  }
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
@@ -25,6 +25,7 @@
 #include "VideoDatabase.h"
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,6 +35,7 @@
 #include "addons/AddonManager.h"
 #include "Application.h"
 #include "dbwrappers/dataset.h"
+#include "dbwrappers/DatabaseWriter.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "dialogs/GUIDialogOK.h"
@@ -80,6 +82,14 @@ using namespace VIDEO;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
 
+// details kept in separate tables, loaded for whole listings at once by GetDetailsForListing()
+#define VIDEODB_DETAILS_LISTING (VideoDbDetailsCast | VideoDbDetailsTag | VideoDbDetailsRating | VideoDbDetailsUniqueID | VideoDbDetailsStream)
+
+// ids per IN (...) clause when loading the details of a listing, 20k movies take 100 queries
+#define VIDEODB_LISTING_IDS_PER_QUERY 1000
+// the details of larger listings are streamed, they don't fit the query cache anyway
+#define VIDEODB_LISTING_CACHED_ITEMS 200
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void)
 {
@@ -95,6 +105,26 @@ bool CVideoDatabase::Open()
   return CDatabase::Open(g_advancedSettings.m_databaseVideo);
 }
 
+static CDatabaseWriter &GetWriter()
+{
+  static CDatabaseWriter writer([]() -> CDatabase*
+  {
+    std::unique_ptr<CVideoDatabase> db(new CVideoDatabase);
+    return db->Open() ? db.release() : NULL;
+  });
+  return writer;
+}
+
+void CVideoDatabase::QueueWrite(const std::function<void(CVideoDatabase&)> &write)
+{
+  GetWriter().Queue([write](CDatabase &db) { write(static_cast<CVideoDatabase&>(db)); });
+}
+
+bool CVideoDatabase::FlushWrites()
+{
+  return GetWriter().Flush();
+}
+
 void CVideoDatabase::CreateTables()
 {
   CLog::Log(LOGINFO, "create bookmark table");
@@ -347,6 +377,12 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  CreateSearchIndex("moviesearch", "movie", "idMovie", { PrepareSQL("c%02d", VIDEODB_ID_TITLE), PrepareSQL("c%02d", VIDEODB_ID_PLOT),
+                                                         PrepareSQL("c%02d", VIDEODB_ID_PLOTOUTLINE), PrepareSQL("c%02d", VIDEODB_ID_TAGLINE) });
+  CreateSearchIndex("tvshowsearch", "tvshow", "idShow", { PrepareSQL("c%02d", VIDEODB_ID_TV_TITLE) });
+  CreateSearchIndex("episodesearch", "episode", "idEpisode", { PrepareSQL("c%02d", VIDEODB_ID_EPISODE_TITLE), PrepareSQL("c%02d", VIDEODB_ID_EPISODE_PLOT) });
+  CreateSearchIndex("musicvideosearch", "musicvideo", "idMVideo", { PrepareSQL("c%02d", VIDEODB_ID_MUSICVIDEO_TITLE) });
+
   CreateViews();
 }
 
@@ -671,13 +707,14 @@ int CVideoDatabase::RunQuery(const std::string &sql)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
   int rows = -1;
-  if (m_pDS->query(sql))
+  bool cached = false;
+  if (CachedQuery(sql, m_pDS, &cached))
   {
     rows = m_pDS->num_rows();
     if (rows == 0)
       m_pDS->close();
   }
-  CLog::Log(LOGDEBUG, "%s took %d ms for %d items query: %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - time, rows, sql.c_str());
+  CLog::Log(LOGDEBUG, "%s took %d ms for %d items %squery: %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - time, rows, cached ? "cached " : "", sql.c_str());
   return rows;
 }
 
@@ -3602,6 +3639,50 @@ void CVideoDatabase::GetDetailsFromDB(const dbiplus::sql_record* const record, i
 DWORD movieTime = 0;
 DWORD castTime = 0;
 
+/* Adds the stream of a row of "SELECT * FROM streamdetails" to details.
+ * Returns false for unknown stream types.
+ */
+static bool AddStreamDetail(Dataset *pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      p->m_strStereoMode = pDS->fv(11).get_asString();
+      p->m_strLanguage = pDS->fv(12).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetStreamDetails(CFileItem& item)
 {
   // Note that this function (possibly) creates VideoInfoTags for items that don't have one yet!
@@ -3639,45 +3720,8 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 
     while (!pDS->eof())
     {
-      CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-      switch (e)
-      {
-      case CStreamDetail::VIDEO:
-        {
-          CStreamDetailVideo *p = new CStreamDetailVideo();
-          p->m_strCodec = pDS->fv(2).get_asString();
-          p->m_fAspect = pDS->fv(3).get_asFloat();
-          p->m_iWidth = pDS->fv(4).get_asInt();
-          p->m_iHeight = pDS->fv(5).get_asInt();
-          p->m_iDuration = pDS->fv(10).get_asInt();
-          p->m_strStereoMode = pDS->fv(11).get_asString();
-          p->m_strLanguage = pDS->fv(12).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::AUDIO:
-        {
-          CStreamDetailAudio *p = new CStreamDetailAudio();
-          p->m_strCodec = pDS->fv(6).get_asString();
-          if (pDS->fv(7).get_isNull())
-            p->m_iChannels = -1;
-          else
-            p->m_iChannels = pDS->fv(7).get_asInt();
-          p->m_strLanguage = pDS->fv(8).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      case CStreamDetail::SUBTITLE:
-        {
-          CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-          p->m_strLanguage = pDS->fv(9).get_asString();
-          details.AddStream(p);
-          retVal = true;
-          break;
-        }
-      }
+      if (AddStreamDetail(pDS.get(), details))
+        retVal = true;
 
       pDS->next();
     }
@@ -4146,6 +4190,181 @@ void CVideoDatabase::GetUniqueIDs(int media_id, const std::string &media_type, C
   }
 }
 
+typedef std::map<int, std::vector<CVideoInfoTag*> > TagsById;
+
+// splits the ids into comma separated lists for IN (...) clauses
+static std::vector<std::string> GetIdLists(const TagsById &tagsById)
+{
+  std::vector<std::string> lists;
+  std::string list;
+  size_t count = 0;
+  for (const auto &i : tagsById)
+  {
+    if (!list.empty())
+      list += ",";
+    list += StringUtils::Format("%i", i.first);
+    if (++count % VIDEODB_LISTING_IDS_PER_QUERY == 0)
+    {
+      lists.push_back(list);
+      list.clear();
+    }
+  }
+  if (!list.empty())
+    lists.push_back(list);
+  return lists;
+}
+
+void CVideoDatabase::GetDetailsForListing(const std::vector<CVideoInfoTag*> &tags, const std::string &mediaType, int getDetails)
+{
+  if (tags.empty() || !(getDetails & VIDEODB_DETAILS_LISTING))
+    return;
+
+  try
+  {
+    if (!m_pDB.get()) return;
+    if (!m_pDS2.get()) return;
+
+    TagsById byId, byFile, byShow;
+    for (const auto &tag : tags)
+    {
+      byId[tag->m_iDbId].push_back(tag);
+      if (tag->m_iFileId >= 0)
+        byFile[tag->m_iFileId].push_back(tag);
+      if (mediaType == MediaTypeEpisode)
+        byShow[tag->m_iIdShow].push_back(tag);
+    }
+
+    /* runs the query for every list of ids and passes each row to the tags of
+     * the id in its first column, rows keep the order of the query per tag */
+    const bool stream = tags.size() > VIDEODB_LISTING_CACHED_ITEMS;
+    auto query = [this, stream](const TagsById &tagsById, const char *sql, const std::string &type, const std::function<void(CVideoInfoTag&)> &read)
+    {
+      for (const auto &ids : GetIdLists(tagsById))
+      {
+        if (stream)
+          m_pDS2->stream(PrepareSQL(sql, ids.c_str(), type.c_str()));
+        else
+          CachedQuery(PrepareSQL(sql, ids.c_str(), type.c_str()), m_pDS2);
+        while (!m_pDS2->eof())
+        {
+          const auto it = tagsById.find(m_pDS2->fv(0).get_asInt());
+          if (it != tagsById.end())
+          {
+            for (const auto &tag : it->second)
+              read(*tag);
+          }
+          m_pDS2->next();
+        }
+        m_pDS2->close();
+      }
+    };
+
+    if ((getDetails & VideoDbDetailsCast) && mediaType != MediaTypeMusicVideo)
+    {
+      auto readCast = [this](CVideoInfoTag &tag)
+      {
+        std::string name = m_pDS2->fv(1).get_asString();
+        for (const auto &i : tag.m_cast)
+        {
+          if (i.strName == name)
+            return;
+        }
+
+        SActorInfo info;
+        info.strName = name;
+        info.strRole = m_pDS2->fv(2).get_asString();
+        info.order = m_pDS2->fv(3).get_asInt();
+        info.thumbUrl.ParseString(m_pDS2->fv(4).get_asString());
+        info.thumb = m_pDS2->fv(5).get_asString();
+        tag.m_cast.emplace_back(std::move(info));
+      };
+
+      const char *sql = "SELECT actor_link.media_id,"
+                        "  actor.name,"
+                        "  actor_link.role,"
+                        "  actor_link.cast_order,"
+                        "  actor.art_urls,"
+                        "  art.url "
+                        "FROM actor_link"
+                        "  JOIN actor ON"
+                        "    actor_link.actor_id=actor.actor_id"
+                        "  LEFT JOIN art ON"
+                        "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                        "WHERE actor_link.media_id IN (%s) AND actor_link.media_type='%s' "
+                        "ORDER BY actor_link.cast_order";
+      query(byId, sql, mediaType, readCast);
+      // episodes get the cast of their show after their own
+      if (mediaType == MediaTypeEpisode)
+        query(byShow, sql, MediaTypeTvShow, readCast);
+    }
+
+    if ((getDetails & VideoDbDetailsTag) && mediaType != MediaTypeEpisode)
+    {
+      query(byId, "SELECT tag_link.media_id, tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id "
+                  "WHERE tag_link.media_id IN (%s) AND tag_link.media_type = '%s' ORDER BY tag.tag_id", mediaType,
+            [this](CVideoInfoTag &tag)
+            {
+              tag.m_tags.emplace_back(m_pDS2->fv(1).get_asString());
+            });
+    }
+
+    if ((getDetails & VideoDbDetailsRating) && mediaType != MediaTypeMusicVideo)
+    {
+      query(byId, "SELECT media_id, rating_type, rating, votes FROM rating WHERE media_id IN (%s) AND media_type = '%s'", mediaType,
+            [this](CVideoInfoTag &tag)
+            {
+              tag.m_ratings[m_pDS2->fv(1).get_asString()] = CRating(m_pDS2->fv(2).get_asFloat(), m_pDS2->fv(3).get_asInt());
+            });
+    }
+
+    if ((getDetails & VideoDbDetailsUniqueID) && mediaType != MediaTypeMusicVideo)
+    {
+      query(byId, "SELECT media_id, type, value FROM uniqueid WHERE media_id IN (%s) AND media_type = '%s'", mediaType,
+            [this](CVideoInfoTag &tag)
+            {
+              tag.SetUniqueID(m_pDS2->fv(2).get_asString(), m_pDS2->fv(1).get_asString());
+            });
+    }
+
+    if ((getDetails & VideoDbDetailsStream) && mediaType != MediaTypeTvShow)
+    {
+      for (const auto &i : byFile)
+      {
+        for (const auto &tag : i.second)
+          tag->m_streamDetails.Reset();
+      }
+
+      query(byFile, "SELECT * FROM streamdetails WHERE idFile IN (%s)", "",
+            [this](CVideoInfoTag &tag)
+            {
+              AddStreamDetail(m_pDS2.get(), tag.m_streamDetails);
+            });
+
+      for (const auto &i : byFile)
+      {
+        for (const auto &tag : i.second)
+        {
+          tag->m_streamDetails.DetermineBestStreams();
+          if (tag->m_streamDetails.GetVideoDuration() > 0)
+            tag->m_duration = tag->m_streamDetails.GetVideoDuration();
+        }
+      }
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+
+  for (const auto &tag : tags)
+  {
+    // GetDetailsFor*() only parses the thumbs when it had other details to load
+    if (!(getDetails & ~VIDEODB_DETAILS_LISTING))
+      tag->m_strPictureURL.Parse();
+    tag->m_parsedDetails = getDetails;
+  }
+}
+
 bool CVideoDatabase::GetVideoSettings(const CFileItem &item, CVideoSettings &settings)
 {
   return GetVideoSettings(GetFileId(item), settings);
@@ -5158,7 +5377,7 @@ void CVideoDatabase::UpdateTables(int iVersion)
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 107;
+  return 108;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -5355,7 +5574,12 @@ void CVideoDatabase::SetPlayCount(const CFileItem &item, int count, const CDateT
       // Only provide the "playcount" value if it has actually changed
       if (item.GetVideoInfoTag()->m_playCount != count)
         data["playcount"] = count;
-      ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", CFileItemPtr(new CFileItem(item)), data);
+      // listeners read the play count back, so they are told once it's committed
+      CFileItemPtr announceItem(new CFileItem(item));
+      RunAfterCommit([announceItem, data]()
+      {
+        ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", announceItem, data);
+      });
     }
   }
   catch (...)
@@ -6661,13 +6885,15 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     // get data from returned rows
     items.Reserve(results.size());
+    std::vector<CVideoInfoTag*> tags;
+    tags.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails & ~VIDEODB_DETAILS_LISTING);
       if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
@@ -6681,9 +6907,13 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.m_playCount > 0);
         items.Add(pItem);
+        tags.push_back(pItem->GetVideoInfoTag());
       }
     }
 
+    // load the details kept in separate tables for all items at once
+    GetDetailsForListing(tags, MediaTypeMovie, getDetails);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -6768,6 +6998,8 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     // get data from returned rows
     items.Reserve(results.size());
+    std::vector<CVideoInfoTag*> tags;
+    tags.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
@@ -6775,7 +7007,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
       const dbiplus::sql_record* const record = data.at(targetRow);
       
       CFileItemPtr pItem(new CFileItem());
-      CVideoInfoTag movie = GetDetailsForTvShow(record, getDetails, pItem.get());
+      CVideoInfoTag movie = GetDetailsForTvShow(record, getDetails & ~VIDEODB_DETAILS_LISTING, pItem.get());
       if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
            g_passwordManager.bMasterUser                                     ||
            g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
@@ -6789,9 +7021,13 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, (pItem->GetVideoInfoTag()->m_playCount > 0) && (pItem->GetVideoInfoTag()->m_iEpisode > 0));
         items.Add(pItem);
+        tags.push_back(pItem->GetVideoInfoTag());
       }
     }
 
+    // load the details kept in separate tables for all items at once
+    GetDetailsForListing(tags, MediaTypeTvShow, getDetails);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -6896,13 +7132,15 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
 
+    std::vector<CVideoInfoTag*> tags;
+    tags.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
+      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails & ~VIDEODB_DETAILS_LISTING);
       if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
@@ -6924,9 +7162,13 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, movie.m_playCount > 0);
         pItem->m_dateTime = movie.m_firstAired;
         items.Add(pItem);
+        tags.push_back(pItem->GetVideoInfoTag());
       }
     }
 
+    // load the details kept in separate tables for all items at once
+    GetDetailsForListing(tags, MediaTypeEpisode, getDetails);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -7736,13 +7978,15 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     // get data from returned rows
     items.Reserve(results.size());
     // get songs from returned subtable
+    std::vector<CVideoInfoTag*> tags;
+    tags.reserve(results.size());
     const query_data &data = m_pDS->get_result_set().records;
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
       
-      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(record, getDetails);
+      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(record, getDetails & ~VIDEODB_DETAILS_LISTING);
       if (!checkLocks || CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE || g_passwordManager.bMasterUser ||
           g_passwordManager.IsDatabasePathUnlocked(musicvideo.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
       {
@@ -7755,9 +7999,13 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
         item->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, musicvideo.m_playCount > 0);
         items.Add(item);
+        tags.push_back(item->GetVideoInfoTag());
       }
     }
 
+    // load the details kept in separate tables for all items at once
+    GetDetailsForListing(tags, MediaTypeMusicVideo, getDetails);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -7896,9 +8144,11 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE);
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where ",VIDEODB_ID_TITLE);
+    strSQL += GetSearchWhere("moviesearch", "movie.idMovie", PrepareSQL("c%02d", VIDEODB_ID_TITLE), strSearch, false,
+                             PrepareSQL("movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7941,9 +8191,11 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE);
+    strSQL += GetSearchWhere("tvshowsearch", "tvshow.idShow", PrepareSQL("c%02d", VIDEODB_ID_TV_TITLE), strSearch, false,
+                             PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7982,9 +8234,11 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
+    strSQL += GetSearchWhere("episodesearch", "episode.idEpisode", PrepareSQL("c%02d", VIDEODB_ID_EPISODE_TITLE), strSearch, false,
+                             PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8025,9 +8279,11 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE);
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE);
+    strSQL += GetSearchWhere("musicvideosearch", "musicvideo.idMVideo", PrepareSQL("c%02d", VIDEODB_ID_MUSICVIDEO_TITLE), strSearch, false,
+                             PrepareSQL("musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8072,9 +8328,11 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE);
+    strSQL += GetSearchWhere("episodesearch", "episode.idEpisode", PrepareSQL("c%02d", VIDEODB_ID_EPISODE_PLOT), strSearch, false,
+                             PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_PLOT, strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8111,9 +8369,11 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE);
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE ", VIDEODB_ID_TITLE);
+    strSQL += GetSearchWhere("moviesearch", "movie.idMovie", PrepareSQL("c%02d c%02d c%02d", VIDEODB_ID_PLOT, VIDEODB_ID_PLOTOUTLINE, VIDEODB_ID_TAGLINE), strSearch, false,
+                             PrepareSQL("(movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str()));
 
     m_pDS->query( strSQL );
 
@@ -9501,7 +9761,11 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
+  {
+    if (InTransaction()) // only a savepoint of an outer transaction
+      return true;
+
+    // number of items in the db has likely changed, so recalculate
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
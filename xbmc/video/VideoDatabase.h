@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <set>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -427,6 +428,18 @@ public:
   virtual bool Open();
   virtual bool CommitTransaction();
 
+  /*! \brief Queue a write to the video database, it runs on the shared writer connection.
+   Writes queued close together are committed in one transaction.
+   \sa FlushWrites, CDatabaseWriter
+   */
+  static void QueueWrite(const std::function<void(CVideoDatabase&)> &write);
+
+  /*! \brief Wait until all queued writes to the video database are committed.
+   \return false if they weren't committed in time.
+   \sa QueueWrite
+   */
+  static bool FlushWrites();
+
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
 
@@ -917,6 +930,13 @@ protected:
   void GetTags(int media_id, const std::string &media_type, std::vector<std::string> &tags);
   void GetRatings(int media_id, const std::string &media_type, RatingMap &ratings);
   void GetUniqueIDs(int media_id, const std::string &media_type, CVideoInfoTag& details);
+  /*! \brief Load cast, tags, ratings, unique ids and stream details for a whole listing
+   with one query per table, instead of one per item as GetDetailsFor*() do.
+   \param tags items of the listing, read by GetDetailsFor*() without these details
+   \param mediaType media type of all the items
+   \param getDetails details requested for the listing
+   */
+  void GetDetailsForListing(const std::vector<CVideoInfoTag*> &tags, const std::string &mediaType, int getDetails);
 
   void GetDetailsFromDB(std::unique_ptr<dbiplus::Dataset> &pDS, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
   void GetDetailsFromDB(const dbiplus::sql_record* const record, int min, int max, const SDbTableOffsets *offsets, CVideoInfoTag &details, int idxOffset = 2);
@@ -124,6 +124,9 @@ namespace VIDEO
       m_currentItem = 0;
       m_itemCount = -1;
 
+      // hashes may only use file info listed during this scan
+      g_directoryCache.ClearFileInfo();
+
       // Database operations should not be canceled
       // using Interupt() while scanning as it could
       // result in unexpected behaviour.
@@ -1836,7 +1839,7 @@ namespace VIDEO
       md5state.append(StringUtils::Join(excludes, "|"));
 
     struct __stat64 buffer;
-    if (XFILE::CFile::Stat(directory, &buffer) == 0)
+    if (XFILE::CFile::Stat(directory, &buffer, true) == 0)
     {
       int64_t time = buffer.st_mtime;
       if (!time)
@@ -1867,10 +1870,9 @@ namespace VIDEO
     {
       int64_t stat_time = 0;
       struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+      // filesystems returning the mtime inline are answered from the listing above
+      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer, true) == 0)
       {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
         stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
         time += stat_time;
       }
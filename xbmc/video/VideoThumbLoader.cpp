@@ -273,15 +273,16 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
 
 bool CVideoThumbLoader::LoadItemCached(CFileItem* pItem)
 {
+  const CFileItem &constItem = *pItem; // read the info tags without copying shared ones
   if (pItem->m_bIsShareOrDrive
   ||  pItem->IsParentFolder())
     return false;
 
   m_videoDatabase->Open();
 
-  if (!pItem->HasVideoInfoTag() || !pItem->GetVideoInfoTag()->HasStreamDetails()) // no stream details
+  if (!pItem->HasVideoInfoTag() || !constItem.GetVideoInfoTag()->HasStreamDetails()) // no stream details
   {
-    if ((pItem->HasVideoInfoTag() && pItem->GetVideoInfoTag()->m_iFileId >= 0) // file (or maybe folder) is in the database
+    if ((pItem->HasVideoInfoTag() && constItem.GetVideoInfoTag()->m_iFileId >= 0) // file (or maybe folder) is in the database
     || (!pItem->m_bIsFolder && pItem->IsVideo())) // Some other video file for which we haven't yet got any database details
     {
       if (m_videoDatabase->GetStreamDetails(*pItem))
@@ -294,11 +295,11 @@ bool CVideoThumbLoader::LoadItemCached(CFileItem* pItem)
   {
     FillLibraryArt(*pItem);
 
-    if (!pItem->GetVideoInfoTag()->m_type.empty()                &&
-         pItem->GetVideoInfoTag()->m_type != MediaTypeMovie      &&
-         pItem->GetVideoInfoTag()->m_type != MediaTypeTvShow     &&
-         pItem->GetVideoInfoTag()->m_type != MediaTypeEpisode    &&
-         pItem->GetVideoInfoTag()->m_type != MediaTypeMusicVideo)
+    if (!constItem.GetVideoInfoTag()->m_type.empty()             &&
+         constItem.GetVideoInfoTag()->m_type != MediaTypeMovie   &&
+         constItem.GetVideoInfoTag()->m_type != MediaTypeTvShow  &&
+         constItem.GetVideoInfoTag()->m_type != MediaTypeEpisode &&
+         constItem.GetVideoInfoTag()->m_type != MediaTypeMusicVideo)
     {
       m_videoDatabase->Close();
       return true; // nothing else to be done
@@ -309,7 +310,7 @@ bool CVideoThumbLoader::LoadItemCached(CFileItem* pItem)
   std::map<std::string, std::string> artwork = pItem->GetArt();
   if (artwork.empty())
   {
-    std::vector<std::string> artTypes = GetArtTypes(pItem->HasVideoInfoTag() ? pItem->GetVideoInfoTag()->m_type : "");
+    std::vector<std::string> artTypes = GetArtTypes(pItem->HasVideoInfoTag() ? constItem.GetVideoInfoTag()->m_type : "");
     if (find(artTypes.begin(), artTypes.end(), "thumb") == artTypes.end())
       artTypes.push_back("thumb"); // always look for "thumb" art for files
     for (std::vector<std::string>::const_iterator i = artTypes.begin(); i != artTypes.end(); ++i)
@@ -329,15 +330,16 @@ bool CVideoThumbLoader::LoadItemCached(CFileItem* pItem)
 
 bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
 {
+  const CFileItem &constItem = *pItem; // read the info tags without copying shared ones
   if (pItem->m_bIsShareOrDrive || pItem->IsParentFolder() || pItem->GetPath() == "add")
     return false;
 
   if (pItem->HasVideoInfoTag()                                &&
-     !pItem->GetVideoInfoTag()->m_type.empty()                &&
-      pItem->GetVideoInfoTag()->m_type != MediaTypeMovie      &&
-      pItem->GetVideoInfoTag()->m_type != MediaTypeTvShow     &&
-      pItem->GetVideoInfoTag()->m_type != MediaTypeEpisode    &&
-      pItem->GetVideoInfoTag()->m_type != MediaTypeMusicVideo)
+     !constItem.GetVideoInfoTag()->m_type.empty()             &&
+      constItem.GetVideoInfoTag()->m_type != MediaTypeMovie   &&
+      constItem.GetVideoInfoTag()->m_type != MediaTypeTvShow  &&
+      constItem.GetVideoInfoTag()->m_type != MediaTypeEpisode &&
+      constItem.GetVideoInfoTag()->m_type != MediaTypeMusicVideo)
     return false; // Nothing to do here
 
   DetectAndAddMissingItemData(*pItem);
@@ -345,7 +347,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
   m_videoDatabase->Open();
 
   std::map<std::string, std::string> artwork = pItem->GetArt();
-  std::vector<std::string> artTypes = GetArtTypes(pItem->HasVideoInfoTag() ? pItem->GetVideoInfoTag()->m_type : "");
+  std::vector<std::string> artTypes = GetArtTypes(pItem->HasVideoInfoTag() ? constItem.GetVideoInfoTag()->m_type : "");
   if (find(artTypes.begin(), artTypes.end(), "thumb") == artTypes.end())
     artTypes.push_back("thumb"); // always look for "thumb" art for files
   for (std::vector<std::string>::const_iterator i = artTypes.begin(); i != artTypes.end(); ++i)
@@ -386,7 +388,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
         if (pItem->HasVideoInfoTag())
         {
           // Item has cached autogen image but no art entry. Save it to db.
-          CVideoInfoTag* info = pItem->GetVideoInfoTag();
+          const CVideoInfoTag* info = constItem.GetVideoInfoTag();
           if (info->m_iDbId > 0 && !info->m_type.empty())
             m_videoDatabase->SetArtForItem(info->m_iDbId, info->m_type, "thumb", thumbURL);
         }
@@ -410,7 +412,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
     // flag extraction
     if (CSettings::GetInstance().GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTFLAGS) &&
        (!pItem->HasVideoInfoTag()                     ||
-        !pItem->GetVideoInfoTag()->HasStreamDetails() ) )
+        !constItem.GetVideoInfoTag()->HasStreamDetails() ) )
     {
       CFileItem item(*pItem);
       std::string path(item.GetPath());
@@ -439,7 +441,11 @@ void CVideoThumbLoader::SetArt(CFileItem &item, const std::map<std::string, std:
 
 bool CVideoThumbLoader::FillLibraryArt(CFileItem &item)
 {
-  CVideoInfoTag &tag = *item.GetVideoInfoTag();
+  const CFileItem &constItem = item; // read the info tag without copying a shared one
+  if (!constItem.HasVideoInfoTag())
+    return item.HasArt();
+
+  const CVideoInfoTag &tag = *constItem.GetVideoInfoTag();
   if (tag.m_iDbId > -1 && !tag.m_type.empty())
   {
     std::map<std::string, std::string> artwork;
@@ -499,7 +505,7 @@ bool CVideoThumbLoader::FillLibraryArt(CFileItem &item)
     }
     m_videoDatabase->Close();
   }
-  return !item.GetArt().empty();
+  return item.HasArt();
 }
 
 bool CVideoThumbLoader::FillThumb(CFileItem &item)
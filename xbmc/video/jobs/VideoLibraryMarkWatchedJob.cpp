@@ -80,26 +80,30 @@ bool CVideoLibraryMarkWatchedJob::Work(CVideoDatabase &db)
   if (markItems.empty())
     return true;
 
-  db.BeginTransaction();
-
-  for (std::vector<CFileItemPtr>::const_iterator iter = markItems.begin(); iter != markItems.end(); ++iter)
+  // the writes are batched with other library writes into one transaction
+  bool mark = m_mark;
+  CVideoDatabase::QueueWrite([markItems, mark](CVideoDatabase &writer)
   {
-    CFileItemPtr item = *iter;
-    if (m_mark)
+    for (std::vector<CFileItemPtr>::const_iterator iter = markItems.begin(); iter != markItems.end(); ++iter)
     {
-      std::string path(item->GetPath());
-      if (item->HasVideoInfoTag())
-        path = item->GetVideoInfoTag()->GetPath();
-
-      db.ClearBookMarksOfFile(path, CBookmark::RESUME);
-      db.IncrementPlayCount(*item);
+      CFileItemPtr item = *iter;
+      if (mark)
+      {
+        std::string path(item->GetPath());
+        if (item->HasVideoInfoTag())
+          path = item->GetVideoInfoTag()->GetPath();
+
+        writer.ClearBookMarksOfFile(path, CBookmark::RESUME);
+        writer.IncrementPlayCount(*item);
+      }
+      else
+        writer.SetPlayCount(*item, 0);
     }
-    else
-      db.SetPlayCount(*item, 0);
-  }
-
-  db.CommitTransaction();
+  });
   db.Close();
 
+  // the listings are refreshed once the job is done
+  CVideoDatabase::FlushWrites();
+
   return true;
 }
@@ -190,6 +190,7 @@ void CGUIWindowSystemInfo::FrameMove()
     SetControlLabel(i++, "%s: %s", 19163, PVR_BACKEND_RECORDINGS);
     SetControlLabel(i++, "%s: %s", 19168, PVR_BACKEND_DELETED_RECORDINGS);  // Deleted and recoverable recordings
     SetControlLabel(i++, "%s: %s", 19025, PVR_BACKEND_TIMERS);
+    SetControlLabel(i++, "%s: %s", 19297, PVR_EPG_MEMORY);
   }
 
   else if (m_section == CONTROL_BT_POLICY)